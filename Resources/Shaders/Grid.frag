@@ -0,0 +1,20 @@
+#version 440
+
+layout(location = 0) in vec2 i_WorldPosition;
+
+layout(location = 0) out vec4 o_Color;
+
+layout(location = 2) uniform vec2 u_Origin;
+layout(location = 3) uniform float u_Spacing;
+layout(location = 4) uniform vec4 u_Color;
+
+void main()
+{
+    vec2 GridCoordinates = (i_WorldPosition - u_Origin) / u_Spacing;
+
+    // NOTE: distance to the closest line in pixels, lines are one pixel wide and fade out over the pixel next to them
+    vec2 Distance = abs(fract(GridCoordinates - 0.5) - 0.5) / fwidth(GridCoordinates);
+    float Coverage = 1.0 - min(min(Distance.x, Distance.y), 1.0);
+
+    o_Color = vec4(u_Color.rgb, u_Color.a * Coverage);
+}
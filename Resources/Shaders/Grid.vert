@@ -0,0 +1,15 @@
+#version 440
+
+layout(location = 0) in vec2 i_Position;
+
+layout(location = 0) out vec2 o_WorldPosition;
+
+layout(location = 1) uniform mat4 u_ScreenToWorldMatrix;
+
+void main()
+{
+    // NOTE: the quad covers the whole screen, so its corners are mapped back into the world to find what they show
+    o_WorldPosition = (u_ScreenToWorldMatrix * vec4(i_Position, 0.0, 1.0)).xy;
+
+    gl_Position = vec4(i_Position, 0.0, 1.0);
+}
@@ -0,0 +1,23 @@
+#version 440
+
+layout(location = 0) in vec2 i_Position;
+layout(location = 1) in vec2 i_InactivePosition;
+
+layout(location = 0) out vec3 o_Color;
+
+layout(location = 1) uniform mat4 u_ViewMatrix;
+layout(location = 2) uniform vec3 u_StateColors[4];
+
+// NOTE: one texel per segment, the lower two bits are the index of its colour and the third bit is set if the segment
+//       is a part of the active path
+layout(binding = 1) uniform usamplerBuffer u_SegmentStates;
+
+void main()
+{
+    uint State = texelFetch(u_SegmentStates, gl_VertexID / 2).r;
+
+    o_Color = u_StateColors[State & 3u];
+
+    vec2 Position = (State & 4u) != 0u ? i_Position : i_InactivePosition;
+    gl_Position = u_ViewMatrix * vec4(Position, 0.0, 1.0);
+}
@@ -0,0 +1,24 @@
+#version 440 core
+
+layout(location = 0) in vec2 i_Position;
+layout(location = 1) in vec2 i_TextureCoordinates;
+layout(location = 2) in vec4 i_Color;
+layout(location = 3) in vec4 i_BorderColor;
+layout(location = 4) in vec4 i_Shape;
+layout(location = 5) in vec2 i_Parameters;
+
+layout(location = 0) out vec2 o_TextureCoordinates;
+layout(location = 1) flat out vec4 o_Color;
+layout(location = 2) flat out vec4 o_BorderColor;
+layout(location = 3) flat out vec4 o_Shape;
+layout(location = 4) flat out vec2 o_Parameters;
+
+void main()
+{
+    o_TextureCoordinates = i_TextureCoordinates;
+    o_Color = i_Color;
+    o_BorderColor = i_BorderColor;
+    o_Shape = i_Shape;
+    o_Parameters = i_Parameters;
+    gl_Position = vec4(i_Position * 2.0 - 1.0, 0.0, 1.0);
+}
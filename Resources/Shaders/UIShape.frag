@@ -0,0 +1,38 @@
+#version 440 core
+
+// NOTE: has to match UIShapeType in RenderBuffer.cpp
+const int ShapeSolidColor = 0;
+const int ShapeRect = 1;
+
+layout(location = 0) in vec2 i_TextureCoordinates;
+layout(location = 1) flat in vec4 i_Color;
+layout(location = 2) flat in vec4 i_BorderColor;
+layout(location = 3) flat in vec4 i_Shape; // NOTE: rect width and height, corner radius, border thickness
+layout(location = 4) flat in vec2 i_Parameters; // NOTE: shape type
+
+layout(location = 0) out vec4 o_Color;
+
+float RectangleSDF(vec2 Location, vec2 HalfSize, float CornerRadius)
+{
+    vec2 A = abs(Location) - (HalfSize - CornerRadius);
+    return length(max(A, 0.0)) + min(max(A.x, A.y), 0.0) - CornerRadius;
+}
+
+void main()
+{
+    if (int(i_Parameters.x) == ShapeSolidColor)
+    {
+        o_Color = i_Color;
+        return;
+    }
+
+    vec2 HalfRectDimensions = i_Shape.xy / 2.0;
+    vec2 FragmentLocation = (i_TextureCoordinates * 2.0 - 1.0) * HalfRectDimensions;
+    float SDF = RectangleSDF(FragmentLocation, HalfRectDimensions, i_Shape.z);
+
+    const float SmoothingWidth = 2.0;
+    const float HalfSmoothingWidth = 0.5 * SmoothingWidth;
+
+    float IsBorder = smoothstep(-i_Shape.w - HalfSmoothingWidth, -i_Shape.w + HalfSmoothingWidth, SDF);
+    o_Color = mix(i_Color, i_BorderColor, IsBorder) * smoothstep(-HalfSmoothingWidth, HalfSmoothingWidth, -SDF);
+}
@@ -0,0 +1,24 @@
+#version 440 core
+
+layout(location = 0) in vec2 i_TextureCoordinates;
+layout(location = 1) flat in vec4 i_Color;
+layout(location = 4) flat in vec2 i_Parameters; // NOTE: the second component is the screen pixel range of the font
+
+uniform sampler2D u_Texture;
+
+layout(location = 0) out vec4 o_Color;
+
+float Median(float R, float G, float B)
+{
+    return max(min(R, G), min(max(R, G), B));
+}
+
+void main()
+{
+    vec3 MSD = textureLod(u_Texture, vec2(i_TextureCoordinates.x, 1.0 - i_TextureCoordinates.y), 0.0).rgb;
+    float SD = Median(MSD.r, MSD.g, MSD.b);
+
+    float ScreenPxDistance = i_Parameters.y * (SD - 0.5);
+    float Opacity = clamp(ScreenPxDistance + 0.5, 0.0, 1.0);
+    o_Color = vec4(i_Color.rgb, Opacity);
+}
@@ -0,0 +1,26 @@
+#version 440
+
+layout(location = 0) in vec2 i_Position;
+layout(location = 1) in vec3 i_Color;
+
+layout(location = 0) out vec3 o_Color;
+
+layout(location = 1) uniform mat4 u_ViewProjectionMatrix;
+
+// NOTE: one texel per instance, the icon is placed halfway between xy and zw, with its +Y axis pointing from xy to zw
+layout(binding = 1) uniform samplerBuffer u_Instances;
+
+void main()
+{
+    vec4 Instance = texelFetch(u_Instances, gl_InstanceID);
+    vec2 From = Instance.xy;
+    vec2 To = Instance.zw;
+
+    vec2 Up = normalize(To - From);
+    vec2 Right = vec2(Up.y, -Up.x);
+    vec2 Position = 0.5 * (From + To) + i_Position.x * Right + i_Position.y * Up;
+
+    o_Color = i_Color;
+
+    gl_Position = u_ViewProjectionMatrix * vec4(Position, 0.0, 1.0);
+}
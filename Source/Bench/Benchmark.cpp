@@ -0,0 +1,87 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <nlohmann/json.hpp>
+#include <numeric>
+
+#include "Core/Assert.h"
+
+BenchmarkRunner::BenchmarkRunner(std::optional<std::string> Filter)
+	: m_Filter(std::move(Filter))
+{
+}
+
+bool BenchmarkRunner::ShouldRun(std::string_view Name) const
+{
+	if (!m_Filter.has_value())
+		return true;
+	return Name.find(m_Filter.value()) != std::string_view::npos;
+}
+
+std::string BenchmarkRunner::ToJSON() const
+{
+	using namespace nlohmann;
+
+	json Benchmarks = json::array();
+	for (const auto& Result : m_Results)
+	{
+		json JSONResult = {
+			{ "name", Result.Name },
+			{ "network", Result.Network },
+			{ "warmup_iterations", Result.WarmupIterations },
+			{ "iterations", Result.Iterations },
+			{ "min_us", Result.Min },
+			{ "median_us", Result.Median },
+			{ "p99_us", Result.P99 },
+			{ "max_us", Result.Max },
+			{ "mean_us", Result.Mean },
+			{ "allocations_per_iteration", Result.AllocationsPerIteration },
+			{ "allocated_bytes_per_iteration", Result.AllocatedBytesPerIteration },
+			{ "peak_bytes", Result.PeakBytes },
+		};
+		Benchmarks.push_back(JSONResult);
+	}
+
+	json Root = {
+		{ "schema_version", 1 },
+		{ "benchmarks", Benchmarks },
+	};
+	return Root.dump(4);
+}
+
+void BenchmarkRunner::AddResult(std::string_view Name, std::string_view Network, const BenchmarkConfig& Config, std::vector<double>& Samples,
+	uint64_t Allocations, uint64_t AllocatedBytes, uint64_t PeakBytes)
+{
+	BD_ASSERT(!Samples.empty());
+	std::ranges::sort(Samples);
+
+	auto Percentile = [&](double Fraction)
+	{
+		auto Rank = static_cast<size_t>(std::ceil(Fraction * static_cast<double>(Samples.size())));
+		return Samples[std::clamp<size_t>(Rank, 1, Samples.size()) - 1];
+	};
+
+	auto Middle = Samples.size() / 2;
+	auto Median = (Samples.size() % 2 == 0 ? 0.5 * (Samples[Middle - 1] + Samples[Middle]) : Samples[Middle]);
+
+	BenchmarkResult Result = {
+		.Name = std::string(Name),
+		.Network = std::string(Network),
+		.WarmupIterations = Config.WarmupIterations,
+		.Iterations = Config.Iterations,
+		.Min = Samples.front(),
+		.Median = Median,
+		.P99 = Percentile(0.99),
+		.Max = Samples.back(),
+		.Mean = std::accumulate(Samples.begin(), Samples.end(), 0.0) / static_cast<double>(Samples.size()),
+		.AllocationsPerIteration = static_cast<double>(Allocations) / static_cast<double>(Samples.size()),
+		.AllocatedBytesPerIteration = static_cast<double>(AllocatedBytes) / static_cast<double>(Samples.size()),
+		.PeakBytes = PeakBytes,
+	};
+
+	BD_LOG_INFO("{:<48} {:<8} median {:>12.2f}us  p99 {:>12.2f}us  allocs {:>10.1f}  peak {:>10} B", Result.Name, Result.Network, Result.Median, Result.P99,
+		Result.AllocationsPerIteration, Result.PeakBytes);
+
+	m_Results.push_back(std::move(Result));
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core/AllocationTracker.h"
+#include "Platform/Time.h"
+
+/*
+ * Stores a value computed by a benchmark body so that the compiler cannot optimize the computation away.
+ */
+template<typename ValueType>
+void DoNotOptimize(const ValueType& Value)
+{
+	static volatile ValueType Sink = {};
+	Sink = Value;
+}
+
+struct BenchmarkConfig
+{
+	uint32_t WarmupIterations = 2;
+	uint32_t Iterations = 20;
+};
+
+struct BenchmarkResult
+{
+	std::string Name;
+	std::string Network;
+
+	uint32_t WarmupIterations = 0;
+	uint32_t Iterations = 0;
+
+	// NOTE: all timings are in microseconds
+	double Min = 0.0;
+	double Median = 0.0;
+	double P99 = 0.0;
+	double Max = 0.0;
+	double Mean = 0.0;
+
+	// NOTE: averaged over the measured iterations, setup is not included
+	double AllocationsPerIteration = 0.0;
+	double AllocatedBytesPerIteration = 0.0;
+
+	// NOTE: the largest amount of heap memory a single iteration held on top of what was live when it started
+	uint64_t PeakBytes = 0;
+};
+
+/*
+ * Runs a benchmark body a fixed number of times and collects the timing distribution. Every iteration
+ * calls the setup function first, which is not included in the measured time, so that benchmarks which
+ * mutate the world (e.g. opening a route) can restore their initial state and stay repeatable.
+ */
+class BenchmarkRunner
+{
+public:
+	explicit BenchmarkRunner(std::optional<std::string> Filter);
+
+	bool ShouldRun(std::string_view Name) const;
+
+	template<typename SetupFuncType, typename BodyFuncType>
+	void Run(std::string_view Name, std::string_view Network, const BenchmarkConfig& Config, SetupFuncType&& Setup, BodyFuncType&& Body);
+
+	std::span<const BenchmarkResult> Results() const { return m_Results; }
+
+	std::string ToJSON() const;
+
+private:
+	std::optional<std::string> m_Filter;
+
+	std::vector<BenchmarkResult> m_Results;
+
+	void AddResult(std::string_view Name, std::string_view Network, const BenchmarkConfig& Config, std::vector<double>& Samples,
+		uint64_t Allocations, uint64_t AllocatedBytes, uint64_t PeakBytes);
+};
+
+template<typename SetupFuncType, typename BodyFuncType>
+void BenchmarkRunner::Run(std::string_view Name, std::string_view Network, const BenchmarkConfig& Config, SetupFuncType&& Setup, BodyFuncType&& Body)
+{
+	if (!ShouldRun(Name))
+		return;
+
+	for (uint32_t Iteration = 0; Iteration < Config.WarmupIterations; Iteration++)
+	{
+		Setup();
+		Body();
+	}
+
+	std::vector<double> Samples;
+	Samples.reserve(Config.Iterations);
+	uint64_t Allocations = 0;
+	uint64_t AllocatedBytes = 0;
+	uint64_t PeakBytes = 0;
+	for (uint32_t Iteration = 0; Iteration < Config.Iterations; Iteration++)
+	{
+		Setup();
+
+		auto AllocationCountAtStart = AllocationTracker::AllocationCount();
+		auto AllocatedBytesAtStart = AllocationTracker::AllocatedBytes();
+		auto LiveBytesAtStart = AllocationTracker::LiveBytes();
+		AllocationTracker::ResetPeakLiveBytes();
+		auto Start = Time::Now();
+		Body();
+		auto End = Time::Now();
+		Allocations += AllocationTracker::AllocationCount() - AllocationCountAtStart;
+		AllocatedBytes += AllocationTracker::AllocatedBytes() - AllocatedBytesAtStart;
+		PeakBytes = std::max(PeakBytes, AllocationTracker::PeakLiveBytes() - LiveBytesAtStart);
+
+		Samples.push_back(static_cast<double>(Time::Duration(Start, End)) * 1.0e6);
+	}
+
+	AddResult(Name, Network, Config, Samples, Allocations, AllocatedBytes, PeakBytes);
+}
@@ -0,0 +1,68 @@
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "Bench/Benchmark.h"
+#include "Bench/SyntheticWorld.h"
+#include "Bench/WorldBenchmarks.h"
+#include "Core/Logger.h"
+
+static constexpr auto DefaultOutputPath = "bench_output.json";
+
+static SyntheticNetworkDescription Networks[] = {
+	{ .Name = "small",  .LineCount = 4,  .LineLength = 64,  .SignalSpacing = 8,  .CrossoverSpacing = 16, .TrainCount = 8,   .Config = { .WarmupIterations = 10, .Iterations = 200 } },
+	{ .Name = "medium", .LineCount = 16, .LineLength = 256, .SignalSpacing = 8,  .CrossoverSpacing = 16, .TrainCount = 64,  .Config = { .WarmupIterations = 5,  .Iterations = 50 } },
+	{ .Name = "huge",   .LineCount = 32, .LineLength = 512, .SignalSpacing = 16, .CrossoverSpacing = 32, .TrainCount = 256, .Config = { .WarmupIterations = 1,  .Iterations = 10 } },
+};
+
+/*
+ * Usage: BuildAndDispatchBench [--output <path>] [--filter <benchmark name substring>] [--network <small|medium|huge>]
+ */
+int main(int ArgumentCount, char** Arguments)
+{
+	GLogger = std::make_unique<Logger>(LogLevel::Info, std::nullopt, true);
+
+	std::string OutputPath = DefaultOutputPath;
+	std::optional<std::string> Filter;
+	std::optional<std::string> NetworkName;
+	for (int Index = 1; Index < ArgumentCount; Index++)
+	{
+		auto Argument = std::string_view(Arguments[Index]);
+		if (Index + 1 >= ArgumentCount)
+		{
+			BD_LOG_ERROR("Missing value for argument {}", Argument);
+			return 1;
+		}
+
+		if (Argument == "--output")
+			OutputPath = Arguments[++Index];
+		else if (Argument == "--filter")
+			Filter = Arguments[++Index];
+		else if (Argument == "--network")
+			NetworkName = Arguments[++Index];
+		else
+		{
+			BD_LOG_ERROR("Unknown argument {}", Argument);
+			return 1;
+		}
+	}
+
+	BenchmarkRunner Runner(Filter);
+	for (const auto& Network : Networks)
+	{
+		if (NetworkName.has_value() && NetworkName.value() != Network.Name)
+			continue;
+		WorldBenchmarks::Run(Runner, Network);
+	}
+
+	auto JSON = Runner.ToJSON();
+	auto OutputFile = FileSystem::Open(OutputPath, FileSystem::OpenMode::CreateNew, FileSystem::AccessMode::ReadWrite);
+	if (!OutputFile || !OutputFile->Write(reinterpret_cast<const uint8_t*>(JSON.data()), JSON.size()))
+	{
+		BD_LOG_ERROR("Could not write benchmark results to {}", OutputPath);
+		return 1;
+	}
+
+	BD_LOG_INFO("Wrote {} benchmark results to {}", Runner.Results().size(), OutputPath);
+	return 0;
+}
@@ -0,0 +1,76 @@
+#include "SyntheticWorld.h"
+
+#include <format>
+
+#include "Core/Assert.h"
+
+static int32_t FirstCrossoverOffset(const SyntheticNetworkDescription& Description, int32_t Line)
+{
+	// NOTE: crossovers start halfway between two signals so that a route never begins on a point, and crossovers on
+	//       neighboring lines are staggered so that the tile where a crossover from the line below lands is never the
+	//       tile where the next crossover starts - this keeps every point a simple 3-way one
+	return Description.SignalSpacing / 2 + (Line % 2 == 0 ? 0 : Description.CrossoverSpacing / 2);
+}
+
+World SyntheticWorld::Build(const SyntheticNetworkDescription& Description)
+{
+	BD_ASSERT(Description.LineCount > 0 && Description.LineLength >= 8);
+	BD_ASSERT(Description.SignalSpacing > 0 && Description.CrossoverSpacing >= 8);
+
+	World Result;
+
+	for (int32_t Line = 0; Line < Description.LineCount; Line++)
+	{
+		for (int32_t X = 0; X < Description.LineLength - 1; X++)
+			Result.AddTrack(X, Line, X + 1, Line);
+
+		Result.AddExit(Exit{
+			.Name = std::format("W{}", Line),
+			.Location = { 0, Line },
+			.SpawnDirection = TrackDirection::E
+		});
+		Result.AddExit(Exit{
+			.Name = std::format("E{}", Line),
+			.Location = { Description.LineLength - 1, Line },
+			.SpawnDirection = TrackDirection::W
+		});
+
+		auto PlatformCenter = Description.LineLength / 2;
+		Result.AddTrackArea(TrackArea{
+			.Name = std::format("Platform {}", Line),
+			.EntryPoints = { TrackAreaLocation{ .TileFrom = { PlatformCenter - 2, Line }, .TileTo = { PlatformCenter - 1, Line } } },
+			.StoppingPoints = { TrackAreaLocation{ .TileFrom = { PlatformCenter + 1, Line }, .TileTo = { PlatformCenter + 2, Line } } }
+		});
+
+		for (int32_t X = Description.SignalSpacing; X < Description.LineLength - 1; X += Description.SignalSpacing)
+			Result.AddSignal({ .FromTile = { X, Line }, .ToTile = { X + 1, Line } }, SignalKind::Automatic);
+	}
+
+	for (int32_t Line = 0; Line < Description.LineCount - 1; Line++)
+	{
+		for (int32_t X = FirstCrossoverOffset(Description, Line); X + 1 < Description.LineLength - 2; X += Description.CrossoverSpacing)
+		{
+			Result.AddTrack(X, Line, X + 1, Line + 1);
+
+			// Both ends of a freshly built crossover default to the diverging path, set them to straight so that
+			// trains stay on their own line
+			Result.SwitchPoint(X, Line);
+			Result.SwitchPoint(X + 1, Line + 1);
+		}
+	}
+
+	for (int32_t TrainIndex = 0; TrainIndex < Description.TrainCount; TrainIndex++)
+	{
+		auto Line = TrainIndex % Description.LineCount;
+		auto SpawnTime = WorldTime::FromSeconds(60.0f * static_cast<float>(TrainIndex / Description.LineCount));
+		auto ArrivalTime = SpawnTime + 120.0f;
+		auto DepartureTime = ArrivalTime + 30.0f;
+		auto LeaveTime = DepartureTime + 120.0f;
+
+		Result.SpawnTrain(std::format("T{}", TrainIndex), 1.0f, Timetable(
+			SpawnTime, ArrivalTime, DepartureTime, LeaveTime,
+			std::format("W{}", Line), std::format("Platform {}", Line), std::format("E{}", Line), 10.0f));
+	}
+
+	return Result;
+}
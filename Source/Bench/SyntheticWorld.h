@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+#include "Bench/Benchmark.h"
+#include "Simulation/World.h"
+
+/*
+ * Describes a procedurally generated network: a number of parallel east-west lines connected by
+ * crossovers from each line to the one above it. Every line has an exit on both ends, a platform
+ * in the middle and automatic signals for eastbound trains spaced evenly along it.
+ */
+struct SyntheticNetworkDescription
+{
+	std::string Name;
+
+	int32_t LineCount = 0;
+	int32_t LineLength = 0;
+	int32_t SignalSpacing = 0;
+	int32_t CrossoverSpacing = 0;
+	int32_t TrainCount = 0;
+
+	BenchmarkConfig Config;
+};
+
+namespace SyntheticWorld
+{
+	World Build(const SyntheticNetworkDescription& Description);
+}
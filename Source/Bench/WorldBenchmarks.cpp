@@ -0,0 +1,150 @@
+#include "WorldBenchmarks.h"
+
+#include <optional>
+
+#include "Core/Assert.h"
+#include "Simulation/WorldSerialization.h"
+
+static constexpr float SimulationTickDuration = 1.0f / 60.0f;
+static constexpr float SimulationSpeed = 10.0f;
+static constexpr int32_t RouteLengthInBlocks = 4;
+
+static SignalLocation SignalLocationOnLine(int32_t X, int32_t Line)
+{
+	return { .FromTile = { X, Line }, .ToTile = { X + 1, Line } };
+}
+
+static int32_t LastSignalOnLine(const SyntheticNetworkDescription& Network)
+{
+	return ((Network.LineLength - 2) / Network.SignalSpacing) * Network.SignalSpacing;
+}
+
+void WorldBenchmarks::Run(BenchmarkRunner& Runner, const SyntheticNetworkDescription& Network)
+{
+	auto Prototype = SyntheticWorld::Build(Network);
+	BD_LOG_INFO("Network '{}': {} tiles, {} signals, {} trains", Network.Name, Prototype.TrackTiles().size(), Prototype.Signals().size(), Prototype.Trains().size());
+
+	Update(Runner, Network, Prototype);
+	TryCreateRoute(Runner, Network, Prototype);
+	TryOpenRoute(Runner, Network, Prototype);
+	FloodFillOccupiedTrack(Runner, Network, Prototype);
+	IsBlockInFrontFullyClear(Runner, Network, Prototype);
+	ListValidPathsInTile(Runner, Network, Prototype);
+	Serialization(Runner, Network, Prototype);
+}
+
+void WorldBenchmarks::Update(BenchmarkRunner& Runner, const SyntheticNetworkDescription& Network, const World& Prototype)
+{
+	// NOTE: the world is not reset between iterations - every iteration is the next simulation tick, just like in game
+	std::optional<World> Instance;
+	Runner.Run("World::Update", Network.Name, Network.Config,
+		[&]
+		{
+			if (Instance.has_value())
+				return;
+			Instance.emplace(Prototype);
+			Instance->SetSimulationSpeed(SimulationSpeed);
+		},
+		[&] { Instance->Update(SimulationTickDuration); });
+}
+
+void WorldBenchmarks::TryCreateRoute(BenchmarkRunner& Runner, const SyntheticNetworkDescription& Network, const World& Prototype)
+{
+	World Instance = Prototype;
+
+	auto From = SignalLocationOnLine(Network.SignalSpacing, 0);
+	auto To = SignalLocationOnLine(std::min(Network.SignalSpacing * (RouteLengthInBlocks + 1), LastSignalOnLine(Network)), 0);
+
+	Runner.Run("World::TryCreateRoute", Network.Name, Network.Config,
+		[] {},
+		[&] { DoNotOptimize(Instance.TryCreateRoute(From, To).has_value()); });
+}
+
+void WorldBenchmarks::TryOpenRoute(BenchmarkRunner& Runner, const SyntheticNetworkDescription& Network, const World& Prototype)
+{
+	World RouteSource = Prototype;
+
+	auto From = SignalLocationOnLine(Network.SignalSpacing, 0);
+	auto To = SignalLocationOnLine(std::min(Network.SignalSpacing * (RouteLengthInBlocks + 1), LastSignalOnLine(Network)), 0);
+	auto Route = RouteSource.TryCreateRoute(From, To);
+	BD_ASSERT(Route.has_value());
+
+	// NOTE: opening a route reserves the track, so every iteration needs a fresh copy of the world
+	std::optional<World> Instance;
+	Runner.Run("World::TryOpenRoute", Network.Name, Network.Config,
+		[&] { Instance.emplace(Prototype); },
+		[&] { DoNotOptimize(Instance->TryOpenRoute(Route.value())); });
+}
+
+void WorldBenchmarks::FloodFillOccupiedTrack(BenchmarkRunner& Runner, const SyntheticNetworkDescription& Network, const World& Prototype)
+{
+	std::optional<World> Instance;
+	Runner.Run("World::FloodFillOccupiedTrack", Network.Name, Network.Config,
+		[&] { Instance.emplace(Prototype); },
+		[&] { Instance->FloodFillOccupiedTrack(Instance->FindTile(1, 0), TrackDirection::E); });
+}
+
+void WorldBenchmarks::IsBlockInFrontFullyClear(BenchmarkRunner& Runner, const SyntheticNetworkDescription& Network, const World& Prototype)
+{
+	Runner.Run("World::IsBlockInFrontFullyClear (all signals)", Network.Name, Network.Config,
+		[] {},
+		[&]
+		{
+			size_t ClearBlockCount = 0;
+			for (const auto& Signal : Prototype.Signals())
+				ClearBlockCount += Prototype.IsBlockInFrontFullyClear(Signal);
+			DoNotOptimize(ClearBlockCount);
+		});
+}
+
+void WorldBenchmarks::ListValidPathsInTile(BenchmarkRunner& Runner, const SyntheticNetworkDescription& Network, const World& Prototype)
+{
+	Runner.Run("World::ListValidPathsInTile (all tiles)", Network.Name, Network.Config,
+		[] {},
+		[&]
+		{
+			size_t PathCount = 0;
+			for (const auto& Tile : Prototype.TrackTiles())
+				PathCount += Prototype.ListValidPathsInTile(Tile.Tile.x, Tile.Tile.y).size();
+			DoNotOptimize(PathCount);
+		});
+}
+
+void WorldBenchmarks::Serialization(BenchmarkRunner& Runner, const SyntheticNetworkDescription& Network, const World& Prototype)
+{
+	Runner.Run("WorldSerialization::Serialize", Network.Name, Network.Config,
+		[] {},
+		[&] { DoNotOptimize(WorldSerialization::Serialize(Prototype).size()); });
+
+	Runner.Run("WorldSerialization::Serialize (compact)", Network.Name, Network.Config,
+		[] {},
+		[&] { DoNotOptimize(WorldSerialization::Serialize(Prototype, JSONWriter::Style::Compact).size()); });
+
+	// NOTE: this is what an autosave does, so it includes the cost of the file system
+	static constexpr auto SaveFilePath = "BenchmarkSave.json";
+	Runner.Run("WorldSerialization::Serialize (to file)", Network.Name, Network.Config,
+		[] {},
+		[&]
+		{
+			auto File = FileSystem::Open(SaveFilePath, FileSystem::OpenMode::CreateNew, FileSystem::AccessMode::ReadWrite);
+			BD_ASSERT(File);
+			DoNotOptimize(WorldSerialization::Serialize(Prototype, *File));
+		});
+
+	auto Serialized = WorldSerialization::Serialize(Prototype);
+	Runner.Run("WorldSerialization::Deserialize", Network.Name, Network.Config,
+		[] {},
+		[&] { DoNotOptimize(WorldSerialization::Deserialize(Serialized).TrackTiles().size()); });
+
+	Runner.Run("WorldSerialization::SerializeBinary", Network.Name, Network.Config,
+		[] {},
+		[&] { DoNotOptimize(WorldSerialization::SerializeBinary(Prototype).size()); });
+
+	auto SerializedBinary = WorldSerialization::SerializeBinary(Prototype);
+	std::string_view SerializedBinaryView(reinterpret_cast<const char*>(SerializedBinary.data()), SerializedBinary.size());
+	Runner.Run("WorldSerialization::Deserialize (binary)", Network.Name, Network.Config,
+		[] {},
+		[&] { DoNotOptimize(WorldSerialization::Deserialize(SerializedBinaryView).TrackTiles().size()); });
+
+	BD_LOG_INFO("Serialized size of network '{}': {} bytes as JSON, {} bytes as binary", Network.Name, Serialized.size(), SerializedBinary.size());
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Bench/Benchmark.h"
+#include "Bench/SyntheticWorld.h"
+
+/*
+ * Benchmarks of the simulation hot paths. This class is a friend of World so that the private
+ * functions which dominate World::Update can be measured in isolation.
+ */
+class WorldBenchmarks
+{
+public:
+	static void Run(BenchmarkRunner& Runner, const SyntheticNetworkDescription& Network);
+
+private:
+	static void Update(BenchmarkRunner& Runner, const SyntheticNetworkDescription& Network, const World& Prototype);
+
+	static void TryCreateRoute(BenchmarkRunner& Runner, const SyntheticNetworkDescription& Network, const World& Prototype);
+
+	static void TryOpenRoute(BenchmarkRunner& Runner, const SyntheticNetworkDescription& Network, const World& Prototype);
+
+	static void FloodFillOccupiedTrack(BenchmarkRunner& Runner, const SyntheticNetworkDescription& Network, const World& Prototype);
+
+	static void IsBlockInFrontFullyClear(BenchmarkRunner& Runner, const SyntheticNetworkDescription& Network, const World& Prototype);
+
+	static void ListValidPathsInTile(BenchmarkRunner& Runner, const SyntheticNetworkDescription& Network, const World& Prototype);
+
+	static void Serialization(BenchmarkRunner& Runner, const SyntheticNetworkDescription& Network, const World& Prototype);
+};
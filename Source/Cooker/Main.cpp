@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core/AssetArchive.h"
+#include "Core/Assert.h"
+#include "Core/CookedAsset.h"
+#include "Core/Logger.h"
+#include "Renderer/Texture.h"
+#include "Renderer/VectorIcon.h"
+#include "Simulation/WorldSerialization.h"
+#include "UI/Font.h"
+
+static constexpr auto DefaultResourceDirectory = "Resources";
+
+static std::optional<CookedAssetKind> AssetKindFromPath(const std::filesystem::path& Path)
+{
+	auto Extension = Path.extension();
+	auto Directory = Path.parent_path().filename();
+
+	if (Extension == ".png")
+		return CookedAssetKind::Texture;
+	if (Extension == ".vif")
+		return CookedAssetKind::VectorIcon;
+	if (Extension == ".json" && Directory == "Fonts")
+		return CookedAssetKind::Font;
+	if (Extension == ".json" && Directory == "Levels")
+		return CookedAssetKind::Level;
+	return std::nullopt;
+}
+
+static bool IsUpToDate(const std::filesystem::path& Path)
+{
+	std::error_code Error;
+	auto CookedTime = std::filesystem::last_write_time(CookedAsset::CookedPath(Path.string()), Error);
+	if (Error)
+		return false;
+	return std::filesystem::last_write_time(Path, Error) <= CookedTime && !Error;
+}
+
+static bool Cook(const std::filesystem::path& Path, CookedAssetKind Kind)
+{
+	// NOTE: the runtime uses forward slashes everywhere, so cooked assets are looked up with the same kind of paths
+	auto PathString = Path.generic_string();
+	switch (Kind)
+	{
+	case CookedAssetKind::Font:
+		return Font::Cook(PathString);
+	case CookedAssetKind::VectorIcon:
+		return VectorIcon::Cook(PathString);
+	case CookedAssetKind::Texture:
+		return Texture::Cook(PathString);
+	case CookedAssetKind::Level:
+		return WorldSerialization::Cook(PathString);
+	default:
+		BD_UNREACHABLE();
+	}
+}
+
+/*
+ * Lists everything the game loads from the resource directory: the cooked versions of assets that get cooked, and
+ * every other file (e.g. shaders) as is.
+ */
+static std::vector<std::string> ListPackedAssets(const std::string& ResourceDirectory)
+{
+	std::vector<std::string> Result;
+	for (const auto& Entry : std::filesystem::recursive_directory_iterator(ResourceDirectory))
+	{
+		if (!Entry.is_regular_file())
+			continue;
+
+		auto Extension = Entry.path().extension();
+		if (Extension == CookedAsset::Extension || Extension == ".tmp")
+			continue;
+
+		auto Path = Entry.path().generic_string();
+		if (AssetKindFromPath(Entry.path()).has_value())
+			Result.push_back(CookedAsset::CookedPath(Path));
+		else
+			Result.push_back(Path);
+	}
+
+	// NOTE: sorted so that packing the same assets twice gives the same archive
+	std::ranges::sort(Result);
+	return Result;
+}
+
+/*
+ * Usage: BuildAndDispatchCooker [--force] [--archive <path>] [<resource directory>]
+ *
+ * Cooks every font, vector icon, texture and level in the resource directory that has no up to date cooked version
+ * yet, or all of them with --force. With --archive, everything the game needs from the resource directory is then
+ * packed into a single asset archive. Has to be run from the directory the game runs in, since the paths of cooked
+ * and packed assets are relative to it.
+ */
+int main(int ArgumentCount, char** Arguments)
+{
+	GLogger = std::make_unique<Logger>(LogLevel::Info, std::nullopt, true);
+
+	std::string ResourceDirectory = DefaultResourceDirectory;
+	std::optional<std::string> ArchivePath;
+	bool Force = false;
+	for (int Index = 1; Index < ArgumentCount; Index++)
+	{
+		auto Argument = std::string_view(Arguments[Index]);
+		if (Argument == "--force")
+		{
+			Force = true;
+		}
+		else if (Argument == "--archive")
+		{
+			if (Index + 1 >= ArgumentCount)
+			{
+				BD_LOG_ERROR("Missing value for argument {}", Argument);
+				return 1;
+			}
+			ArchivePath = Arguments[++Index];
+		}
+		else
+		{
+			ResourceDirectory = Argument;
+		}
+	}
+
+	std::error_code Error;
+	if (!std::filesystem::is_directory(ResourceDirectory, Error))
+	{
+		BD_LOG_ERROR("{} is not a directory", ResourceDirectory);
+		return 1;
+	}
+
+	uint32_t CookedCount = 0;
+	uint32_t UpToDateCount = 0;
+	uint32_t FailedCount = 0;
+	for (const auto& Entry : std::filesystem::recursive_directory_iterator(ResourceDirectory))
+	{
+		if (!Entry.is_regular_file())
+			continue;
+
+		auto Kind = AssetKindFromPath(Entry.path());
+		if (!Kind.has_value())
+			continue;
+
+		if (!Force && IsUpToDate(Entry.path()))
+		{
+			UpToDateCount++;
+			continue;
+		}
+
+		if (Cook(Entry.path(), *Kind))
+		{
+			BD_LOG_INFO("Cooked {}", Entry.path().generic_string());
+			CookedCount++;
+		}
+		else
+		{
+			BD_LOG_ERROR("Failed to cook {}", Entry.path().generic_string());
+			FailedCount++;
+		}
+	}
+
+	BD_LOG_INFO("Cooked {} assets, {} were up to date, {} failed", CookedCount, UpToDateCount, FailedCount);
+	if (FailedCount > 0)
+		return 1;
+
+	if (ArchivePath.has_value())
+	{
+		auto Assets = ListPackedAssets(ResourceDirectory);
+		if (!AssetArchive::Write(*ArchivePath, Assets))
+		{
+			BD_LOG_ERROR("Failed to pack asset archive {}", *ArchivePath);
+			return 1;
+		}
+		BD_LOG_INFO("Packed {} assets into {}", Assets.size(), *ArchivePath);
+	}
+
+	return 0;
+}
@@ -0,0 +1,187 @@
+#include "AllocationTracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+#include "Core/Assert.h"
+
+namespace AllocationTrackerInternal
+{
+	std::atomic<uint64_t> GAllocationCount = 0;
+	std::atomic<uint64_t> GAllocatedBytes = 0;
+
+	// NOTE: live bytes are measured with the usable size of each block, since that is the only size known on deallocation
+	std::atomic<uint64_t> GLiveBytes = 0;
+	std::atomic<uint64_t> GPeakLiveBytes = 0;
+
+	thread_local uint32_t GForbidDepth = 0;
+
+	void OnAllocation(size_t Size)
+	{
+		GAllocationCount.fetch_add(1, std::memory_order_relaxed);
+		GAllocatedBytes.fetch_add(Size, std::memory_order_relaxed);
+
+#ifdef BD_ASSERT_NO_SIMULATION_ALLOCATIONS
+		if (GForbidDepth > 0)
+		{
+			// NOTE: reporting the failure allocates by itself, so the restriction has to be lifted first
+			GForbidDepth = 0;
+			BD_LOG_FATAL("Heap allocation of {} bytes inside of a scope where allocations are forbidden", Size);
+			BD_ASSERT(false && "Forbidden heap allocation");
+		}
+#endif
+	}
+
+	void OnBlockAllocated(size_t UsableSize)
+	{
+		auto LiveBytes = GLiveBytes.fetch_add(UsableSize, std::memory_order_relaxed) + UsableSize;
+		auto PeakLiveBytes = GPeakLiveBytes.load(std::memory_order_relaxed);
+		while (LiveBytes > PeakLiveBytes && !GPeakLiveBytes.compare_exchange_weak(PeakLiveBytes, LiveBytes, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	void OnBlockFreed(size_t UsableSize)
+	{
+		GLiveBytes.fetch_sub(UsableSize, std::memory_order_relaxed);
+	}
+
+	void* Allocate(size_t Size)
+	{
+		OnAllocation(Size);
+		auto* Memory = std::malloc(Size == 0 ? 1 : Size);
+		if (Memory)
+		{
+#ifdef _WIN32
+			OnBlockAllocated(_msize(Memory));
+#else
+			OnBlockAllocated(malloc_usable_size(Memory));
+#endif
+		}
+		return Memory;
+	}
+
+	void Free(void* Memory)
+	{
+		if (!Memory)
+			return;
+
+#ifdef _WIN32
+		OnBlockFreed(_msize(Memory));
+#else
+		OnBlockFreed(malloc_usable_size(Memory));
+#endif
+		std::free(Memory);
+	}
+
+	void* AllocateAligned(size_t Size, size_t Alignment)
+	{
+		OnAllocation(Size);
+		Size = (Size == 0 ? Alignment : (Size + Alignment - 1) / Alignment * Alignment);
+#ifdef _WIN32
+		auto* Memory = _aligned_malloc(Size, Alignment);
+		if (Memory)
+			OnBlockAllocated(_aligned_msize(Memory, Alignment, 0));
+#else
+		auto* Memory = std::aligned_alloc(Alignment, Size);
+		if (Memory)
+			OnBlockAllocated(malloc_usable_size(Memory));
+#endif
+		return Memory;
+	}
+
+	void FreeAligned(void* Memory, size_t Alignment)
+	{
+		if (!Memory)
+			return;
+
+#ifdef _WIN32
+		OnBlockFreed(_aligned_msize(Memory, Alignment, 0));
+		_aligned_free(Memory);
+#else
+		OnBlockFreed(malloc_usable_size(Memory));
+		std::free(Memory);
+#endif
+	}
+}
+
+namespace AllocationTracker
+{
+	uint64_t AllocationCount()
+	{
+		return AllocationTrackerInternal::GAllocationCount.load(std::memory_order_relaxed);
+	}
+
+	uint64_t AllocatedBytes()
+	{
+		return AllocationTrackerInternal::GAllocatedBytes.load(std::memory_order_relaxed);
+	}
+
+	uint64_t LiveBytes()
+	{
+		return AllocationTrackerInternal::GLiveBytes.load(std::memory_order_relaxed);
+	}
+
+	uint64_t PeakLiveBytes()
+	{
+		return AllocationTrackerInternal::GPeakLiveBytes.load(std::memory_order_relaxed);
+	}
+
+	void ResetPeakLiveBytes()
+	{
+		AllocationTrackerInternal::GPeakLiveBytes.store(LiveBytes(), std::memory_order_relaxed);
+	}
+
+	ForbidAllocationsScope::ForbidAllocationsScope(bool IsActive)
+		: m_IsActive(IsActive)
+	{
+		if (m_IsActive)
+			AllocationTrackerInternal::GForbidDepth++;
+	}
+
+	ForbidAllocationsScope::~ForbidAllocationsScope()
+	{
+		// NOTE: the depth might already be zero if a forbidden allocation was reported inside of this scope
+		if (m_IsActive && AllocationTrackerInternal::GForbidDepth > 0)
+			AllocationTrackerInternal::GForbidDepth--;
+	}
+
+	AllowAllocationsScope::AllowAllocationsScope()
+		: m_SavedForbidDepth(AllocationTrackerInternal::GForbidDepth)
+	{
+		AllocationTrackerInternal::GForbidDepth = 0;
+	}
+
+	AllowAllocationsScope::~AllowAllocationsScope()
+	{
+		AllocationTrackerInternal::GForbidDepth = m_SavedForbidDepth;
+	}
+}
+
+// NOTE: the default array, nothrow and sized versions of new and delete all forward to the ones below
+
+void* operator new(size_t Size)
+{
+	if (auto* Memory = AllocationTrackerInternal::Allocate(Size))
+		return Memory;
+	throw std::bad_alloc();
+}
+
+void* operator new(size_t Size, std::align_val_t Alignment)
+{
+	if (auto* Memory = AllocationTrackerInternal::AllocateAligned(Size, static_cast<size_t>(Alignment)))
+		return Memory;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* Memory) noexcept
+{
+	AllocationTrackerInternal::Free(Memory);
+}
+
+void operator delete(void* Memory, std::align_val_t Alignment) noexcept
+{
+	AllocationTrackerInternal::FreeAligned(Memory, static_cast<size_t>(Alignment));
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+ * Counts every heap allocation made through the global operator new, which is replaced in AllocationTracker.cpp.
+ *
+ * When built with BD_ASSERT_NO_SIMULATION_ALLOCATIONS, code can additionally forbid allocations on the current thread
+ * for the duration of a scope, and any allocation made inside of it is reported as a failed assertion.
+ */
+namespace AllocationTracker
+{
+	uint64_t AllocationCount();
+
+	uint64_t AllocatedBytes();
+
+	/*
+	 * Bytes currently held by live allocations, and the highest value it has reached since the last ResetPeakLiveBytes().
+	 */
+	uint64_t LiveBytes();
+	uint64_t PeakLiveBytes();
+	void ResetPeakLiveBytes();
+
+	class ForbidAllocationsScope
+	{
+	public:
+		explicit ForbidAllocationsScope(bool IsActive = true);
+		~ForbidAllocationsScope();
+
+		ForbidAllocationsScope(const ForbidAllocationsScope&) = delete;
+		ForbidAllocationsScope& operator=(const ForbidAllocationsScope&) = delete;
+
+	private:
+		bool m_IsActive;
+	};
+
+	/*
+	 * Temporarily lifts the restriction of every enclosing ForbidAllocationsScope on the current thread.
+	 */
+	class AllowAllocationsScope
+	{
+	public:
+		AllowAllocationsScope();
+		~AllowAllocationsScope();
+
+		AllowAllocationsScope(const AllowAllocationsScope&) = delete;
+		AllowAllocationsScope& operator=(const AllowAllocationsScope&) = delete;
+
+	private:
+		uint32_t m_SavedForbidDepth;
+	};
+}
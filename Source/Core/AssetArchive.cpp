@@ -0,0 +1,199 @@
+#include "AssetArchive.h"
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include "Core/Logger.h"
+
+namespace
+{
+	static constexpr std::array<char, 4> Magic = { 'B', 'D', 'P', 'K' };
+	static constexpr uint32_t Version = 1;
+
+	struct Header
+	{
+		std::array<char, 4> Magic;
+		uint32_t Version;
+		uint32_t EntryCount;
+		uint32_t StringTableSize;
+	};
+
+	// NOTE: the header is followed by EntryCount entries, then the string table with all paths, then the entry data
+	struct Entry
+	{
+		uint64_t Offset;
+		uint64_t Size;
+		uint32_t PathOffset;
+		uint32_t PathLength;
+	};
+
+	static_assert(sizeof(Header) == 16);
+	static_assert(sizeof(Entry) == 24);
+
+	class ArchivedAsset : public MappedFile
+	{
+	public:
+		ArchivedAsset(std::shared_ptr<MappedFile> Archive, std::span<const uint8_t> Data)
+			: m_Archive(std::move(Archive))
+			, m_Data(Data)
+		{
+		}
+
+		virtual std::span<const uint8_t> Data() const override { return m_Data; }
+
+	private:
+		std::shared_ptr<MappedFile> m_Archive;
+		std::span<const uint8_t> m_Data;
+	};
+}
+
+static std::unique_ptr<AssetArchive> GMountedArchive;
+
+static size_t AlignUp(size_t Offset)
+{
+	return (Offset + AssetArchive::EntryAlignment - 1) / AssetArchive::EntryAlignment * AssetArchive::EntryAlignment;
+}
+
+std::unique_ptr<AssetArchive> AssetArchive::Open(std::string_view Path)
+{
+	std::shared_ptr<MappedFile> File = FileSystem::MapFile(Path);
+	if (!File)
+		return nullptr;
+
+	auto Data = File->Data();
+	Header Header;
+	if (Data.size() < sizeof(Header))
+	{
+		BD_LOG_ERROR("Asset archive {} is too small", Path);
+		return nullptr;
+	}
+	std::memcpy(&Header, Data.data(), sizeof(Header));
+	if (Header.Magic != Magic || Header.Version != Version)
+	{
+		BD_LOG_ERROR("Asset archive {} has version {}, expected version {}", Path, Header.Version, Version);
+		return nullptr;
+	}
+
+	auto StringTableOffset = sizeof(Header) + static_cast<uint64_t>(Header.EntryCount) * sizeof(Entry);
+	if (StringTableOffset + Header.StringTableSize > Data.size())
+	{
+		BD_LOG_ERROR("Table of contents of asset archive {} is out of bounds", Path);
+		return nullptr;
+	}
+	std::string_view StringTable(reinterpret_cast<const char*>(Data.data() + StringTableOffset), Header.StringTableSize);
+
+	auto Result = std::unique_ptr<AssetArchive>(new AssetArchive(File));
+	Result->m_Entries.reserve(Header.EntryCount);
+	for (uint32_t Index = 0; Index < Header.EntryCount; Index++)
+	{
+		Entry Entry;
+		std::memcpy(&Entry, Data.data() + sizeof(Header) + Index * sizeof(Entry), sizeof(Entry));
+
+		if (static_cast<uint64_t>(Entry.PathOffset) + Entry.PathLength > StringTable.size() ||
+			Entry.Offset % EntryAlignment != 0 || Entry.Offset > Data.size() || Entry.Size > Data.size() - Entry.Offset)
+		{
+			BD_LOG_ERROR("Entry {} of asset archive {} is out of bounds", Index, Path);
+			return nullptr;
+		}
+
+		auto EntryPath = StringTable.substr(Entry.PathOffset, Entry.PathLength);
+		Result->m_Entries.emplace(EntryPath, Data.subspan(Entry.Offset, Entry.Size));
+	}
+
+	return Result;
+}
+
+bool AssetArchive::Write(std::string_view Path, std::span<const std::string> AssetPaths)
+{
+	std::vector<Entry> Entries;
+	std::string StringTable;
+	for (const auto& AssetPath : AssetPaths)
+	{
+		Entries.push_back({ .PathOffset = static_cast<uint32_t>(StringTable.size()), .PathLength = static_cast<uint32_t>(AssetPath.size()) });
+		StringTable += AssetPath;
+	}
+
+	std::vector<uint8_t> Buffer(sizeof(Header) + Entries.size() * sizeof(Entry) + StringTable.size());
+	for (size_t Index = 0; Index < AssetPaths.size(); Index++)
+	{
+		auto Contents = FileSystem::ReadFileAsBytes(AssetPaths[Index]);
+		if (!Contents)
+		{
+			BD_LOG_ERROR("Could not read {} while packing asset archive {}", AssetPaths[Index], Path);
+			return false;
+		}
+
+		Entries[Index].Offset = AlignUp(Buffer.size());
+		Entries[Index].Size = Contents->size();
+		Buffer.resize(Entries[Index].Offset + Contents->size());
+		if (!Contents->empty())
+			std::memcpy(Buffer.data() + Entries[Index].Offset, Contents->data(), Contents->size());
+	}
+
+	Header Header = {
+		.Magic = Magic,
+		.Version = Version,
+		.EntryCount = static_cast<uint32_t>(Entries.size()),
+		.StringTableSize = static_cast<uint32_t>(StringTable.size()),
+	};
+	std::memcpy(Buffer.data(), &Header, sizeof(Header));
+	if (!Entries.empty())
+		std::memcpy(Buffer.data() + sizeof(Header), Entries.data(), Entries.size() * sizeof(Entry));
+	std::memcpy(Buffer.data() + sizeof(Header) + Entries.size() * sizeof(Entry), StringTable.data(), StringTable.size());
+
+	auto TemporaryPath = std::string(Path) + ".tmp";
+	{
+		auto File = FileSystem::Open(TemporaryPath, FileSystem::OpenMode::CreateNew, FileSystem::AccessMode::ReadWrite);
+		if (!File || !File->Write(Buffer.data(), Buffer.size()))
+		{
+			BD_LOG_ERROR("Could not write asset archive {}", TemporaryPath);
+			return false;
+		}
+	}
+
+	return FileSystem::Rename(TemporaryPath, Path);
+}
+
+std::optional<std::span<const uint8_t>> AssetArchive::Find(std::string_view AssetPath) const
+{
+	auto It = m_Entries.find(AssetPath);
+	if (It == m_Entries.end())
+		return std::nullopt;
+	return It->second;
+}
+
+bool AssetArchive::Mount(std::string_view Path)
+{
+	auto Archive = Open(Path);
+	if (!Archive)
+		return false;
+
+	BD_LOG_INFO("Mounted asset archive {} with {} entries", Path, Archive->EntryCount());
+	GMountedArchive = std::move(Archive);
+	return true;
+}
+
+std::unique_ptr<MappedFile> AssetArchive::MapArchivedAsset(std::string_view AssetPath)
+{
+	if (!GMountedArchive)
+		return nullptr;
+
+	auto Data = GMountedArchive->Find(AssetPath);
+	if (!Data)
+		return nullptr;
+
+	return std::make_unique<ArchivedAsset>(GMountedArchive->m_File, *Data);
+}
+
+std::unique_ptr<MappedFile> AssetArchive::MapAsset(std::string_view AssetPath)
+{
+	if (auto Asset = MapArchivedAsset(AssetPath))
+		return Asset;
+	return FileSystem::MapFile(AssetPath);
+}
+
+AssetArchive::AssetArchive(std::shared_ptr<MappedFile> File)
+	: m_File(std::move(File))
+{
+}
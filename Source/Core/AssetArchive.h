@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "Platform/File.h"
+
+/*
+ * Single file that packs many assets together, addressed by the same relative paths that the loose files have
+ * (e.g. "Resources/Shaders/Line.vert"). The archive is mapped into memory once and every entry is a view into the
+ * mapping, aligned to EntryAlignment, so reading an asset from it needs neither a syscall nor a copy.
+ *
+ * Loaders go through MapAsset(), which looks the asset up in the mounted archive and falls back to the loose file if
+ * no archive is mounted or the archive does not contain the asset. That way development works without packing.
+ */
+class AssetArchive
+{
+public:
+	static constexpr const char* DefaultPath = "Resources.pak";
+	static constexpr size_t EntryAlignment = 64;
+
+	static std::unique_ptr<AssetArchive> Open(std::string_view Path);
+
+	/*
+	 * Packs the given loose files into a new archive, replacing an existing one atomically.
+	 */
+	static bool Write(std::string_view Path, std::span<const std::string> AssetPaths);
+
+	std::optional<std::span<const uint8_t>> Find(std::string_view AssetPath) const;
+
+	size_t EntryCount() const { return m_Entries.size(); }
+
+	/*
+	 * Makes the archive the one that MapAsset() looks assets up in. Must happen before any asset is loaded, and not
+	 * while assets are being loaded on other threads.
+	 */
+	static bool Mount(std::string_view Path);
+
+	/*
+	 * Returns the asset from the mounted archive, or nullptr if it's not there. The returned view keeps the archive
+	 * mapped even if another archive gets mounted in the meantime.
+	 */
+	static std::unique_ptr<MappedFile> MapArchivedAsset(std::string_view AssetPath);
+
+	static std::unique_ptr<MappedFile> MapAsset(std::string_view AssetPath);
+
+private:
+	std::shared_ptr<MappedFile> m_File;
+
+	// NOTE: keys point into the string table of the mapped file
+	std::unordered_map<std::string_view, std::span<const uint8_t>> m_Entries;
+
+	explicit AssetArchive(std::shared_ptr<MappedFile> File);
+};
@@ -0,0 +1,112 @@
+#include "AssetLoader.h"
+
+#include <algorithm>
+#include <format>
+
+#include "Core/Logger.h"
+#include "Core/Profiler.h"
+
+// NOTE: the game only loads a handful of assets at startup, more workers than that would just sit idle
+static constexpr uint32_t MaxWorkerCount = 8;
+
+std::unique_ptr<AssetLoader> AssetLoader::Create()
+{
+	// NOTE: one core is left to the main thread, which creates the window and compiles shaders while the workers decode
+	auto HardwareThreadCount = std::thread::hardware_concurrency();
+	auto WorkerCount = std::clamp(HardwareThreadCount > 1 ? HardwareThreadCount - 1 : 1u, 1u, MaxWorkerCount);
+	return std::unique_ptr<AssetLoader>(new AssetLoader(WorkerCount));
+}
+
+AssetLoader::AssetLoader(uint32_t WorkerCount)
+{
+	m_Workers.reserve(WorkerCount);
+	for (uint32_t Index = 0; Index < WorkerCount; Index++)
+		m_Workers.emplace_back([this, Index] { WorkerMain(Index); });
+}
+
+AssetLoader::~AssetLoader()
+{
+	{
+		std::scoped_lock Lock(m_Mutex);
+		m_ShouldExit = true;
+	}
+	m_JobAvailable.notify_all();
+
+	for (auto& Worker : m_Workers)
+		Worker.join();
+}
+
+bool AssetLoader::Finish()
+{
+	BD_PROFILE_FUNCTION();
+
+	bool Succeeded = true;
+	while (m_PendingCount > 0)
+	{
+		DecodedAsset Asset;
+		{
+			std::unique_lock Lock(m_Mutex);
+			m_AssetDecoded.wait(Lock, [this] { return !m_DecodedAssets.empty(); });
+			Asset = std::move(m_DecodedAssets.front());
+			m_DecodedAssets.pop_front();
+		}
+		m_PendingCount--;
+
+		if (!Asset.Upload)
+		{
+			BD_LOG_ERROR("Could not load asset {}", Asset.Name);
+			Succeeded = false;
+			continue;
+		}
+
+		BD_PROFILE_SCOPE("AssetLoader::Upload");
+		if (!Asset.Upload())
+		{
+			BD_LOG_ERROR("Could not create asset {}", Asset.Name);
+			Succeeded = false;
+		}
+	}
+
+	return Succeeded;
+}
+
+void AssetLoader::Enqueue(std::string Name, DecodeFunction Decode)
+{
+	{
+		std::scoped_lock Lock(m_Mutex);
+		m_Jobs.push_back({ .Name = std::move(Name), .Decode = std::move(Decode) });
+	}
+	m_PendingCount++;
+	m_JobAvailable.notify_one();
+}
+
+void AssetLoader::WorkerMain(uint32_t WorkerIndex)
+{
+	Profiler::SetThreadName(std::format("Asset loader thread {}", WorkerIndex));
+
+	while (true)
+	{
+		Job Job;
+		{
+			std::unique_lock Lock(m_Mutex);
+			m_JobAvailable.wait(Lock, [this] { return m_ShouldExit || !m_Jobs.empty(); });
+			if (m_ShouldExit)
+				return;
+
+			Job = std::move(m_Jobs.front());
+			m_Jobs.pop_front();
+		}
+
+		UploadFunction Upload;
+		{
+			BD_PROFILE_SCOPE("AssetLoader::Decode");
+			Upload = Job.Decode();
+		}
+
+		{
+			std::scoped_lock Lock(m_Mutex);
+			m_DecodedAssets.push_back({ .Name = std::move(Job.Name), .Upload = std::move(Upload) });
+		}
+		m_AssetDecoded.notify_one();
+	}
+}
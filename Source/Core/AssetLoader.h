@@ -0,0 +1,89 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Loads assets on a pool of worker threads. Every load is split into two steps: decoding (reading the file, parsing,
+ * decompressing, tessellating) runs on a worker, and the upload (creating GL objects from the decoded data) runs on
+ * the thread that calls Finish(), since that's the only thread with a GL context. Decoded assets are uploaded in the
+ * order they finish decoding, so the total load time is close to that of the slowest single asset.
+ */
+class AssetLoader
+{
+public:
+	static std::unique_ptr<AssetLoader> Create();
+
+	~AssetLoader();
+
+	AssetLoader(const AssetLoader&) = delete;
+	AssetLoader& operator=(const AssetLoader&) = delete;
+
+	/*
+	 * Decode must not touch GL or any state that is not owned by the load. Upload returns false if the asset could not
+	 * be created, which makes Finish() fail.
+	 */
+	template<typename DataType>
+	void Load(std::string Name, std::function<std::optional<DataType>()> Decode, std::function<bool(DataType)> Upload);
+
+	/*
+	 * Uploads assets as they get decoded until every requested asset is loaded. Returns false if any of them failed.
+	 */
+	bool Finish();
+
+private:
+	// NOTE: a decode job returns the upload step, or an empty function if decoding failed
+	using UploadFunction = std::function<bool()>;
+	using DecodeFunction = std::function<UploadFunction()>;
+
+	struct Job
+	{
+		std::string Name;
+		DecodeFunction Decode;
+	};
+
+	struct DecodedAsset
+	{
+		std::string Name;
+		UploadFunction Upload;
+	};
+
+	std::vector<std::thread> m_Workers;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_JobAvailable;
+	std::condition_variable m_AssetDecoded;
+	std::deque<Job> m_Jobs;
+	std::deque<DecodedAsset> m_DecodedAssets;
+	bool m_ShouldExit = false;
+
+	// NOTE: only touched by the thread that requests loads and calls Finish()
+	size_t m_PendingCount = 0;
+
+	explicit AssetLoader(uint32_t WorkerCount);
+
+	void Enqueue(std::string Name, DecodeFunction Decode);
+
+	void WorkerMain(uint32_t WorkerIndex);
+};
+
+template<typename DataType>
+void AssetLoader::Load(std::string Name, std::function<std::optional<DataType>()> Decode, std::function<bool(DataType)> Upload)
+{
+	Enqueue(std::move(Name), [Decode = std::move(Decode), Upload = std::move(Upload)]() -> UploadFunction
+	{
+		// NOTE: std::function has to be copyable, so the decoded data is shared with the upload step rather than moved into it
+		auto Data = std::make_shared<std::optional<DataType>>(Decode());
+		if (!Data->has_value())
+			return {};
+
+		return [Upload, Data]() { return Upload(std::move(**Data)); };
+	});
+}
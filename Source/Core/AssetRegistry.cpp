@@ -0,0 +1,141 @@
+#include "AssetRegistry.h"
+
+#include <format>
+
+#include "Core/Assert.h"
+#include "Core/Logger.h"
+#include "Renderer/Shader.h"
+#include "Renderer/Texture.h"
+#include "Renderer/VectorIcon.h"
+#include "UI/Font.h"
+
+std::unique_ptr<AssetRegistry> AssetRegistry::Create()
+{
+	return std::unique_ptr<AssetRegistry>(new AssetRegistry);
+}
+
+std::shared_ptr<Font> AssetRegistry::GetFont(const std::string& Path)
+{
+	return Get(m_Fonts, Path, [&]() { return Font::Load(Path); });
+}
+
+std::shared_ptr<Texture> AssetRegistry::GetTexture(const std::string& Path)
+{
+	return Get(m_Textures, Path, [&]() -> std::shared_ptr<Texture> { return Texture::Load(Path); });
+}
+
+std::shared_ptr<VectorIcon> AssetRegistry::GetVectorIcon(const std::string& Path)
+{
+	return Get(m_VectorIcons, Path, [&]() -> std::shared_ptr<VectorIcon> { return VectorIcon::LoadFromFile(Path); });
+}
+
+std::shared_ptr<Shader> AssetRegistry::GetShader(const std::string& VertexShaderPath, const std::string& FragmentShaderPath)
+{
+	auto Key = std::format("{}|{}", VertexShaderPath, FragmentShaderPath);
+	return Get(m_Shaders, Key, [&]() -> std::shared_ptr<Shader> { return Shader::Create(VertexShaderPath, FragmentShaderPath); });
+}
+
+// NOTE: the decoded data is wrapped in another optional so that the upload step also runs when decoding fails, which
+//       is what lets the registry hand nullptr to every request that is waiting for the asset
+void AssetRegistry::LoadFontAsync(AssetLoader& Loader, const std::string& Path, std::shared_ptr<Font>& Result)
+{
+	if (!Request(m_Fonts, Path, Result))
+		return;
+
+	Loader.Load<std::optional<Font::DecodedFont>>(Path, [Path]() { return std::make_optional(Font::Decode(Path)); }, [this, Path](std::optional<Font::DecodedFont> Decoded)
+	{
+		return Complete(m_Fonts, Path, Decoded ? Font::Create(std::move(*Decoded)) : nullptr);
+	});
+}
+
+void AssetRegistry::LoadTextureAsync(AssetLoader& Loader, const std::string& Path, std::shared_ptr<Texture>& Result)
+{
+	if (!Request(m_Textures, Path, Result))
+		return;
+
+	Loader.Load<std::optional<TextureImage>>(Path, [Path]() { return std::make_optional(Texture::LoadImage(Path)); }, [this, Path](std::optional<TextureImage> Image)
+	{
+		std::shared_ptr<Texture> Created;
+		if (Image)
+			Created = Texture::Create(Image->Dimensions, Image->ChannelCount, Image->Pixels);
+		return Complete(m_Textures, Path, std::move(Created));
+	});
+}
+
+void AssetRegistry::LoadVectorIconAsync(AssetLoader& Loader, const std::string& Path, std::shared_ptr<VectorIcon>& Result)
+{
+	if (!Request(m_VectorIcons, Path, Result))
+		return;
+
+	Loader.Load<std::optional<std::vector<VectorIconVertex>>>(Path, [Path]() { return std::make_optional(VectorIcon::LoadVertices(Path)); }, [this, Path](std::optional<std::vector<VectorIconVertex>> Vertices)
+	{
+		std::shared_ptr<VectorIcon> Created;
+		if (Vertices)
+			Created = VectorIcon::Create(*Vertices);
+		return Complete(m_VectorIcons, Path, std::move(Created));
+	});
+}
+
+template<typename AssetType>
+static size_t UnloadUnusedFromCache(std::unordered_map<std::string, std::shared_ptr<AssetType>>& Assets)
+{
+	return std::erase_if(Assets, [](const auto& Entry) { return Entry.second.use_count() == 1; });
+}
+
+size_t AssetRegistry::UnloadUnused()
+{
+	auto UnloadedCount = UnloadUnusedFromCache(m_Fonts.Assets) + UnloadUnusedFromCache(m_Textures.Assets) +
+		UnloadUnusedFromCache(m_VectorIcons.Assets) + UnloadUnusedFromCache(m_Shaders.Assets);
+	if (UnloadedCount > 0)
+		BD_LOG_INFO("Unloaded {} unused assets, {} remain loaded", UnloadedCount, LoadedAssetCount());
+	return UnloadedCount;
+}
+
+size_t AssetRegistry::LoadedAssetCount() const
+{
+	return m_Fonts.Assets.size() + m_Textures.Assets.size() + m_VectorIcons.Assets.size() + m_Shaders.Assets.size();
+}
+
+template<typename AssetType, typename LoadFunctionType>
+std::shared_ptr<AssetType> AssetRegistry::Get(Cache<AssetType>& Cache, const std::string& Key, LoadFunctionType&& Load)
+{
+	if (auto It = Cache.Assets.find(Key); It != Cache.Assets.end())
+		return It->second;
+
+	BD_ASSERT(!Cache.PendingRequests.contains(Key)); // NOTE: the asset is being loaded asynchronously, the caller has to wait for the loader to finish
+
+	std::shared_ptr<AssetType> Asset = Load();
+	if (Asset)
+		Cache.Assets.emplace(Key, Asset);
+	return Asset;
+}
+
+template<typename AssetType>
+bool AssetRegistry::Request(Cache<AssetType>& Cache, const std::string& Key, std::shared_ptr<AssetType>& Result)
+{
+	if (auto It = Cache.Assets.find(Key); It != Cache.Assets.end())
+	{
+		Result = It->second;
+		return false;
+	}
+
+	auto [It, IsFirstRequest] = Cache.PendingRequests.try_emplace(Key);
+	It->second.push_back(&Result);
+	return IsFirstRequest;
+}
+
+template<typename AssetType>
+bool AssetRegistry::Complete(Cache<AssetType>& Cache, const std::string& Key, std::shared_ptr<AssetType> Asset)
+{
+	auto It = Cache.PendingRequests.find(Key);
+	BD_ASSERT(It != Cache.PendingRequests.end());
+	for (auto* Result : It->second)
+		*Result = Asset;
+	Cache.PendingRequests.erase(It);
+
+	if (!Asset)
+		return false;
+
+	Cache.Assets.emplace(Key, std::move(Asset));
+	return true;
+}
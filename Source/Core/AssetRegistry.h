@@ -0,0 +1,84 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Core/AssetLoader.h"
+
+class Font;
+class Shader;
+class Texture;
+class VectorIcon;
+
+/*
+ * Owns every loaded font, texture, shader and vector icon, keyed by the path(s) they were loaded from. Asking for an
+ * asset that is already loaded is a hash lookup that returns a handle to the same instance, so an asset is only ever
+ * loaded and uploaded to the GPU once no matter how many places use it.
+ *
+ * Handles are reference counted. The registry keeps its own reference, so an asset stays loaded while nothing else
+ * uses it (e.g. a font whose last label was just removed); UnloadUnused() drops the assets that nothing outside
+ * of the registry refers to anymore.
+ *
+ * NOTE: the registry is only accessed from the main thread, the async variants only decode on the loader's workers.
+ */
+class AssetRegistry
+{
+public:
+	static std::unique_ptr<AssetRegistry> Create();
+
+	AssetRegistry(const AssetRegistry&) = delete;
+	AssetRegistry& operator=(const AssetRegistry&) = delete;
+
+	std::shared_ptr<Font> GetFont(const std::string& Path);
+	std::shared_ptr<Texture> GetTexture(const std::string& Path);
+	std::shared_ptr<VectorIcon> GetVectorIcon(const std::string& Path);
+	std::shared_ptr<Shader> GetShader(const std::string& VertexShaderPath, const std::string& FragmentShaderPath);
+
+	/*
+	 * Same as the synchronous getters, but the asset is decoded on a worker of the loader. Result is set right away if
+	 * the asset is already loaded, otherwise once the loader finishes. Requesting an asset that is already being loaded
+	 * does not start a second load.
+	 */
+	void LoadFontAsync(AssetLoader& Loader, const std::string& Path, std::shared_ptr<Font>& Result);
+	void LoadTextureAsync(AssetLoader& Loader, const std::string& Path, std::shared_ptr<Texture>& Result);
+	void LoadVectorIconAsync(AssetLoader& Loader, const std::string& Path, std::shared_ptr<VectorIcon>& Result);
+
+	/*
+	 * Unloads every asset that is not referenced outside of the registry. Returns the number of unloaded assets.
+	 */
+	size_t UnloadUnused();
+
+	size_t LoadedAssetCount() const;
+
+private:
+	template<typename AssetType>
+	struct Cache
+	{
+		std::unordered_map<std::string, std::shared_ptr<AssetType>> Assets;
+
+		// NOTE: every request for an asset that is still being loaded, keyed by its path
+		std::unordered_map<std::string, std::vector<std::shared_ptr<AssetType>*>> PendingRequests;
+	};
+
+	Cache<Font> m_Fonts;
+	Cache<Texture> m_Textures;
+	Cache<VectorIcon> m_VectorIcons;
+	Cache<Shader> m_Shaders;
+
+	AssetRegistry() = default;
+
+	template<typename AssetType, typename LoadFunctionType>
+	static std::shared_ptr<AssetType> Get(Cache<AssetType>& Cache, const std::string& Key, LoadFunctionType&& Load);
+
+	/*
+	 * Returns true if the caller has to start loading the asset, false if the request was satisfied from the cache or
+	 * attached to a load that is already in flight.
+	 */
+	template<typename AssetType>
+	static bool Request(Cache<AssetType>& Cache, const std::string& Key, std::shared_ptr<AssetType>& Result);
+
+	template<typename AssetType>
+	static bool Complete(Cache<AssetType>& Cache, const std::string& Key, std::shared_ptr<AssetType> Asset);
+};
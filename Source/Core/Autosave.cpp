@@ -0,0 +1,128 @@
+#include "Autosave.h"
+
+#include "Core/Assert.h"
+#include "Core/Logger.h"
+#include "Core/Profiler.h"
+#include "Platform/File.h"
+#include "Platform/Time.h"
+#include "Simulation/WorldSerialization.h"
+
+// NOTE: taking the snapshot should stay well below this, it is a copy of a few flat arrays
+static constexpr float TargetFrameTime = 1.0f / 60.0f;
+static constexpr float SnapshotTimeBudget = 0.1f * TargetFrameTime;
+
+std::unique_ptr<Autosave> Autosave::Create(std::string Path, float Interval)
+{
+	BD_ASSERT(Interval > 0.0f);
+	return std::unique_ptr<Autosave>(new Autosave(std::move(Path), Interval));
+}
+
+Autosave::Autosave(std::string Path, float Interval)
+	: m_Path(std::move(Path))
+	, m_TemporaryPath(m_Path + ".tmp")
+	, m_Interval(Interval)
+{
+	m_Thread = std::thread([this] { ThreadMain(); });
+}
+
+Autosave::~Autosave()
+{
+	{
+		std::scoped_lock Lock(m_Mutex);
+		m_ShouldExit = true;
+	}
+	m_SnapshotReady.notify_one();
+
+	// NOTE: a save that is already in flight is finished rather than abandoned, otherwise we would leave a stale temporary file behind
+	m_Thread.join();
+}
+
+void Autosave::Update(float DeltaTime, const World& World)
+{
+	m_TimeSinceLastSave += DeltaTime;
+	if (m_TimeSinceLastSave < m_Interval)
+		return;
+
+	if (m_IsSaving.load(std::memory_order_acquire))
+		return;
+
+	BD_PROFILE_SCOPE("Autosave::Snapshot");
+	auto SnapshotStart = Time::Now();
+
+	{
+		std::scoped_lock Lock(m_Mutex);
+		m_Snapshot.emplace(World);
+		m_IsSaving.store(true, std::memory_order_relaxed);
+	}
+	m_SnapshotReady.notify_one();
+	m_TimeSinceLastSave = 0.0f;
+
+	auto SnapshotTime = Time::Duration(SnapshotStart, Time::Now());
+	if (SnapshotTime > SnapshotTimeBudget)
+		BD_LOG_WARNING("Taking the autosave snapshot took {:.3f} ms, which is over the budget of {:.3f} ms", SnapshotTime * 1000.0f, SnapshotTimeBudget * 1000.0f);
+}
+
+void Autosave::ThreadMain()
+{
+	Profiler::SetThreadName("Autosave thread");
+
+	while (true)
+	{
+		{
+			std::unique_lock Lock(m_Mutex);
+			m_SnapshotReady.wait(Lock, [this] { return m_ShouldExit || m_Snapshot.has_value(); });
+			if (!m_Snapshot.has_value())
+				return;
+		}
+
+		auto SaveStart = Time::Now();
+		if (Write(*m_Snapshot))
+			BD_LOG_INFO("Autosaved to {} in {:.1f} ms", m_Path, Time::Duration(SaveStart, Time::Now()) * 1000.0f);
+
+		{
+			BD_PROFILE_SCOPE("Autosave::FreeSnapshot");
+			m_Snapshot.reset();
+		}
+		m_IsSaving.store(false, std::memory_order_release);
+	}
+}
+
+bool Autosave::Write(const World& Snapshot) const
+{
+	BD_PROFILE_SCOPE("Autosave::Write");
+
+	auto File = FileSystem::Open(m_TemporaryPath, FileSystem::OpenMode::CreateNew, FileSystem::AccessMode::ReadWrite);
+	if (!File)
+	{
+		BD_LOG_ERROR("Could not create autosave file {}", m_TemporaryPath);
+		return false;
+	}
+
+	bool Succeeded = false;
+	{
+		BD_PROFILE_SCOPE("Autosave::Serialize");
+		Succeeded = WorldSerialization::Serialize(Snapshot, *File, JSONWriter::Style::Compact);
+	}
+	if (Succeeded)
+	{
+		BD_PROFILE_SCOPE("Autosave::Flush");
+		Succeeded = File->Flush();
+	}
+
+	// NOTE: the file has to be closed before it can be renamed
+	File.reset();
+
+	if (!Succeeded)
+	{
+		BD_LOG_ERROR("Could not write autosave file {}", m_TemporaryPath);
+		return false;
+	}
+
+	if (!FileSystem::Rename(m_TemporaryPath, m_Path))
+	{
+		BD_LOG_ERROR("Could not replace {} with the new autosave", m_Path);
+		return false;
+	}
+
+	return true;
+}
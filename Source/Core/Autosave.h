@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "Simulation/World.h"
+
+/*
+ * Periodically saves the world on a background thread. The main thread only copies the world at a tick boundary and
+ * hands the copy over; serialization and file IO happen on the autosave thread. The save is written into a temporary
+ * file first and then renamed over the previous one, so a crash during the save never leaves a half-written file.
+ */
+class Autosave
+{
+public:
+	static std::unique_ptr<Autosave> Create(std::string Path, float Interval);
+
+	~Autosave();
+
+	Autosave(const Autosave&) = delete;
+	Autosave& operator=(const Autosave&) = delete;
+
+	/*
+	 * Must be called between simulation ticks. Takes a snapshot of the world once the interval has elapsed, unless the
+	 * previous save is still being written, in which case it tries again on the next call.
+	 */
+	void Update(float DeltaTime, const World& World);
+
+private:
+	std::string m_Path;
+	std::string m_TemporaryPath;
+	float m_Interval;
+	float m_TimeSinceLastSave = 0.0f;
+
+	std::thread m_Thread;
+	std::mutex m_Mutex;
+	std::condition_variable m_SnapshotReady;
+	bool m_ShouldExit = false;
+
+	// NOTE: the main thread only touches the snapshot while m_IsSaving is false, the autosave thread only while it is true
+	std::optional<World> m_Snapshot;
+	std::atomic<bool> m_IsSaving = false;
+
+	Autosave(std::string Path, float Interval);
+
+	void ThreadMain();
+
+	bool Write(const World& Snapshot) const;
+};
@@ -0,0 +1,116 @@
+#include "CookedAsset.h"
+
+#include <filesystem>
+
+#include "Core/AssetArchive.h"
+#include "Core/Logger.h"
+
+static size_t AlignUp(size_t Offset)
+{
+	return (Offset + CookedAsset::RecordAlignment - 1) / CookedAsset::RecordAlignment * CookedAsset::RecordAlignment;
+}
+
+std::string CookedAsset::CookedPath(std::string_view SourcePath)
+{
+	return std::string(SourcePath) + std::string(Extension);
+}
+
+std::unique_ptr<CookedAsset> CookedAsset::Open(std::string_view SourcePath, CookedAssetKind Kind)
+{
+	auto Path = CookedPath(SourcePath);
+
+	// NOTE: assets in an archive are always cooked from the sources that were packed along with them
+	auto File = AssetArchive::MapArchivedAsset(Path);
+	if (!File)
+	{
+		// NOTE: a missing source is fine (e.g. a shipped build with cooked assets only), an outdated cooked asset is not
+		std::error_code Error;
+		auto CookedTime = std::filesystem::last_write_time(Path, Error);
+		if (Error)
+			return nullptr;
+		auto SourceTime = std::filesystem::last_write_time(SourcePath, Error);
+		if (!Error && SourceTime > CookedTime)
+		{
+			BD_LOG_INFO("Cooked asset {} is out of date, loading {} instead", Path, SourcePath);
+			return nullptr;
+		}
+
+		File = FileSystem::MapFile(Path);
+		if (!File)
+			return nullptr;
+	}
+
+	auto Result = std::unique_ptr<CookedAsset>(new CookedAsset(std::move(File)));
+	auto AssetHeader = Result->Read<Header>();
+	if (!AssetHeader || AssetHeader->Magic != Magic || AssetHeader->Kind != Kind)
+	{
+		BD_LOG_WARNING("{} is not a valid cooked asset", Path);
+		return nullptr;
+	}
+	if (AssetHeader->Version != Version)
+	{
+		BD_LOG_INFO("Cooked asset {} has version {}, expected version {}, loading {} instead", Path, AssetHeader->Version, Version, SourcePath);
+		return nullptr;
+	}
+
+	return Result;
+}
+
+std::span<const uint8_t> CookedAsset::ReadRemaining()
+{
+	auto Result = m_Data.subspan(std::min(m_Offset, m_Data.size()));
+	m_Offset = m_Data.size();
+	return Result;
+}
+
+CookedAsset::CookedAsset(std::unique_ptr<MappedFile> File)
+	: m_File(std::move(File))
+	, m_Data(m_File->Data())
+{
+}
+
+std::optional<std::span<const uint8_t>> CookedAsset::ReadBytes(size_t Size)
+{
+	if (m_Offset > m_Data.size() || Size > m_Data.size() - m_Offset)
+		return std::nullopt;
+
+	auto Result = m_Data.subspan(m_Offset, Size);
+	m_Offset = AlignUp(m_Offset + Size);
+	return Result;
+}
+
+CookedAssetWriter::CookedAssetWriter(CookedAssetKind Kind)
+{
+	Write(CookedAsset::Header{ .Magic = CookedAsset::Magic, .Version = CookedAsset::Version, .Kind = Kind, .Padding = 0 });
+}
+
+bool CookedAssetWriter::Finish(std::string_view SourcePath) const
+{
+	auto Path = CookedAsset::CookedPath(SourcePath);
+	auto TemporaryPath = Path + ".tmp";
+
+	{
+		auto File = FileSystem::Open(TemporaryPath, FileSystem::OpenMode::CreateNew, FileSystem::AccessMode::ReadWrite);
+		if (!File || !File->Write(m_Buffer.data(), m_Buffer.size()))
+		{
+			BD_LOG_ERROR("Could not write cooked asset {}", TemporaryPath);
+			return false;
+		}
+	}
+
+	if (!FileSystem::Rename(TemporaryPath, Path))
+	{
+		BD_LOG_ERROR("Could not replace cooked asset {}", Path);
+		return false;
+	}
+
+	return true;
+}
+
+void CookedAssetWriter::WriteBytes(const void* Data, size_t Size)
+{
+	auto Offset = m_Buffer.size();
+	m_Buffer.resize(AlignUp(Offset + Size));
+	if (Size > 0)
+		std::memcpy(m_Buffer.data() + Offset, Data, Size);
+}
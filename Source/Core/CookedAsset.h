@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Platform/File.h"
+
+enum class CookedAssetKind : uint32_t
+{
+	Font = 1,
+	VectorIcon,
+	Texture,
+	Level,
+};
+
+/*
+ * Cooked assets are binary versions of source assets that the asset cooker produces offline, with all parsing and
+ * validation already done. A cooked asset lives next to its source, with CookedAsset::Extension appended to the name.
+ * It starts with a header followed by a payload of plain records whose layout is up to the loader of the given kind.
+ * Every record starts at an offset that is a multiple of RecordAlignment, so records can be used in place.
+ */
+class CookedAsset
+{
+public:
+	static constexpr std::string_view Extension = ".cooked";
+	static constexpr size_t RecordAlignment = 8;
+
+	// NOTE: has to be bumped whenever the payload layout of any asset kind changes
+	static constexpr uint32_t Version = 1;
+
+	struct Header
+	{
+		std::array<char, 4> Magic;
+		uint32_t Version;
+		CookedAssetKind Kind;
+		uint32_t Padding;
+	};
+
+	static constexpr std::array<char, 4> Magic = { 'B', 'D', 'C', 'A' };
+
+	static std::string CookedPath(std::string_view SourcePath);
+
+	/*
+	 * Opens the cooked version of the given source asset. Returns nullptr if there is none, if it is older than the
+	 * source, or if it was cooked by a different version of the cooker - the caller should load the source asset then.
+	 */
+	static std::unique_ptr<CookedAsset> Open(std::string_view SourcePath, CookedAssetKind Kind);
+
+	template<typename RecordType>
+	std::optional<RecordType> Read()
+	{
+		auto Records = ReadArray<RecordType>(1);
+		if (!Records)
+			return std::nullopt;
+		return (*Records)[0];
+	}
+
+	template<typename RecordType>
+	std::optional<std::span<const RecordType>> ReadArray(size_t Count)
+	{
+		static_assert(alignof(RecordType) <= RecordAlignment);
+
+		auto Bytes = ReadBytes(Count * sizeof(RecordType));
+		if (!Bytes)
+			return std::nullopt;
+		return std::span(reinterpret_cast<const RecordType*>(Bytes->data()), Count);
+	}
+
+	std::span<const uint8_t> ReadRemaining();
+
+private:
+	std::unique_ptr<MappedFile> m_File;
+	std::span<const uint8_t> m_Data;
+	size_t m_Offset = 0;
+
+	explicit CookedAsset(std::unique_ptr<MappedFile> File);
+
+	std::optional<std::span<const uint8_t>> ReadBytes(size_t Size);
+};
+
+class CookedAssetWriter
+{
+public:
+	explicit CookedAssetWriter(CookedAssetKind Kind);
+
+	template<typename RecordType>
+	void Write(const RecordType& Record)
+	{
+		WriteArray(std::span<const RecordType>(&Record, 1));
+	}
+
+	template<typename RecordType>
+	void WriteArray(std::span<const RecordType> Records)
+	{
+		WriteBytes(Records.data(), Records.size_bytes());
+	}
+
+	/*
+	 * Writes the cooked version of the given source asset. The file is replaced atomically, so a loader never sees a
+	 * partially written asset.
+	 */
+	bool Finish(std::string_view SourcePath) const;
+
+private:
+	std::vector<uint8_t> m_Buffer;
+
+	void WriteBytes(const void* Data, size_t Size);
+};
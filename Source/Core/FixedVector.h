@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <span>
+
+#include "Core/Assert.h"
+
+/*
+ * Vector with the storage for up to Capacity elements embedded in the object itself, so it never allocates.
+ * Intended for small, trivially copyable element types.
+ */
+template<typename ElementType, size_t Capacity>
+class FixedVector
+{
+public:
+	constexpr FixedVector() = default;
+
+	constexpr FixedVector(std::initializer_list<ElementType> Elements)
+	{
+		for (const auto& Element : Elements)
+			push_back(Element);
+	}
+
+	constexpr void push_back(const ElementType& Element)
+	{
+		BD_ASSERT(m_Size < Capacity);
+		m_Elements[m_Size++] = Element;
+	}
+
+	constexpr void clear() { m_Size = 0; }
+
+	constexpr size_t size() const { return m_Size; }
+	constexpr bool empty() const { return m_Size == 0; }
+	static constexpr size_t capacity() { return Capacity; }
+
+	constexpr ElementType& operator[](size_t Index) { BD_ASSERT(Index < m_Size); return m_Elements[Index]; }
+	constexpr const ElementType& operator[](size_t Index) const { BD_ASSERT(Index < m_Size); return m_Elements[Index]; }
+
+	constexpr ElementType* data() { return m_Elements.data(); }
+	constexpr const ElementType* data() const { return m_Elements.data(); }
+
+	constexpr ElementType* begin() { return data(); }
+	constexpr const ElementType* begin() const { return data(); }
+	constexpr ElementType* end() { return data() + m_Size; }
+	constexpr const ElementType* end() const { return data() + m_Size; }
+
+	constexpr operator std::span<const ElementType>() const { return { data(), m_Size }; }
+
+private:
+	std::array<ElementType, Capacity> m_Elements = {};
+	size_t m_Size = 0;
+};
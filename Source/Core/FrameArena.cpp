@@ -0,0 +1,103 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "Core/Assert.h"
+
+FrameArena::FrameArena(size_t InitialCapacity)
+{
+	AddBlock(std::max<size_t>(InitialCapacity, 1));
+}
+
+FrameArena::FrameArena(const FrameArena& Other)
+	: FrameArena(Other.Capacity())
+{
+}
+
+FrameArena& FrameArena::operator=(const FrameArena&)
+{
+	// NOTE: there is nothing to copy, and the memory of this arena might still be in use by containers that live outside of it
+	return *this;
+}
+
+void FrameArena::Reset()
+{
+	if (m_Blocks.size() > 1)
+	{
+		auto TotalSize = Capacity();
+		m_Blocks.clear();
+		AddBlock(TotalSize);
+	}
+
+	m_CurrentBlock = 0;
+	m_Offset = 0;
+}
+
+size_t FrameArena::BytesUsed() const
+{
+	size_t Result = m_Offset;
+	for (size_t Index = 0; Index < m_CurrentBlock; Index++)
+		Result += m_Blocks[Index].Size;
+	return Result;
+}
+
+size_t FrameArena::Capacity() const
+{
+	size_t Result = 0;
+	for (const auto& Block : m_Blocks)
+		Result += Block.Size;
+	return Result;
+}
+
+FrameArena::Scope::Scope(FrameArena& Arena)
+	: m_Arena(Arena)
+	, m_SavedBlock(Arena.m_CurrentBlock)
+	, m_SavedOffset(Arena.m_Offset)
+{
+}
+
+FrameArena::Scope::~Scope()
+{
+	m_Arena.m_CurrentBlock = m_SavedBlock;
+	m_Arena.m_Offset = m_SavedOffset;
+}
+
+void* FrameArena::do_allocate(size_t Bytes, size_t Alignment)
+{
+	// NOTE: the blocks are only ever appended, so if the current one is too small we can either move on to the next one
+	//       (left over from before a scope rewound the arena) or chain a new one at the end
+	while (true)
+	{
+		auto& Block = m_Blocks[m_CurrentBlock];
+
+		auto BlockStart = reinterpret_cast<uintptr_t>(Block.Memory.get());
+		auto AlignedStart = (BlockStart + m_Offset + Alignment - 1) & ~(static_cast<uintptr_t>(Alignment) - 1);
+		auto NewOffset = AlignedStart - BlockStart + Bytes;
+		if (NewOffset <= Block.Size)
+		{
+			m_Offset = NewOffset;
+			return reinterpret_cast<void*>(AlignedStart);
+		}
+
+		if (m_CurrentBlock + 1 == m_Blocks.size())
+			AddBlock(std::max(2 * Block.Size, Bytes + Alignment));
+		m_CurrentBlock++;
+		m_Offset = 0;
+	}
+}
+
+void FrameArena::do_deallocate(void*, size_t, size_t)
+{
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& Other) const noexcept
+{
+	return this == &Other;
+}
+
+void FrameArena::AddBlock(size_t Size)
+{
+	BD_ASSERT(Size > 0);
+	m_Blocks.push_back({ .Memory = std::make_unique_for_overwrite<std::byte[]>(Size), .Size = Size });
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+/*
+ * Bump allocator for short-lived scratch memory, usable with the std::pmr containers. Deallocation is a no-op;
+ * instead, all memory is returned at once by Reset() (e.g. once per simulation tick), or everything allocated
+ * inside of a Scope is returned when the scope ends.
+ *
+ * When the current block runs out, the arena chains a new one from the heap. The next Reset() merges all blocks
+ * into a single one that is big enough for the whole previous workload, so after a few resets the arena stops
+ * touching the heap at all.
+ *
+ * Copying an arena yields an empty one with the same capacity - the contents are scratch data and are never shared.
+ */
+class FrameArena : public std::pmr::memory_resource
+{
+public:
+	static constexpr size_t DefaultCapacity = 64 * 1024;
+
+	explicit FrameArena(size_t InitialCapacity = DefaultCapacity);
+
+	FrameArena(const FrameArena& Other);
+	FrameArena& operator=(const FrameArena& Other);
+
+	void Reset();
+
+	size_t BytesUsed() const;
+	size_t Capacity() const;
+
+	class Scope
+	{
+	public:
+		explicit Scope(FrameArena& Arena);
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		FrameArena& m_Arena;
+		size_t m_SavedBlock;
+		size_t m_SavedOffset;
+	};
+
+protected:
+	virtual void* do_allocate(size_t Bytes, size_t Alignment) override;
+	virtual void do_deallocate(void* Memory, size_t Bytes, size_t Alignment) override;
+	virtual bool do_is_equal(const std::pmr::memory_resource& Other) const noexcept override;
+
+private:
+	struct Block
+	{
+		std::unique_ptr<std::byte[]> Memory;
+		size_t Size = 0;
+	};
+
+	std::vector<Block> m_Blocks;
+	size_t m_CurrentBlock = 0;
+	size_t m_Offset = 0;
+
+	void AddBlock(size_t Size);
+};
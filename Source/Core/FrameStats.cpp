@@ -0,0 +1,23 @@
+#include "FrameStats.h"
+
+#include <algorithm>
+
+#include "Core/AllocationTracker.h"
+
+FrameStats GFrameStats;
+
+void FrameStats::EndFrame(float FrameTime)
+{
+	auto AllocationCount = AllocationTracker::AllocationCount();
+	auto AllocatedBytes = AllocationTracker::AllocatedBytes();
+
+	m_Current.FrameTime = FrameTime;
+	m_Current.Allocations = AllocationCount - m_AllocationCountAtFrameStart;
+	m_Current.AllocatedBytes = AllocatedBytes - m_AllocatedBytesAtFrameStart;
+	m_LineVerticesHighWaterMark = std::max(m_LineVerticesHighWaterMark, m_Current.LineVertices);
+
+	m_Previous = m_Current;
+	m_Current = {};
+	m_AllocationCountAtFrameStart = AllocationCount;
+	m_AllocatedBytesAtFrameStart = AllocatedBytes;
+}
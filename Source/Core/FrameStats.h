@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "Core/AllocationTracker.h"
+#include "Platform/Time.h"
+
+enum class FramePhase
+{
+	PollEvents,
+	UpdateLayers,
+	Simulation,
+	Render,
+	Count_
+};
+
+constexpr const char* FramePhaseToString(FramePhase Phase)
+{
+	switch (Phase)
+	{
+	case FramePhase::PollEvents:
+		return "Events";
+	case FramePhase::UpdateLayers:
+		return "Layers";
+	case FramePhase::Simulation:
+		return "Simulation";
+	case FramePhase::Render:
+		return "Render";
+	default:
+		return "";
+	}
+}
+
+struct FrameCounters
+{
+	uint32_t SimulationTicks = 0;
+	uint32_t LineVertices = 0;
+	uint32_t LineVertexCapacity = 0;
+	uint32_t LineOverflowFlushes = 0;
+	uint32_t DrawCalls = 0;
+	uint32_t UIDrawCalls = 0;
+	uint32_t UIVertices = 0;
+	uint32_t StateChanges = 0;
+	uint32_t ElidedStateChanges = 0;
+	uint32_t TextureBinds = 0;
+	uint32_t TrackSegmentUploads = 0;
+	uint32_t BufferCreations = 0;
+	uint64_t Allocations = 0;
+	uint64_t AllocatedBytes = 0;
+
+	// NOTE: all times are in seconds
+	float FrameTime = 0.0f;
+	std::array<float, static_cast<size_t>(FramePhase::Count_)> PhaseTimes = {};
+	std::array<uint64_t, static_cast<size_t>(FramePhase::Count_)> PhaseAllocations = {};
+	std::array<uint64_t, static_cast<size_t>(FramePhase::Count_)> PhaseAllocatedBytes = {};
+};
+
+/*
+ * Counters which are accumulated over the course of a single frame. The game loop calls EndFrame() once per frame,
+ * after which the finished frame is available through Previous() until the next frame ends.
+ */
+class FrameStats
+{
+public:
+	FrameCounters& Current() { return m_Current; }
+	const FrameCounters& Previous() const { return m_Previous; }
+
+	/*
+	 * The largest number of line vertices drawn in a single frame so far.
+	 */
+	uint32_t LineVerticesHighWaterMark() const { return m_LineVerticesHighWaterMark; }
+
+	void EndFrame(float FrameTime);
+
+private:
+	FrameCounters m_Current;
+	FrameCounters m_Previous;
+
+	uint32_t m_LineVerticesHighWaterMark = 0;
+
+	uint64_t m_AllocationCountAtFrameStart = 0;
+	uint64_t m_AllocatedBytesAtFrameStart = 0;
+};
+
+extern FrameStats GFrameStats;
+
+class FramePhaseScope
+{
+public:
+	explicit FramePhaseScope(FramePhase Phase)
+		: m_Phase(Phase)
+		, m_Start(Time::Now())
+		, m_AllocationCountAtStart(AllocationTracker::AllocationCount())
+		, m_AllocatedBytesAtStart(AllocationTracker::AllocatedBytes())
+	{
+	}
+
+	~FramePhaseScope()
+	{
+		auto& Counters = GFrameStats.Current();
+		auto Index = static_cast<size_t>(m_Phase);
+		Counters.PhaseTimes[Index] += Time::Duration(m_Start, Time::Now());
+		Counters.PhaseAllocations[Index] += AllocationTracker::AllocationCount() - m_AllocationCountAtStart;
+		Counters.PhaseAllocatedBytes[Index] += AllocationTracker::AllocatedBytes() - m_AllocatedBytesAtStart;
+	}
+
+	FramePhaseScope(const FramePhaseScope&) = delete;
+	FramePhaseScope& operator=(const FramePhaseScope&) = delete;
+
+private:
+	FramePhase m_Phase;
+	Time::Point m_Start;
+	uint64_t m_AllocationCountAtStart;
+	uint64_t m_AllocatedBytesAtStart;
+};
@@ -2,15 +2,21 @@
 
 #include <algorithm>
 
+#include "Core/AssetArchive.h"
+#include "Core/FrameStats.h"
 #include "Core/Logger.h"
-#include "Layer/GameUILayer.h"
-#include "Layer/TrackLayer.h"
+#include "Core/Profiler.h"
 #include "Platform/Time.h"
 #include "Simulation/WorldSerialization.h"
 
 static constexpr uint32_t WindowWidth = 1280;
 static constexpr uint32_t WindowHeight = 720;
 static constexpr const char* WindowName = "Build & Dispatch";
+static constexpr const char* ChromeTracePath = "Files/trace.json";
+static constexpr Key::Key ExportChromeTraceKey = Key::F9;
+static constexpr const char* AutosavePath = "Files/Autosave.json";
+static constexpr float AutosaveInterval = 60.0f;
+static constexpr const char* DefaultLevelPath = "Resources/Levels/Level0.json";
 
 template<typename FuncType>
 void DispatchEventForEachLayer(const std::vector<std::unique_ptr<Layer>>& Layers, FuncType&& Func)
@@ -28,6 +34,23 @@ void DispatchEventForEachLayer(const std::vector<std::unique_ptr<Layer>>& Layers
 
 std::unique_ptr<GameLoop> GameLoop::Create()
 {
+	if (!AssetArchive::Mount(AssetArchive::DefaultPath))
+		BD_LOG_INFO("No asset archive mounted, loading loose asset files");
+
+	// NOTE: assets are decoded while the window gets created and the renderer compiles its shaders, only their upload
+	//       has to wait for the GL context
+	StartupAssets Assets;
+	auto Registry = AssetRegistry::Create();
+	auto Loader = AssetLoader::Create();
+	TrackLayer::LoadAssets(*Loader, *Registry, Assets.TrackLayer);
+	GameUILayer::LoadAssets(*Loader, *Registry, Assets.GameUILayer);
+	PerformanceHUDLayer::LoadAssets(*Loader, *Registry, Assets.PerformanceHUDLayer);
+	Loader->Load<World>(DefaultLevelPath, []() { return WorldSerialization::DeserializeFromFile(DefaultLevelPath); }, [&Assets](World World)
+	{
+		Assets.World = std::move(World);
+		return true;
+	});
+
 	auto Window = Window::Create(WindowWidth, WindowHeight, WindowName, 16);
 	if (!Window)
 	{
@@ -35,46 +58,90 @@ std::unique_ptr<GameLoop> GameLoop::Create()
 		return nullptr;
 	}
 
-	auto Renderer = Renderer::Create(*Window);
+	auto RendererStart = Time::Now();
+	auto Renderer = Renderer::Create(*Window, *Registry);
 	if (!Renderer)
 	{
 		BD_LOG_ERROR("Could not initialize renderer");
 		return nullptr;
 	}
+	BD_LOG_INFO("Created renderer in {:.2f} ms", Time::Duration(RendererStart, Time::Now()) * 1000.0f);
+
+	auto LoadStart = Time::Now();
+	if (!Loader->Finish())
+	{
+		BD_LOG_ERROR("Could not load startup assets");
+		return nullptr;
+	}
+	BD_LOG_INFO("Waited {:.2f} ms for startup assets after creating the renderer, {} assets loaded", Time::Duration(LoadStart, Time::Now()) * 1000.0f, Registry->LoadedAssetCount());
 
-	return std::unique_ptr<GameLoop>(new GameLoop(std::move(Window), std::move(Renderer)));
+	auto TrackLayer = TrackLayer::Create(std::move(Assets.TrackLayer));
+	if (!TrackLayer)
+	{
+		BD_LOG_ERROR("Could not create track layer");
+		return nullptr;
+	}
+
+	return std::unique_ptr<GameLoop>(new GameLoop(std::move(Window), std::move(Registry), std::move(Renderer), std::move(TrackLayer), std::move(Assets)));
 }
 
 int GameLoop::Run()
 {
+	Profiler::SetThreadName("Main thread");
+
 	auto LastFrameEnd = Time::Now();
 	while (!m_Window->ShouldClose())
 	{
+		BD_PROFILE_SCOPE("Frame");
+
 		auto FrameStart = Time::Now();
 		auto DeltaTime = Time::Duration(LastFrameEnd, FrameStart);
 		LastFrameEnd = FrameStart;
 
-		m_Window->PollEvents();
-		UpdateInputState();
+		{
+			BD_PROFILE_SCOPE("PollEvents");
+			FramePhaseScope Phase(FramePhase::PollEvents);
+			m_Window->PollEvents();
+			UpdateInputState();
+		}
 
 		Rect2D RenderArea = { .Min = { 0.0f, 0.0f }, .Max = m_Renderer->FramebufferSize() };
-		for (size_t Index = m_Layers.size(); Index > 0; Index--)
 		{
-			const auto& Layer = m_Layers[Index - 1];
-			Layer->Update(DeltaTime, m_InputState, m_World, RenderArea);
+			BD_PROFILE_SCOPE("UpdateLayers");
+			FramePhaseScope Phase(FramePhase::UpdateLayers);
+			for (size_t Index = m_Layers.size(); Index > 0; Index--)
+			{
+				const auto& Layer = m_Layers[Index - 1];
+				Layer->Update(DeltaTime, m_InputState, m_World, RenderArea);
+			}
 		}
 
-		m_World.Update(DeltaTime);
+		{
+			FramePhaseScope Phase(FramePhase::Simulation);
+			m_World.Update(DeltaTime);
+		}
 
-		m_Renderer->BeginFrame();
+		if (m_Autosave)
+			m_Autosave->Update(DeltaTime, m_World);
 
-		for (const auto& Layer : m_Layers)
 		{
-			Layer->Render(*m_Renderer, m_World);
-			m_Renderer->Flush();
+			BD_PROFILE_SCOPE("Render");
+			FramePhaseScope Phase(FramePhase::Render);
+			m_Renderer->BeginFrame();
+
+			for (const auto& Layer : m_Layers)
+			{
+				Layer->Render(*m_Renderer, m_World);
+				m_Renderer->Flush();
+			}
+
+			m_Renderer->EndFrame();
+
+			// NOTE: every layer has seen this frame's track changes by now
+			m_World.ClearChangedTrackTiles();
 		}
 
-		m_Renderer->EndFrame();
+		GFrameStats.EndFrame(Time::Duration(FrameStart, Time::Now()));
 
 		Time::Sleep(1); // NOTE: this is here just so that we don't get 10k+ FPS and break the world simulation
 	}
@@ -82,16 +149,17 @@ int GameLoop::Run()
 	return 0;
 }
 
-GameLoop::GameLoop(std::unique_ptr<Window> Window, std::unique_ptr<Renderer> Renderer)
+GameLoop::GameLoop(std::unique_ptr<Window> Window, std::unique_ptr<AssetRegistry> Registry, std::unique_ptr<Renderer> Renderer, std::unique_ptr<TrackLayer> TrackLayer, StartupAssets Assets)
 	: m_Window(std::move(Window))
+	, m_Assets(std::move(Registry))
 	, m_Renderer(std::move(Renderer))
+	, m_World(std::move(Assets.World))
 {
-	m_Layers.push_back(TrackLayer::Create());
-	m_Layers.push_back(std::make_unique<GameUILayer>());
+	m_Layers.push_back(std::move(TrackLayer));
+	m_Layers.push_back(std::make_unique<GameUILayer>(*m_Renderer, std::move(Assets.GameUILayer)));
+	m_Layers.push_back(std::make_unique<PerformanceHUDLayer>(*m_Renderer, std::move(Assets.PerformanceHUDLayer)));
 
-	static constexpr auto DefaultLevelName = "Resources/Levels/Level0.json";
-	auto SerializedWorld = FileSystem::ReadFileAsString(DefaultLevelName).value_or("");
-	m_World = WorldSerialization::Deserialize(SerializedWorld);
+	m_Autosave = Autosave::Create(AutosavePath, AutosaveInterval);
 
 	m_Window->AddMouseButtonCallback([this](MouseButton::Button Button, ButtonEventType::Type Type, int32_t CursorX, int32_t CursorY)
 	{
@@ -105,6 +173,20 @@ GameLoop::GameLoop(std::unique_ptr<Window> Window, std::unique_ptr<Renderer> Ren
 	{
 		DispatchEventForEachLayer(m_Layers, [&](Layer& Layer) { return Layer.OnMouseScroll(Offset, m_InputState, m_World); });
 	});
+
+	m_Window->AddKeyCallback([this](Key::Key Key, ButtonEventType::Type Type)
+	{
+		if (Type != ButtonEventType::Press)
+			return;
+
+		if (Key == ExportChromeTraceKey)
+		{
+			Profiler::ExportChromeTrace(ChromeTracePath);
+			return;
+		}
+
+		DispatchEventForEachLayer(m_Layers, [&](Layer& Layer) { return Layer.OnKeyPress(Key, m_InputState, m_World); });
+	});
 }
 
 void GameLoop::UpdateInputState()
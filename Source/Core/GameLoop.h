@@ -2,7 +2,13 @@
 
 #include <memory>
 
+#include "Core/AssetLoader.h"
+#include "Core/AssetRegistry.h"
+#include "Core/Autosave.h"
+#include "Layer/GameUILayer.h"
 #include "Layer/Layer.h"
+#include "Layer/PerformanceHUDLayer.h"
+#include "Layer/TrackLayer.h"
 #include "Simulation/World.h"
 
 class GameLoop
@@ -14,15 +20,28 @@ public:
 
 private:
 	std::unique_ptr<Window> m_Window;
+
+	// NOTE: declared after the window so that assets are freed while the GL context is still alive
+	std::unique_ptr<AssetRegistry> m_Assets;
 	std::unique_ptr<Renderer> m_Renderer;
 
 	InputState m_InputState;
 
 	World m_World;
+	std::unique_ptr<Autosave> m_Autosave;
 
 	std::vector<std::unique_ptr<Layer>> m_Layers;
 
-	GameLoop(std::unique_ptr<Window> Window, std::unique_ptr<Renderer> Renderer);
+	struct StartupAssets
+	{
+		TrackLayer::Assets TrackLayer;
+		GameUILayer::Assets GameUILayer;
+		PerformanceHUDLayer::Assets PerformanceHUDLayer;
+
+		World World;
+	};
+
+	GameLoop(std::unique_ptr<Window> Window, std::unique_ptr<AssetRegistry> Registry, std::unique_ptr<Renderer> Renderer, std::unique_ptr<TrackLayer> TrackLayer, StartupAssets Assets);
 
 	void UpdateInputState();
 };
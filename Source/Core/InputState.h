@@ -13,6 +13,28 @@ namespace MouseButton
 	};
 }
 
+namespace Key
+{
+	enum Key
+	{
+		Unknown = 0,
+		Escape,
+		F1,
+		F2,
+		F3,
+		F4,
+		F5,
+		F6,
+		F7,
+		F8,
+		F9,
+		F10,
+		F11,
+		F12,
+		Count_
+	};
+}
+
 namespace ButtonEventType
 {
 	enum Type
@@ -0,0 +1,332 @@
+#include "JSONWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+#include "Core/Assert.h"
+
+static constexpr size_t IndentSize = 4;
+
+/*
+ * Writes a finite Value in the layout of nlohmann::json's dump(): fixed notation with at least one fractional digit if
+ * the decimal point lands within (-4, 15] digits of the first digit, otherwise scientific notation with a signed exponent
+ * of at least two digits. Needs up to 32 characters.
+ *
+ * NOTE: the digits are the shortest ones that round-trip, as given by std::to_chars. nlohmann uses Grisu2 instead, which
+ *       in rare cases picks a different last digit, so such a value is written differently but still reads back the same.
+ */
+static char* FormatFloat(char* Output, double Value)
+{
+	static constexpr int32_t MinDecimalPoint = -4;
+	static constexpr int32_t MaxDecimalPoint = 15;
+
+	if (std::signbit(Value))
+	{
+		*Output++ = '-';
+		Value = -Value;
+	}
+	if (Value == 0.0)
+	{
+		std::memcpy(Output, "0.0", 3);
+		return Output + 3;
+	}
+
+	// NOTE: the scientific form holds the digits and the exponent separately, e.g. "1.2345e+02"
+	std::array<char, 32> Scientific;
+	auto [ScientificEnd, Error] = std::to_chars(Scientific.data(), Scientific.data() + Scientific.size(), Value, std::chars_format::scientific);
+	BD_ASSERT(Error == std::errc());
+
+	std::array<char, 24> Digits;
+	int32_t DigitCount = 0;
+	auto* Character = Scientific.data();
+	for (; *Character != 'e'; Character++)
+	{
+		if (*Character != '.')
+			Digits[DigitCount++] = *Character;
+	}
+	Character++;
+	if (*Character == '+')
+		Character++;
+	int32_t Exponent = 0;
+	std::from_chars(Character, ScientificEnd, Exponent);
+
+	// NOTE: number of digits in front of the decimal point, negative if it is preceded by zeros
+	auto DecimalPoint = Exponent + 1;
+	if (DigitCount <= DecimalPoint && DecimalPoint <= MaxDecimalPoint)
+	{
+		Output = std::copy_n(Digits.data(), DigitCount, Output);
+		Output = std::fill_n(Output, DecimalPoint - DigitCount, '0');
+		*Output++ = '.';
+		*Output++ = '0';
+		return Output;
+	}
+	if (0 < DecimalPoint && DecimalPoint <= MaxDecimalPoint)
+	{
+		Output = std::copy_n(Digits.data(), DecimalPoint, Output);
+		*Output++ = '.';
+		return std::copy_n(Digits.data() + DecimalPoint, DigitCount - DecimalPoint, Output);
+	}
+	if (MinDecimalPoint < DecimalPoint && DecimalPoint <= 0)
+	{
+		*Output++ = '0';
+		*Output++ = '.';
+		Output = std::fill_n(Output, -DecimalPoint, '0');
+		return std::copy_n(Digits.data(), DigitCount, Output);
+	}
+
+	*Output++ = Digits[0];
+	if (DigitCount > 1)
+	{
+		*Output++ = '.';
+		Output = std::copy_n(Digits.data() + 1, DigitCount - 1, Output);
+	}
+	*Output++ = 'e';
+	*Output++ = Exponent < 0 ? '-' : '+';
+	auto AbsoluteExponent = static_cast<uint32_t>(Exponent < 0 ? -Exponent : Exponent);
+	if (AbsoluteExponent < 10)
+		*Output++ = '0';
+	return std::to_chars(Output, Output + 3, AbsoluteExponent).ptr;
+}
+
+JSONWriter::JSONWriter(Style Style)
+	: m_Style(Style)
+{
+	m_Containers.reserve(16);
+}
+
+JSONWriter::JSONWriter(File& Output, Style Style)
+	: m_Style(Style)
+	, m_File(&Output)
+{
+	m_Containers.reserve(16);
+	m_Buffer.reserve(FileChunkSize);
+}
+
+void JSONWriter::BeginObject()
+{
+	BeginContainer(false, '{');
+}
+
+void JSONWriter::EndObject()
+{
+	BD_ASSERT(!m_Containers.empty() && !m_Containers.back().IsArray);
+	EndContainer('}');
+}
+
+void JSONWriter::BeginArray()
+{
+	BeginContainer(true, '[');
+}
+
+void JSONWriter::EndArray()
+{
+	BD_ASSERT(!m_Containers.empty() && m_Containers.back().IsArray);
+	EndContainer(']');
+}
+
+void JSONWriter::Key(std::string_view Key)
+{
+	BD_ASSERT(!m_Containers.empty() && !m_Containers.back().IsArray && !m_IsAfterKey);
+
+	auto& Container = m_Containers.back();
+	if (!Container.IsEmpty)
+		Write(",");
+	Container.IsEmpty = false;
+	if (m_Style == Style::Indented)
+		WriteNewLineAndIndent(m_Containers.size());
+
+	Write("\"");
+	WriteEscaped(Key);
+	Write(m_Style == Style::Indented ? "\": " : "\":");
+
+	m_IsAfterKey = true;
+}
+
+void JSONWriter::Null()
+{
+	BeginValue();
+	Write("null");
+	FlushIfFull();
+}
+
+void JSONWriter::Bool(bool Value)
+{
+	BeginValue();
+	Write(Value ? "true" : "false");
+	FlushIfFull();
+}
+
+void JSONWriter::Int(int64_t Value)
+{
+	BeginValue();
+
+	std::array<char, 24> Characters;
+	auto [End, Error] = std::to_chars(Characters.data(), Characters.data() + Characters.size(), Value);
+	Write({ Characters.data(), End });
+	FlushIfFull();
+}
+
+void JSONWriter::UInt(uint64_t Value)
+{
+	BeginValue();
+
+	std::array<char, 24> Characters;
+	auto [End, Error] = std::to_chars(Characters.data(), Characters.data() + Characters.size(), Value);
+	Write({ Characters.data(), End });
+	FlushIfFull();
+}
+
+void JSONWriter::Float(double Value)
+{
+	BeginValue();
+
+	if (std::isfinite(Value))
+	{
+		std::array<char, 32> Characters;
+		auto* End = FormatFloat(Characters.data(), Value);
+		Write({ Characters.data(), End });
+	}
+	else
+	{
+		Write("null");
+	}
+	FlushIfFull();
+}
+
+void JSONWriter::String(std::string_view Value)
+{
+	BeginValue();
+	Write("\"");
+	WriteEscaped(Value);
+	Write("\"");
+	FlushIfFull();
+}
+
+bool JSONWriter::Finish()
+{
+	BD_ASSERT(m_Containers.empty());
+
+	if (m_File && !m_Buffer.empty())
+	{
+		if (!m_File->Write(reinterpret_cast<const uint8_t*>(m_Buffer.data()), m_Buffer.size()))
+			m_HasWriteFailed = true;
+		m_Buffer.clear();
+	}
+
+	return !m_HasWriteFailed;
+}
+
+std::string JSONWriter::TakeBuffer()
+{
+	BD_ASSERT(!m_File);
+	return std::move(m_Buffer);
+}
+
+void JSONWriter::BeginValue()
+{
+	if (m_IsAfterKey)
+	{
+		m_IsAfterKey = false;
+		return;
+	}
+
+	if (m_Containers.empty())
+		return;
+
+	auto& Container = m_Containers.back();
+	BD_ASSERT(Container.IsArray); // NOTE: a value inside of an object must be preceded by a key
+	if (!Container.IsEmpty)
+		Write(",");
+	Container.IsEmpty = false;
+	if (m_Style == Style::Indented)
+		WriteNewLineAndIndent(m_Containers.size());
+}
+
+void JSONWriter::BeginContainer(bool IsArray, char Opening)
+{
+	BeginValue();
+	Write({ &Opening, 1 });
+	m_Containers.push_back({ .IsArray = IsArray });
+}
+
+void JSONWriter::EndContainer(char Closing)
+{
+	BD_ASSERT(!m_IsAfterKey);
+
+	auto WasEmpty = m_Containers.back().IsEmpty;
+	m_Containers.pop_back();
+
+	// NOTE: empty containers are written as [] and {} in both styles
+	if (!WasEmpty && m_Style == Style::Indented)
+		WriteNewLineAndIndent(m_Containers.size());
+	Write({ &Closing, 1 });
+	FlushIfFull();
+}
+
+void JSONWriter::WriteNewLineAndIndent(size_t Depth)
+{
+	m_Buffer.push_back('\n');
+	m_Buffer.append(Depth * IndentSize, ' ');
+}
+
+void JSONWriter::WriteEscaped(std::string_view Value)
+{
+	static constexpr char HexDigits[] = "0123456789abcdef";
+
+	for (auto Character : Value)
+	{
+		switch (Character)
+		{
+		case '"':
+			Write("\\\"");
+			break;
+		case '\\':
+			Write("\\\\");
+			break;
+		case '\b':
+			Write("\\b");
+			break;
+		case '\f':
+			Write("\\f");
+			break;
+		case '\n':
+			Write("\\n");
+			break;
+		case '\r':
+			Write("\\r");
+			break;
+		case '\t':
+			Write("\\t");
+			break;
+		default:
+			if (static_cast<unsigned char>(Character) <= 0x1F)
+			{
+				char Escaped[] = { '\\', 'u', '0', '0', HexDigits[Character >> 4], HexDigits[Character & 0xF] };
+				Write({ Escaped, sizeof(Escaped) });
+			}
+			else
+			{
+				m_Buffer.push_back(Character);
+			}
+			break;
+		}
+	}
+}
+
+void JSONWriter::Write(std::string_view Data)
+{
+	m_Buffer.append(Data);
+}
+
+void JSONWriter::FlushIfFull()
+{
+	if (!m_File || m_Buffer.size() < FileChunkSize)
+		return;
+
+	if (!m_File->Write(reinterpret_cast<const uint8_t*>(m_Buffer.data()), m_Buffer.size()))
+		m_HasWriteFailed = true;
+	m_Buffer.clear();
+}
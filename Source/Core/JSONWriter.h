@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Platform/File.h"
+
+/*
+ * Streaming JSON writer. The output is either accumulated in a growable buffer or flushed to a file in fixed-size
+ * chunks, so no document tree is ever built. The indented style matches nlohmann::json::dump(4) byte for byte and the
+ * compact style matches dump(), provided that the caller emits object keys in sorted order like nlohmann does. The only
+ * exception are the rare floats for which nlohmann picks a different, equally round-tripping last digit.
+ */
+class JSONWriter
+{
+public:
+	enum class Style
+	{
+		Indented,
+		Compact,
+	};
+
+	explicit JSONWriter(Style Style = Style::Indented);
+
+	JSONWriter(File& Output, Style Style = Style::Indented);
+
+	void BeginObject();
+	void EndObject();
+
+	void BeginArray();
+	void EndArray();
+
+	void Key(std::string_view Key);
+
+	void Null();
+	void Bool(bool Value);
+	void Int(int64_t Value);
+	void UInt(uint64_t Value);
+	void Float(double Value);
+	void String(std::string_view Value);
+
+	/*
+	 * Writes out whatever is still buffered when writing to a file. Returns false if any write to the file has failed.
+	 */
+	bool Finish();
+
+	std::string TakeBuffer();
+
+private:
+	struct Container
+	{
+		bool IsArray = false;
+		bool IsEmpty = true;
+	};
+
+	static constexpr size_t FileChunkSize = 64 * 1024;
+
+	Style m_Style;
+	File* m_File = nullptr;
+	bool m_HasWriteFailed = false;
+
+	std::string m_Buffer;
+	std::vector<Container> m_Containers;
+	bool m_IsAfterKey = false;
+
+	void BeginValue();
+	void BeginContainer(bool IsArray, char Opening);
+	void EndContainer(char Closing);
+
+	void WriteNewLineAndIndent(size_t Depth);
+	void WriteEscaped(std::string_view Value);
+
+	void Write(std::string_view Data);
+	void FlushIfFull();
+};
@@ -41,7 +41,12 @@ std::string Logger::ApplyFormatting(LogLevel Level, std::string_view Message) co
 
 void Logger::Log(LogLevel Level, std::string_view Message)
 {
+	if (!ShouldLog(Level))
+		return;
+
 	auto FormattedMessage = ApplyFormatting(Level, Message);
+
+	std::scoped_lock Lock(m_Mutex);
 	if (m_LogFile)
 		m_LogFile->Write(reinterpret_cast<const uint8_t*>(FormattedMessage.data()), FormattedMessage.length());
 	if (m_LogToStdout)
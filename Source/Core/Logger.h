@@ -2,9 +2,11 @@
 
 #include <format>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 
+#include "Core/AllocationTracker.h"
 #include "Platform/File.h"
 
 enum class LogLevel
@@ -23,19 +25,27 @@ public:
 
 	void Log(LogLevel Level, std::string_view Message);
 
+	bool ShouldLog(LogLevel Level) const { return Level >= m_MinLevel; }
+
 private:
 	LogLevel m_MinLevel;
 	std::unique_ptr<File> m_LogFile;
 	bool m_LogToStdout;
 
+	// NOTE: assets are loaded and the world is autosaved on other threads, so messages can come from anywhere
+	std::mutex m_Mutex;
+
 	std::string ApplyFormatting(LogLevel Level, std::string_view Message) const;
 };
 
 extern std::unique_ptr<Logger> GLogger;
 
-#define BD_LOG_DEBUG(message, ...) { if (GLogger) { auto __Message__ = std::format(message, __VA_ARGS__); GLogger->Log(LogLevel::Debug, __Message__); } }
-#define BD_LOG_INFO(message, ...) { if (GLogger) { auto __Message__ = std::format(message, __VA_ARGS__); GLogger->Log(LogLevel::Info, __Message__); } }
-#define BD_LOG_WARNING(message, ...) { if (GLogger) { auto __Message__ = std::format(message, __VA_ARGS__); GLogger->Log(LogLevel::Warning, __Message__); } }
-#define BD_LOG_ERROR(message, ...) { if (GLogger) { auto __Message__ = std::format(message, __VA_ARGS__); GLogger->Log(LogLevel::Error, __Message__); } }
-#define BD_LOG_FATAL(message, ...) { if (GLogger) { auto __Message__ = std::format(message, __VA_ARGS__); GLogger->Log(LogLevel::Fatal, __Message__); } }
+// NOTE: the message is only formatted if it passes the level filter. Logging is exempt from the allocation-free
+//       simulation checks since it only happens on notable events rather than on every tick.
+
+#define BD_LOG_DEBUG(message, ...) { if (GLogger && GLogger->ShouldLog(LogLevel::Debug)) { ::AllocationTracker::AllowAllocationsScope __AllowAllocations__; auto __Message__ = std::format(message, __VA_ARGS__); GLogger->Log(LogLevel::Debug, __Message__); } }
+#define BD_LOG_INFO(message, ...) { if (GLogger && GLogger->ShouldLog(LogLevel::Info)) { ::AllocationTracker::AllowAllocationsScope __AllowAllocations__; auto __Message__ = std::format(message, __VA_ARGS__); GLogger->Log(LogLevel::Info, __Message__); } }
+#define BD_LOG_WARNING(message, ...) { if (GLogger && GLogger->ShouldLog(LogLevel::Warning)) { ::AllocationTracker::AllowAllocationsScope __AllowAllocations__; auto __Message__ = std::format(message, __VA_ARGS__); GLogger->Log(LogLevel::Warning, __Message__); } }
+#define BD_LOG_ERROR(message, ...) { if (GLogger && GLogger->ShouldLog(LogLevel::Error)) { ::AllocationTracker::AllowAllocationsScope __AllowAllocations__; auto __Message__ = std::format(message, __VA_ARGS__); GLogger->Log(LogLevel::Error, __Message__); } }
+#define BD_LOG_FATAL(message, ...) { if (GLogger && GLogger->ShouldLog(LogLevel::Fatal)) { ::AllocationTracker::AllowAllocationsScope __AllowAllocations__; auto __Message__ = std::format(message, __VA_ARGS__); GLogger->Log(LogLevel::Fatal, __Message__); } }
 
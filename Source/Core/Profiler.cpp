@@ -0,0 +1,145 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <format>
+#include <mutex>
+#include <nlohmann/json.hpp>
+
+#include "Core/Logger.h"
+#include "Platform/File.h"
+
+using namespace nlohmann;
+
+namespace ProfilerInternal
+{
+	std::mutex GRegistryMutex;
+	std::vector<std::unique_ptr<ProfilerThreadBuffer>> GThreadBuffers;
+	std::atomic<uint32_t> GNextThreadID = 0;
+
+	const Time::Point GEpoch = Time::Now();
+
+	thread_local ProfilerThreadBuffer* GCurrentThreadBuffer = nullptr;
+
+	double ToMicroseconds(Time::Point Ticks)
+	{
+		return static_cast<double>(Ticks) * 1'000'000.0 / static_cast<double>(Time::Frequency());
+	}
+}
+
+ProfilerThreadBuffer::ProfilerThreadBuffer(uint32_t ThreadID, std::string ThreadName)
+	: m_ThreadID(ThreadID)
+	, m_ThreadName(std::move(ThreadName))
+	, m_Zones(std::make_unique<ProfilerZone[]>(Capacity))
+{
+}
+
+void ProfilerThreadBuffer::Record(const ProfilerZone& Zone)
+{
+	auto Index = m_WriteIndex.load(std::memory_order_relaxed);
+	m_Zones[Index % Capacity] = Zone;
+	m_WriteIndex.store(Index + 1, std::memory_order_release);
+}
+
+std::vector<ProfilerZone> ProfilerThreadBuffer::Snapshot() const
+{
+	auto End = m_WriteIndex.load(std::memory_order_acquire);
+	auto Begin = (End > Capacity ? End - Capacity : 0);
+
+	std::vector<ProfilerZone> Result;
+	Result.reserve(End - Begin);
+	for (auto Index = Begin; Index < End; Index++)
+		Result.push_back(m_Zones[Index % Capacity]);
+
+	// NOTE: the owning thread keeps recording while we copy, so the zones it wrapped around onto in the
+	//       meantime might be torn and have to be dropped
+	auto EndAfterCopy = m_WriteIndex.load(std::memory_order_acquire);
+	auto FirstIntactIndex = (EndAfterCopy > Capacity ? EndAfterCopy - Capacity : 0);
+	if (FirstIntactIndex > Begin)
+		Result.erase(Result.begin(), Result.begin() + static_cast<ptrdiff_t>(std::min(FirstIntactIndex - Begin, End - Begin)));
+
+	return Result;
+}
+
+void Profiler::SetThreadName(std::string_view Name)
+{
+	auto& Buffer = ThreadBuffer();
+
+	std::scoped_lock Lock(ProfilerInternal::GRegistryMutex);
+	Buffer.SetThreadName(std::string(Name));
+}
+
+void Profiler::Record(const ProfilerZone& Zone)
+{
+	ThreadBuffer().Record(Zone);
+}
+
+bool Profiler::ExportChromeTrace(std::string_view Path)
+{
+	if (!IsEnabled())
+		BD_LOG_WARNING("Exporting a Chrome trace from a build without BD_ENABLE_PROFILER, the trace will be empty");
+
+	json Events = json::array();
+	{
+		std::scoped_lock Lock(ProfilerInternal::GRegistryMutex);
+		for (const auto& Buffer : ProfilerInternal::GThreadBuffers)
+		{
+			Events.push_back({
+				{ "name", "thread_name" },
+				{ "ph", "M" },
+				{ "pid", 0 },
+				{ "tid", Buffer->ThreadID() },
+				{ "args", { { "name", Buffer->ThreadName() } } }
+			});
+
+			for (const auto& Zone : Buffer->Snapshot())
+			{
+				Events.push_back({
+					{ "name", Zone.Name },
+					{ "cat", "BD" },
+					{ "ph", "X" },
+					{ "ts", ProfilerInternal::ToMicroseconds(Zone.Start - ProfilerInternal::GEpoch) },
+					{ "dur", ProfilerInternal::ToMicroseconds(Zone.End - Zone.Start) },
+					{ "pid", 0 },
+					{ "tid", Buffer->ThreadID() }
+				});
+			}
+		}
+	}
+
+	json Root;
+	Root["traceEvents"] = std::move(Events);
+	Root["displayTimeUnit"] = "ms";
+	auto Contents = Root.dump();
+
+	auto File = FileSystem::Open(Path, FileSystem::OpenMode::CreateNew, FileSystem::AccessMode::ReadWrite);
+	if (!File || !File->Write(reinterpret_cast<const uint8_t*>(Contents.data()), Contents.size()))
+	{
+		BD_LOG_ERROR("Could not write Chrome trace to {}", Path);
+		return false;
+	}
+
+	BD_LOG_INFO("Exported Chrome trace with {} events to {}", Root["traceEvents"].size(), Path);
+	return true;
+}
+
+bool Profiler::IsEnabled()
+{
+#ifdef BD_ENABLE_PROFILER
+	return true;
+#else
+	return false;
+#endif
+}
+
+ProfilerThreadBuffer& Profiler::ThreadBuffer()
+{
+	if (!ProfilerInternal::GCurrentThreadBuffer)
+	{
+		auto ThreadID = ProfilerInternal::GNextThreadID++;
+
+		std::scoped_lock Lock(ProfilerInternal::GRegistryMutex);
+		ProfilerInternal::GThreadBuffers.push_back(std::make_unique<ProfilerThreadBuffer>(ThreadID, std::format("Thread {}", ThreadID)));
+		ProfilerInternal::GCurrentThreadBuffer = ProfilerInternal::GThreadBuffers.back().get();
+	}
+	return *ProfilerInternal::GCurrentThreadBuffer;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Platform/Time.h"
+
+struct ProfilerZone
+{
+	const char* Name = nullptr;
+	Time::Point Start = 0;
+	Time::Point End = 0;
+};
+
+/*
+ * Fixed size ring buffer of zones recorded by a single thread. Only the owning thread writes to it, so recording a
+ * zone is a plain store followed by a release increment of the write index. When the buffer is full the oldest
+ * zones are overwritten.
+ */
+class ProfilerThreadBuffer
+{
+public:
+	static constexpr size_t Capacity = 1 << 16;
+
+	ProfilerThreadBuffer(uint32_t ThreadID, std::string ThreadName);
+
+	void Record(const ProfilerZone& Zone);
+
+	std::vector<ProfilerZone> Snapshot() const;
+
+	uint32_t ThreadID() const { return m_ThreadID; }
+	const std::string& ThreadName() const { return m_ThreadName; }
+	void SetThreadName(std::string Name) { m_ThreadName = std::move(Name); }
+
+private:
+	uint32_t m_ThreadID;
+	std::string m_ThreadName;
+
+	std::unique_ptr<ProfilerZone[]> m_Zones;
+	std::atomic<uint64_t> m_WriteIndex = 0;
+};
+
+class Profiler
+{
+public:
+	/*
+	 * Gives the calling thread a readable name in the exported trace.
+	 */
+	static void SetThreadName(std::string_view Name);
+
+	static void Record(const ProfilerZone& Zone);
+
+	/*
+	 * Writes every zone that is still in the ring buffers into a JSON file that can be opened with
+	 * chrome://tracing or ui.perfetto.dev.
+	 */
+	static bool ExportChromeTrace(std::string_view Path);
+
+	static bool IsEnabled();
+
+private:
+	static ProfilerThreadBuffer& ThreadBuffer();
+};
+
+class ProfilerScope
+{
+public:
+	explicit ProfilerScope(const char* Name)
+		: m_Name(Name)
+		, m_Start(Time::Now())
+	{
+	}
+
+	~ProfilerScope()
+	{
+		Profiler::Record({ .Name = m_Name, .Start = m_Start, .End = Time::Now() });
+	}
+
+	ProfilerScope(const ProfilerScope&) = delete;
+	ProfilerScope& operator=(const ProfilerScope&) = delete;
+
+private:
+	const char* m_Name;
+	Time::Point m_Start;
+};
+
+#define BD_PROFILER_CONCAT_INTERNAL(A, B) A##B
+#define BD_PROFILER_CONCAT(A, B) BD_PROFILER_CONCAT_INTERNAL(A, B)
+
+// NOTE: the name has to outlive the profiler, so only string literals should be passed here
+#ifdef BD_ENABLE_PROFILER
+#define BD_PROFILE_SCOPE(name) ::ProfilerScope BD_PROFILER_CONCAT(__ProfilerScope__, __LINE__)(name)
+#define BD_PROFILE_FUNCTION() BD_PROFILE_SCOPE(__FUNCTION__)
+#else
+#define BD_PROFILE_SCOPE(name)
+#define BD_PROFILE_FUNCTION()
+#endif
@@ -27,4 +27,12 @@ struct Rect2D
 	{
 		return Position.x >= Min.x && Position.x <= Max.x && Position.y >= Min.y && Position.y <= Max.y;
 	}
+
+	/*
+	 * Rects that only share an edge do not intersect.
+	 */
+	constexpr bool Intersects(const Rect2D& Other) const
+	{
+		return Min.x < Other.Max.x && Other.Min.x < Max.x && Min.y < Other.Max.y && Other.Min.y < Max.y;
+	}
 };
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <vector>
+
+#include "Core/Rect2D.h"
+
+/*
+ * Buckets items into the square cells of a uniform grid by their position, so that the items in an area are found by
+ * visiting only the cells that overlap it rather than every item.
+ */
+template<typename ItemType>
+class SpatialGrid
+{
+public:
+	explicit SpatialGrid(float CellSize = 16.0f)
+		: m_CellSize(CellSize)
+	{
+	}
+
+	void Clear() { m_Cells.clear(); }
+
+	void Insert(glm::vec2 Position, const ItemType& Item)
+	{
+		m_Cells[CellKey(CellOf(Position))].push_back(Item);
+	}
+
+	/*
+	 * Calls Callback(const ItemType& Item) for the items of every cell that overlaps Area, which includes items that
+	 * are close to, but outside of Area. The cost depends on the number of cells in Area, not on the number of items.
+	 */
+	template<typename CallbackType>
+	void ForEachInArea(const Rect2D& Area, CallbackType&& Callback) const
+	{
+		auto MinCell = CellOf(Area.Min);
+		auto MaxCell = CellOf(Area.Max);
+		for (auto Y = MinCell.y; Y <= MaxCell.y; Y++)
+		{
+			for (auto X = MinCell.x; X <= MaxCell.x; X++)
+			{
+				auto It = m_Cells.find(CellKey({ X, Y }));
+				if (It == m_Cells.end())
+					continue;
+
+				for (const auto& Item : It->second)
+					Callback(Item);
+			}
+		}
+	}
+
+	glm::ivec2 CellOf(glm::vec2 Position) const
+	{
+		return { static_cast<int32_t>(std::floor(Position.x / m_CellSize)), static_cast<int32_t>(std::floor(Position.y / m_CellSize)) };
+	}
+
+private:
+	float m_CellSize;
+	std::unordered_map<uint64_t, std::vector<ItemType>> m_Cells;
+
+	static uint64_t CellKey(glm::ivec2 Cell)
+	{
+		return (static_cast<uint64_t>(static_cast<uint32_t>(Cell.x)) << 32) | static_cast<uint32_t>(Cell.y);
+	}
+};
@@ -2,6 +2,7 @@
 
 #include <numeric>
 
+#include "Core/Profiler.h"
 #include "UI/Containers/StackContainer.h"
 #include "UI/Widgets/Button.h"
 #include "UI/Widgets/Image.h"
@@ -95,6 +96,8 @@ bool GameUILayer::OnMouseScroll(int32_t Offset, const InputState& InputState, Wo
 
 void GameUILayer::Update(float DeltaTime, const InputState& InputState, World& World, Rect2D UsableArea)
 {
+	BD_PROFILE_FUNCTION();
+
 	Layer::Update(DeltaTime, InputState, World, UsableArea);
 
 	m_CurrentWorld = &World;
@@ -116,17 +119,32 @@ void GameUILayer::Update(float DeltaTime, const InputState& InputState, World& W
 
 void GameUILayer::Render(Renderer& Renderer, const World& World) const
 {
+	BD_PROFILE_FUNCTION();
+
 	Layer::Render(Renderer, World);
 
 	Renderer.SetViewProjectionMatrix(glm::mat4(1.0f));
 
-	RenderBuffer RenderBuffer(Renderer);
-	m_RootWidget->Render(RenderBuffer);
+	m_RootWidget->Render(*m_RenderBuffer);
+	m_RenderBuffer->Flush();
+}
+
+void GameUILayer::LoadAssets(AssetLoader& Loader, AssetRegistry& Registry, Assets& Assets)
+{
+	Registry.LoadFontAsync(Loader, "Resources/Fonts/RobotoRegular.json", Assets.UIFont);
+	Registry.LoadFontAsync(Loader, "Resources/Fonts/ConsolaMono.json", Assets.MonospaceFont);
+
+	Registry.LoadTextureAsync(Loader, "Resources/UI/pause.png", Assets.PauseIcon);
+	Registry.LoadTextureAsync(Loader, "Resources/UI/play1.png", Assets.PlayIcon);
+	Registry.LoadTextureAsync(Loader, "Resources/UI/play2.png", Assets.Speed1Icon);
+	Registry.LoadTextureAsync(Loader, "Resources/UI/play3.png", Assets.Speed2Icon);
+	Registry.LoadTextureAsync(Loader, "Resources/UI/score.png", Assets.ScoreIcon);
 }
 
-GameUILayer::GameUILayer()
+GameUILayer::GameUILayer(Renderer& Renderer, Assets Assets)
+	: m_RenderBuffer(std::make_unique<RenderBuffer>(Renderer))
 {
-	m_UIFont = Font::Load("Resources/Fonts/RobotoRegular.json");
+	m_UIFont = std::move(Assets.UIFont);
 
 	auto RootContainer = StackContainer::Create(StackContainer::Direction::Vertical);
 	RootContainer->Style().LeftMargin = RootContainer->Style().RightMargin = RootContainer->Style().TopMargin = RootContainer->Style().BottomMargin = Size1D::Absolute(8.0f);
@@ -134,14 +152,14 @@ GameUILayer::GameUILayer()
 	auto GameSpeedAndScoreContainer = StackContainer::Create(StackContainer::Direction::Horizontal);
 	GameSpeedAndScoreContainer->Style().HorizontalStretchRatio = 1.0f;
 
-	auto GameSpeedPanel = CreateGameSpeedPanel();
+	auto GameSpeedPanel = CreateGameSpeedPanel(Assets);
 	GameSpeedAndScoreContainer->AddChild(std::move(GameSpeedPanel));
 
 	auto GameSpeedAndScoreContainerLeftSpacer = Widget::Create();
 	GameSpeedAndScoreContainerLeftSpacer->Style().HorizontalStretchRatio = 1.0f;
 	GameSpeedAndScoreContainer->AddChild(std::move(GameSpeedAndScoreContainerLeftSpacer));
 
-	auto GameScorePanel = CreateGameScorePanel();
+	auto GameScorePanel = CreateGameScorePanel(Assets);
 	GameSpeedAndScoreContainer->AddChild(std::move(GameScorePanel));
 
 	auto GameSpeedAndScoreContainerRightSpacer = Widget::Create();
@@ -162,16 +180,15 @@ GameUILayer::GameUILayer()
 	m_RootWidget = std::move(RootContainerWrapper);
 }
 
-std::unique_ptr<Widget> GameUILayer::CreateGameSpeedPanel()
+std::unique_ptr<Widget> GameUILayer::CreateGameSpeedPanel(Assets& Assets)
 {
 	auto Container = StackContainer::Create(StackContainer::Direction::Horizontal);
 	Container->Spacing() = 8.0f;
 
-	auto Font = Font::Load("Resources/Fonts/ConsolaMono.json");
-	std::shared_ptr TimeLabel = Label::Create("", 26, Font);
+	std::shared_ptr TimeLabel = Label::Create("", 26, Assets.MonospaceFont);
 	m_GameTimeLabel = TimeLabel;
 
-	auto PauseButton = Button::Create(Image::LoadFromFile("Resources/UI/pause.png"), [this](bool IsPress)
+	auto PauseButton = Button::Create(Image::Create(std::move(Assets.PauseIcon)), [this](bool IsPress)
 	{
 		if (IsPress)
 		{
@@ -180,7 +197,7 @@ std::unique_ptr<Widget> GameUILayer::CreateGameSpeedPanel()
 		}
 	});
 	
-	auto PlayButton = Button::Create(Image::LoadFromFile("Resources/UI/play1.png"), [this](bool IsPress)
+	auto PlayButton = Button::Create(Image::Create(std::move(Assets.PlayIcon)), [this](bool IsPress)
 	{
 		if (IsPress)
 		{
@@ -189,7 +206,7 @@ std::unique_ptr<Widget> GameUILayer::CreateGameSpeedPanel()
 		}
 	});
 
-	auto Speed1Button = Button::Create(Image::LoadFromFile("Resources/UI/play2.png"), [this](bool IsPress)
+	auto Speed1Button = Button::Create(Image::Create(std::move(Assets.Speed1Icon)), [this](bool IsPress)
 	{
 		if (IsPress)
 		{
@@ -198,7 +215,7 @@ std::unique_ptr<Widget> GameUILayer::CreateGameSpeedPanel()
 		}
 	});
 
-	auto Speed2Button = Button::Create(Image::LoadFromFile("Resources/UI/play3.png"), [this](bool IsPress)
+	auto Speed2Button = Button::Create(Image::Create(std::move(Assets.Speed2Icon)), [this](bool IsPress)
 	{
 		if (IsPress)
 		{
@@ -222,7 +239,7 @@ std::unique_ptr<Widget> GameUILayer::CreateGameSpeedPanel()
 	return Container;
 }
 
-std::shared_ptr<Widget> GameUILayer::CreateGameScorePanel()
+std::shared_ptr<Widget> GameUILayer::CreateGameScorePanel(Assets& Assets)
 {
 	auto Container = StackContainer::Create(StackContainer::Direction::Horizontal);
 	Container->Style().BackgroundColor = glm::vec4(0.21f, 0.21f, 0.18f, 1.0f);
@@ -232,7 +249,7 @@ std::shared_ptr<Widget> GameUILayer::CreateGameScorePanel()
 	Container->Style().PaddingLeft = Container->Style().PaddingRight = 6.0f;
 	Container->Spacing() = 6.0f;
 
-	auto Icon = Image::LoadFromFile("Resources/UI/score.png");
+	auto Icon = Image::Create(std::move(Assets.ScoreIcon));
 	Container->AddChild(std::move(Icon));
 
 	constexpr auto GameScoreLabelFontSize = 28u;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Core/AssetRegistry.h"
 #include "Layer/Layer.h"
 #include "UI/Widget.h"
 #include "UI/Containers/TableContainer.h"
@@ -8,7 +9,25 @@
 class GameUILayer : public Layer
 {
 public:
-	GameUILayer();
+	struct Assets
+	{
+		std::shared_ptr<Font> UIFont;
+		std::shared_ptr<Font> MonospaceFont;
+
+		std::shared_ptr<Texture> PauseIcon;
+		std::shared_ptr<Texture> PlayIcon;
+		std::shared_ptr<Texture> Speed1Icon;
+		std::shared_ptr<Texture> Speed2Icon;
+		std::shared_ptr<Texture> ScoreIcon;
+	};
+
+	/*
+	 * Requests everything the layer needs from the loader. The assets are ready to be passed to the constructor once
+	 * the loader finishes.
+	 */
+	static void LoadAssets(AssetLoader& Loader, AssetRegistry& Registry, Assets& Assets);
+
+	GameUILayer(Renderer& Renderer, Assets Assets);
 
 	virtual bool OnMousePress(MouseButton::Button Button, const InputState& InputState, World& World) override;
 
@@ -22,14 +41,15 @@ public:
 
 private:
 	std::unique_ptr<Widget> m_RootWidget;
+	std::unique_ptr<RenderBuffer> m_RenderBuffer;
 	World* m_CurrentWorld = nullptr;
 
 	std::shared_ptr<Label> m_GameTimeLabel;
 	std::shared_ptr<Label> m_GameScoreLabel;
 	TableContainer* m_TimetablePanel = nullptr;
 
-	std::unique_ptr<Widget> CreateGameSpeedPanel();
-	std::shared_ptr<Widget> CreateGameScorePanel();
+	std::unique_ptr<Widget> CreateGameSpeedPanel(Assets& Assets);
+	std::shared_ptr<Widget> CreateGameScorePanel(Assets& Assets);
 	std::unique_ptr<Widget> CreateTimetablePanel();
 
 	std::shared_ptr<Font> m_UIFont;
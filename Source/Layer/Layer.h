@@ -16,6 +16,8 @@ public:
 
 	virtual bool OnMouseScroll(int32_t Offset, const InputState& InputState, World& World) { return false; }
 
+	virtual bool OnKeyPress(Key::Key Key, const InputState& InputState, World& World) { return false; }
+
 	virtual void Update(float DeltaTime, const InputState& InputState, World& World, Rect2D UsableArea) {}
 
 	virtual void Render(Renderer& Renderer, const World& World) const {};
@@ -0,0 +1,163 @@
+#include "PerformanceHUDLayer.h"
+
+#include <algorithm>
+#include <format>
+
+#include "Core/Profiler.h"
+#include "UI/Containers/StackContainer.h"
+#include "UI/Widgets/Panel.h"
+
+static constexpr Key::Key ToggleKey = Key::F3;
+
+static constexpr size_t FrameTimeGraphSampleCount = 240;
+static constexpr float TargetFrameTime = 1.0f / 60.0f;
+static constexpr float MinFrameTimeGraphRange = 2.0f * TargetFrameTime;
+
+static std::string FormatBytes(uint64_t Bytes)
+{
+	if (Bytes >= 1024 * 1024)
+		return std::format("{:.1f} MiB", static_cast<double>(Bytes) / (1024.0 * 1024.0));
+	if (Bytes >= 1024)
+		return std::format("{:.1f} KiB", static_cast<double>(Bytes) / 1024.0);
+	return std::format("{} B", Bytes);
+}
+
+bool PerformanceHUDLayer::OnKeyPress(Key::Key Key, const InputState&, World&)
+{
+	if (Key != ToggleKey)
+		return false;
+
+	m_IsVisible = !m_IsVisible;
+	return true;
+}
+
+void PerformanceHUDLayer::Update(float DeltaTime, const InputState& InputState, World& World, Rect2D UsableArea)
+{
+	Layer::Update(DeltaTime, InputState, World, UsableArea);
+
+	// NOTE: the graph keeps collecting samples while hidden so that it shows the recent history as soon as it is toggled on
+	const auto& Stats = GFrameStats.Previous();
+	m_FrameTimeGraph->AddSample(Stats.FrameTime);
+
+	if (!m_IsVisible)
+		return;
+
+	BD_PROFILE_FUNCTION();
+
+	m_FrameTimeGraph->MaxValue() = std::max(MinFrameTimeGraphRange, m_FrameTimeGraph->LargestSample());
+
+	auto FramesPerSecond = Stats.FrameTime > 0.0f ? 1.0f / Stats.FrameTime : 0.0f;
+	m_FrameTimeLabel->Text() = std::format("Frame      {:6.2f} ms {:5.0f} FPS", Stats.FrameTime * 1000.0f, FramesPerSecond);
+
+	for (size_t Phase = 0; Phase < m_PhaseTimeLabels.size(); Phase++)
+	{
+		m_PhaseTimeLabels[Phase]->Text() = std::format("{:<10} {:6.2f} ms {:>6} allocs {:>8}", FramePhaseToString(static_cast<FramePhase>(Phase)),
+			Stats.PhaseTimes[Phase] * 1000.0f, Stats.PhaseAllocations[Phase], FormatBytes(Stats.PhaseAllocatedBytes[Phase]));
+	}
+
+	m_SimulationTicksLabel->Text() = std::format("Sim ticks     {:>8}", Stats.SimulationTicks);
+	m_LineVerticesLabel->Text() = std::format("Line verts    {:>8} {:>8} peak", Stats.LineVertices, GFrameStats.LineVerticesHighWaterMark());
+	m_LineBufferLabel->Text() = std::format("Line buffer   {:>8} {:>8} overflows", Stats.LineVertexCapacity, Stats.LineOverflowFlushes);
+	m_DrawCallsLabel->Text() = std::format("Draw calls    {:>8}", Stats.DrawCalls);
+	m_UIDrawCallsLabel->Text() = std::format("UI draws      {:>8} {:>8} verts", Stats.UIDrawCalls, Stats.UIVertices);
+	m_StateChangesLabel->Text() = std::format("GL state      {:>8} {:>8} elided", Stats.StateChanges, Stats.ElidedStateChanges);
+	m_TextureBindsLabel->Text() = std::format("Texture binds {:>8}", Stats.TextureBinds);
+	m_TrackSegmentUploadsLabel->Text() = std::format("Track uploads {:>8}", Stats.TrackSegmentUploads);
+	m_BufferCreationsLabel->Text() = std::format("GL buffers    {:>8}", Stats.BufferCreations);
+	m_AllocationsLabel->Text() = std::format("Allocations   {:>8} {:>8}", Stats.Allocations, FormatBytes(Stats.AllocatedBytes));
+
+	m_RootWidget->BoundingBox() = UsableArea;
+	m_RootWidget->Layout();
+}
+
+void PerformanceHUDLayer::Render(Renderer& Renderer, const World& World) const
+{
+	if (!m_IsVisible)
+		return;
+
+	BD_PROFILE_FUNCTION();
+
+	Layer::Render(Renderer, World);
+
+	Renderer.SetViewProjectionMatrix(glm::mat4(1.0f));
+
+	m_RootWidget->Render(*m_RenderBuffer);
+	m_RenderBuffer->Flush();
+}
+
+void PerformanceHUDLayer::LoadAssets(AssetLoader& Loader, AssetRegistry& Registry, Assets& Assets)
+{
+	Registry.LoadFontAsync(Loader, "Resources/Fonts/ConsolaMono.json", Assets.Font);
+}
+
+PerformanceHUDLayer::PerformanceHUDLayer(Renderer& Renderer, Assets Assets)
+	: m_RenderBuffer(std::make_unique<RenderBuffer>(Renderer))
+{
+	m_Font = std::move(Assets.Font);
+
+	auto StatsContainer = StackContainer::Create(StackContainer::Direction::Vertical);
+	StatsContainer->Style().BackgroundColor = glm::vec4(0.21f, 0.21f, 0.18f, 0.9f);
+	StatsContainer->Style().BorderColor = glm::vec4(0.37f, 0.37f, 0.33f, 1.0f);
+	StatsContainer->Style().BorderThickness = 4.0f;
+	StatsContainer->Style().CornerRadius = 6.0f;
+	StatsContainer->Style().PaddingLeft = StatsContainer->Style().PaddingRight = 6.0f;
+	StatsContainer->Style().PaddingTop = StatsContainer->Style().PaddingBottom = 6.0f;
+	StatsContainer->Spacing() = 2.0f;
+
+	m_FrameTimeLabel = CreateLabel();
+	StatsContainer->AddChild(m_FrameTimeLabel);
+
+	m_FrameTimeGraph = Graph::Create(FrameTimeGraphSampleCount, { 240.0f, 64.0f }, glm::vec4(0.36f, 0.85f, 0.36f, 1.0f));
+	m_FrameTimeGraph->MarkerValue() = TargetFrameTime;
+	m_FrameTimeGraph->Style().BackgroundColor = glm::vec4(0.12f, 0.12f, 0.1f, 1.0f);
+	StatsContainer->AddChild(m_FrameTimeGraph);
+
+	for (auto& PhaseTimeLabel : m_PhaseTimeLabels)
+	{
+		PhaseTimeLabel = CreateLabel();
+		StatsContainer->AddChild(PhaseTimeLabel);
+	}
+
+	m_SimulationTicksLabel = CreateLabel();
+	m_LineVerticesLabel = CreateLabel();
+	m_LineBufferLabel = CreateLabel();
+	m_DrawCallsLabel = CreateLabel();
+	m_UIDrawCallsLabel = CreateLabel();
+	m_StateChangesLabel = CreateLabel();
+	m_TextureBindsLabel = CreateLabel();
+	m_TrackSegmentUploadsLabel = CreateLabel();
+	m_BufferCreationsLabel = CreateLabel();
+	m_AllocationsLabel = CreateLabel();
+	StatsContainer->AddChild(m_SimulationTicksLabel);
+	StatsContainer->AddChild(m_LineVerticesLabel);
+	StatsContainer->AddChild(m_LineBufferLabel);
+	StatsContainer->AddChild(m_DrawCallsLabel);
+	StatsContainer->AddChild(m_UIDrawCallsLabel);
+	StatsContainer->AddChild(m_StateChangesLabel);
+	StatsContainer->AddChild(m_TextureBindsLabel);
+	StatsContainer->AddChild(m_TrackSegmentUploadsLabel);
+	StatsContainer->AddChild(m_BufferCreationsLabel);
+	StatsContainer->AddChild(m_AllocationsLabel);
+
+	auto TopRowContainer = StackContainer::Create(StackContainer::Direction::Horizontal);
+
+	auto TopRowSpacer = Widget::Create();
+	TopRowSpacer->Style().HorizontalStretchRatio = 1.0f;
+	TopRowContainer->AddChild(std::move(TopRowSpacer));
+	TopRowContainer->AddChild(std::move(StatsContainer));
+
+	auto RootContainer = StackContainer::Create(StackContainer::Direction::Vertical);
+	RootContainer->Style().LeftMargin = RootContainer->Style().RightMargin = RootContainer->Style().TopMargin = RootContainer->Style().BottomMargin = Size1D::Absolute(8.0f);
+	RootContainer->AddChild(std::move(TopRowContainer));
+
+	auto BottomSpacer = Widget::Create();
+	BottomSpacer->Style().VerticalStretchRatio = 1.0f;
+	RootContainer->AddChild(std::move(BottomSpacer));
+
+	m_RootWidget = Panel::Create(std::move(RootContainer));
+}
+
+std::shared_ptr<Label> PerformanceHUDLayer::CreateLabel()
+{
+	return Label::Create("", m_FontSize, m_Font, TextAlignment::Begin);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+
+#include "Core/AssetRegistry.h"
+#include "Core/FrameStats.h"
+#include "Layer/Layer.h"
+#include "UI/Widget.h"
+#include "UI/Widgets/Graph.h"
+#include "UI/Widgets/Label.h"
+
+/*
+ * Overlay with the frame time graph, per phase timings and per frame renderer/simulation counters of the
+ * previous frame. Hidden by default and toggled with F3. Note that while it is visible, the HUD's own text
+ * formatting and drawing are included in the numbers it shows.
+ */
+class PerformanceHUDLayer : public Layer
+{
+public:
+	struct Assets
+	{
+		std::shared_ptr<Font> Font;
+	};
+
+	/*
+	 * Requests everything the layer needs from the loader. The assets are ready to be passed to the constructor once
+	 * the loader finishes.
+	 */
+	static void LoadAssets(AssetLoader& Loader, AssetRegistry& Registry, Assets& Assets);
+
+	PerformanceHUDLayer(Renderer& Renderer, Assets Assets);
+
+	virtual bool OnKeyPress(Key::Key Key, const InputState& InputState, World& World) override;
+
+	virtual void Update(float DeltaTime, const InputState& InputState, World& World, Rect2D UsableArea) override;
+
+	virtual void Render(Renderer& Renderer, const World& World) const override;
+
+private:
+	bool m_IsVisible = false;
+
+	std::unique_ptr<Widget> m_RootWidget;
+	std::unique_ptr<RenderBuffer> m_RenderBuffer;
+
+	std::shared_ptr<Label> m_FrameTimeLabel;
+	std::shared_ptr<Graph> m_FrameTimeGraph;
+	std::array<std::shared_ptr<Label>, static_cast<size_t>(FramePhase::Count_)> m_PhaseTimeLabels;
+	std::shared_ptr<Label> m_SimulationTicksLabel;
+	std::shared_ptr<Label> m_LineVerticesLabel;
+	std::shared_ptr<Label> m_LineBufferLabel;
+	std::shared_ptr<Label> m_DrawCallsLabel;
+	std::shared_ptr<Label> m_UIDrawCallsLabel;
+	std::shared_ptr<Label> m_StateChangesLabel;
+	std::shared_ptr<Label> m_TextureBindsLabel;
+	std::shared_ptr<Label> m_TrackSegmentUploadsLabel;
+	std::shared_ptr<Label> m_BufferCreationsLabel;
+	std::shared_ptr<Label> m_AllocationsLabel;
+
+	std::shared_ptr<Font> m_Font;
+	uint32_t m_FontSize = 16;
+
+	std::shared_ptr<Label> CreateLabel();
+};
@@ -1,7 +1,10 @@
 #include "TrackLayer.h"
 
 #include <algorithm>
+#include <array>
+#include <numeric>
 
+#include "Core/Profiler.h"
 #include "Core/Transform.h"
 
 static constexpr float DefaultPixelsPerMeter = 64.0f;
@@ -44,19 +47,20 @@ static glm::mat4 TransformationMatrixForSignal(const Signal& Signal)
 	return TransformationMatrix(Position, Angle);
 }
 
-std::unique_ptr<TrackLayer> TrackLayer::Create()
+void TrackLayer::LoadAssets(AssetLoader& Loader, AssetRegistry& Registry, Assets& Assets)
 {
-	auto Result = std::unique_ptr<TrackLayer>(new TrackLayer);
+	Registry.LoadVectorIconAsync(Loader, SignalStateClearIconPath, Assets.SignalClearIcon);
+	Registry.LoadVectorIconAsync(Loader, SignalStateDangerIconPath, Assets.SignalDangerIcon);
+}
 
-	auto SignalStateClearIcon = VectorIcon::LoadFromFile(SignalStateClearIconPath);
-	if (!SignalStateClearIcon)
+std::unique_ptr<TrackLayer> TrackLayer::Create(Assets Assets)
+{
+	if (!Assets.SignalClearIcon || !Assets.SignalDangerIcon)
 		return nullptr;
-	Result->m_SignalIcons[SignalState::Clear] = std::move(SignalStateClearIcon);
 
-	auto SignalStateDangerIcon = VectorIcon::LoadFromFile(SignalStateDangerIconPath);
-	if (!SignalStateDangerIcon)
-		return nullptr;
-	Result->m_SignalIcons[SignalState::Danger] = std::move(SignalStateDangerIcon);
+	auto Result = std::unique_ptr<TrackLayer>(new TrackLayer);
+	Result->m_SignalIcons[SignalState::Clear] = std::move(Assets.SignalClearIcon);
+	Result->m_SignalIcons[SignalState::Danger] = std::move(Assets.SignalDangerIcon);
 
 	return Result;
 }
@@ -102,35 +106,50 @@ void TrackLayer::Update(float DeltaTime, const InputState& InputState, World& Wo
 
 void TrackLayer::Render(Renderer& Renderer, const World& World) const
 {
+	BD_PROFILE_FUNCTION();
+
 	auto ViewMatrix = glm::mat4(1.0f);
 	ViewMatrix = glm::scale(ViewMatrix, glm::vec3(PixelsPerMeter()));
 	ViewMatrix = glm::translate(ViewMatrix, -glm::vec3(m_CameraLocation, 0.0f));
 
-	auto ProjectionMatrix = glm::mat4();
+	auto ProjectionMatrix = glm::mat4(1.0f);
 	ProjectionMatrix[0][0] = 2.0f / Renderer.FramebufferSize().x;
 	ProjectionMatrix[1][1] = 2.0f / Renderer.FramebufferSize().y;
-	ProjectionMatrix[3][3] = 1.0f;
 
 	Renderer.SetViewProjectionMatrix(ProjectionMatrix * ViewMatrix);
 
-	std::ranges::for_each(World.TrackTiles(), [&](const auto& TrackPiece) { RenderTrackTile(Renderer, World, TrackPiece); });
-	std::ranges::for_each(World.Signals(), [&](const auto& Signal) { RenderSignal(Renderer, Signal); });
+	if (m_LayoutRevision != World.LayoutRevision())
+	{
+		RebuildTrackMesh(World);
+		RebuildSignalGrid(World);
+		m_LayoutRevision = World.LayoutRevision();
+	}
+	else if (m_TrackMesh)
+	{
+		for (auto TileIndex : World.ChangedTrackTiles())
+			UpdateTrackTileSegments(World, TileIndex);
+	}
 
-	// FIXME: this should only be done in debug mode
-	std::ranges::for_each(World.Trains(), [&](const auto& Train) { RenderTrain(Renderer, Train); });
+	auto VisibleArea = VisibleWorldArea(Renderer.FramebufferSize());
 
 #define DRAW_GRID
 #ifdef DRAW_GRID
-	auto FramebufferSize = glm::ivec2(Renderer.FramebufferSize());
-	auto TopLeftTile = WorldPositionToTileCoordinates(CursorPositionToWorldCoordinates(glm::ivec2(0, 0), FramebufferSize));
-	auto BottomRightTile = WorldPositionToTileCoordinates(CursorPositionToWorldCoordinates(FramebufferSize, FramebufferSize));
-
+	// NOTE: the grid lines run along the borders of the tiles
 	constexpr auto GridLineColor = glm::vec4(1.0f);
-	for (auto X = TopLeftTile.x; X <= BottomRightTile.x; X++)
-		Renderer.DrawLine(glm::vec2(X + 0.5f, TopLeftTile.y + 0.5f), glm::vec2(X + 0.5f, BottomRightTile.y - 0.5f), GridLineColor);
-	for (auto Y = BottomRightTile.y; Y <= TopLeftTile.y; Y++)
-		Renderer.DrawLine(glm::vec2(TopLeftTile.x - 0.5f, Y + 0.5f), glm::vec2(BottomRightTile.x + 0.5f, Y + 0.5f), GridLineColor);
+	Renderer.DrawGrid(glm::vec2(0.5f), 1.0f, GridLineColor);
 #endif
+
+	// NOTE: the track is drawn right away while the lines below are batched until the next flush, so it goes after the
+	//       signals to keep them underneath it
+	RenderSignals(Renderer, World, VisibleArea);
+	RenderTrack(Renderer, VisibleArea);
+
+	// FIXME: this should only be done in debug mode
+	for (const auto& Train : World.Trains())
+	{
+		if (VisibleArea.Contains(glm::vec2(Train.Tile)))
+			RenderTrain(Renderer, Train);
+	}
 }
 
 TrackLayer::TrackLayer()
@@ -180,34 +199,132 @@ void TrackLayer::HandleSignalClick(World& World, const Signal& Signal)
 	}
 }
 
-void TrackLayer::RenderTrackTile(Renderer& Renderer, const World& World, const TrackTile& Tile) const
+void TrackLayer::RebuildTrackMesh(const World& World) const
+{
+	BD_PROFILE_FUNCTION();
+
+	auto Tiles = World.TrackTiles();
+	auto CellOfTile = [&](uint32_t TileIndex) { return m_TrackSegmentGrid.CellOf(glm::vec2(Tiles[TileIndex].Tile)); };
+
+	// NOTE: the segments of a cell of the grid are contiguous in the mesh and the cells are laid out row by row, in the
+	//       order SpatialGrid visits them, so the visible cells of a row end up being a single range of segments
+	std::vector<uint32_t> TileOrder(Tiles.size());
+	std::iota(TileOrder.begin(), TileOrder.end(), 0);
+	std::ranges::stable_sort(TileOrder, [&](uint32_t Lhs, uint32_t Rhs)
+	{
+		auto LhsCell = CellOfTile(Lhs);
+		auto RhsCell = CellOfTile(Rhs);
+		return LhsCell.y != RhsCell.y ? LhsCell.y < RhsCell.y : LhsCell.x < RhsCell.x;
+	});
+
+	std::vector<TrackMeshSegment> Segments;
+	m_FirstSegmentOfTile.assign(Tiles.size(), 0);
+	m_TrackSegmentGrid.Clear();
+	uint32_t CellFirstSegment = 0;
+	for (size_t OrderIndex = 0; OrderIndex < TileOrder.size(); OrderIndex++)
+	{
+		auto TileIndex = TileOrder[OrderIndex];
+		const auto& Tile = Tiles[TileIndex];
+
+		auto IsFirstTileOfCell = OrderIndex == 0 || CellOfTile(TileOrder[OrderIndex - 1]) != CellOfTile(TileIndex);
+		if (IsFirstTileOfCell)
+			CellFirstSegment = static_cast<uint32_t>(Segments.size());
+
+		m_FirstSegmentOfTile[TileIndex] = static_cast<uint32_t>(Segments.size());
+		ForEachExistingDirection(Tile.ConnectedDirections, [&](TrackDirection Direction)
+		{
+			auto From = glm::vec2(Tile.Tile);
+			auto To = From + 0.5f * glm::vec2(TrackDirectionToVector(Direction));
+			Segments.push_back({ .From = From, .To = To, .InactiveFrom = 0.5f * (From + To) });
+		});
+
+		auto IsLastTileOfCell = OrderIndex + 1 == TileOrder.size() || CellOfTile(TileOrder[OrderIndex + 1]) != CellOfTile(TileIndex);
+		if (IsLastTileOfCell)
+		{
+			auto SegmentCount = static_cast<uint32_t>(Segments.size()) - CellFirstSegment;
+			m_TrackSegmentGrid.Insert(glm::vec2(Tile.Tile), { .FirstSegment = CellFirstSegment, .SegmentCount = SegmentCount });
+		}
+	}
+
+	m_TrackMesh = Segments.empty() ? nullptr : TrackMesh::Create(Segments);
+	if (!m_TrackMesh)
+		return;
+
+	for (uint32_t TileIndex = 0; TileIndex < Tiles.size(); TileIndex++)
+		UpdateTrackTileSegments(World, TileIndex);
+}
+
+void TrackLayer::UpdateTrackTileSegments(const World& World, uint32_t TileIndex) const
 {
+	const auto& Tile = World.TrackTiles()[TileIndex];
+
 	auto PossiblePaths = World.ListValidPathsInTile(Tile.Tile.x, Tile.Tile.y);
 	BD_ASSERT(Tile.SelectedPath < PossiblePaths.size());
 	auto ActiveDirection = PossiblePaths[Tile.SelectedPath];
 
+	// NOTE: segments are visited in the same order as when the mesh was built
+	auto Segment = m_FirstSegmentOfTile[TileIndex];
 	ForEachExistingDirection(Tile.ConnectedDirections, [&](TrackDirection Direction)
 	{
-		auto From = glm::vec2(Tile.Tile);
-		auto To = From + 0.5f * glm::vec2(TrackDirectionToVector(Direction));
+		m_TrackMesh->SetSegmentState(Segment++, static_cast<uint32_t>(Tile.State(Direction)), !!(Direction & ActiveDirection));
+	});
+}
 
-		if (!(Direction & ActiveDirection))
-			From = 0.5f * (From + To);
+void TrackLayer::RebuildSignalGrid(const World& World) const
+{
+	m_SignalGrid.Clear();
 
-		auto State = Tile.State(Direction);
-		BD_ASSERT(m_TrackColors.contains(State));
-		auto Color = m_TrackColors.at(State);
+	auto Signals = World.Signals();
+	for (uint32_t SignalIndex = 0; SignalIndex < Signals.size(); SignalIndex++)
+		m_SignalGrid.Insert(glm::vec2(Signals[SignalIndex].Location.FromTile), SignalIndex);
+}
+
+void TrackLayer::RenderTrack(Renderer& Renderer, const Rect2D& VisibleArea) const
+{
+	if (!m_TrackMesh)
+		return;
 
-		Renderer.DrawLine(From, To, Color);
+	m_TrackMesh->UploadSegmentStates();
+
+	m_VisibleTrackSegments.clear();
+	m_TrackSegmentGrid.ForEachInArea(VisibleArea, [&](const TrackMesh::SegmentRange& Range)
+	{
+		if (!m_VisibleTrackSegments.empty())
+		{
+			auto& Last = m_VisibleTrackSegments.back();
+			if (Last.FirstSegment + Last.SegmentCount == Range.FirstSegment)
+			{
+				Last.SegmentCount += Range.SegmentCount;
+				return;
+			}
+		}
+		m_VisibleTrackSegments.push_back(Range);
 	});
+
+	std::array<glm::vec3, 3> StateColors = {};
+	for (auto State : { TrackState::Free, TrackState::Reserved, TrackState::Occupied })
+	{
+		BD_ASSERT(m_TrackColors.contains(State));
+		StateColors[static_cast<size_t>(State)] = m_TrackColors.at(State);
+	}
+	Renderer.Draw(*m_TrackMesh, StateColors, m_VisibleTrackSegments);
 }
 
-void TrackLayer::RenderSignal(Renderer& Renderer, const Signal& Signal) const
+void TrackLayer::RenderSignals(Renderer& Renderer, const World& World, const Rect2D& VisibleArea) const
 {
-	BD_ASSERT(m_SignalIcons.contains(Signal.State));
-	const auto& Icon = *m_SignalIcons.at(Signal.State);
+	for (auto& [State, Instances] : m_SignalInstances)
+		Instances.clear();
 
-	Renderer.Draw(Icon, TransformationMatrixForSignal(Signal));
+	auto Signals = World.Signals();
+	m_SignalGrid.ForEachInArea(VisibleArea, [&](uint32_t SignalIndex)
+	{
+		const auto& Signal = Signals[SignalIndex];
+		BD_ASSERT(m_SignalIcons.contains(Signal.State));
+		m_SignalInstances[Signal.State].push_back({ .From = glm::vec2(Signal.Location.FromTile), .To = glm::vec2(Signal.Location.ToTile) });
+	});
+
+	for (const auto& [State, Icon] : m_SignalIcons)
+		Renderer.Draw(*Icon, m_SignalInstances[State]);
 }
 
 void TrackLayer::RenderTrain(Renderer& Renderer, const Train& Train) const
@@ -231,6 +348,14 @@ void TrackLayer::RenderTrain(Renderer& Renderer, const Train& Train) const
 	Renderer.DrawLine(V4, V1, DebugTrainColor);
 }
 
+Rect2D TrackLayer::VisibleWorldArea(glm::vec2 FramebufferSize) const
+{
+	auto TopLeft = CursorPositionToWorldCoordinates(glm::ivec2(0, 0), glm::ivec2(FramebufferSize));
+	auto BottomRight = CursorPositionToWorldCoordinates(glm::ivec2(FramebufferSize), glm::ivec2(FramebufferSize));
+
+	return { .Min = { TopLeft.x - 1.0f, BottomRight.y - 1.0f }, .Max = { BottomRight.x + 1.0f, TopLeft.y + 1.0f } };
+}
+
 glm::vec2 TrackLayer::CursorPositionToWorldCoordinates(glm::ivec2 CursorPosition, glm::ivec2 CursorAreaBoundaries) const
 {
 	auto NormalizedCoordinates = glm::vec2(CursorPosition) / glm::vec2(CursorAreaBoundaries) * 2.0f - 1.0f;
@@ -3,12 +3,26 @@
 #include <glm/glm.hpp>
 #include <optional>
 
+#include "Core/AssetRegistry.h"
+#include "Core/SpatialGrid.h"
 #include "Layer/Layer.h"
 
 class TrackLayer : public Layer
 {
 public:
-	static std::unique_ptr<TrackLayer> Create();
+	struct Assets
+	{
+		std::shared_ptr<VectorIcon> SignalClearIcon;
+		std::shared_ptr<VectorIcon> SignalDangerIcon;
+	};
+
+	/*
+	 * Requests everything the layer needs from the loader. The assets are ready to be passed to Create() once the
+	 * loader finishes.
+	 */
+	static void LoadAssets(AssetLoader& Loader, AssetRegistry& Registry, Assets& Assets);
+
+	static std::unique_ptr<TrackLayer> Create(Assets Assets);
 
 	virtual bool OnMousePress(MouseButton::Button Button, const InputState& InputState, World& World) override;
 
@@ -25,7 +39,19 @@ private:
 	std::optional<SignalLocation> m_RouteStartSignalLocation = std::nullopt;
 
 	std::unordered_map<TrackState, glm::vec3> m_TrackColors;
-	std::unordered_map<SignalState, std::unique_ptr<VectorIcon>> m_SignalIcons;
+	std::unordered_map<SignalState, std::shared_ptr<VectorIcon>> m_SignalIcons;
+
+	mutable std::unordered_map<SignalState, std::vector<VectorIconInstance>> m_SignalInstances;
+
+	// NOTE: built on the first render after the layout of the world changes
+	mutable std::optional<uint64_t> m_LayoutRevision;
+	mutable std::unique_ptr<TrackMesh> m_TrackMesh;
+	mutable std::vector<uint32_t> m_FirstSegmentOfTile;
+	mutable SpatialGrid<TrackMesh::SegmentRange> m_TrackSegmentGrid;
+	mutable SpatialGrid<uint32_t> m_SignalGrid;
+
+	// NOTE: rebuilt every frame, only kept around so that their memory is reused
+	mutable std::vector<TrackMesh::SegmentRange> m_VisibleTrackSegments;
 
 	TrackLayer();
 
@@ -33,12 +59,24 @@ private:
 
 	void HandleSignalClick(World& World, const Signal& Signal);
 
-	void RenderTrackTile(Renderer& Renderer, const World& World, const TrackTile& Tile) const;
+	void RebuildTrackMesh(const World& World) const;
 
-	void RenderSignal(Renderer& Renderer, const Signal& Signal) const;
+	void RebuildSignalGrid(const World& World) const;
+
+	void UpdateTrackTileSegments(const World& World, uint32_t TileIndex) const;
+
+	void RenderTrack(Renderer& Renderer, const Rect2D& VisibleArea) const;
+
+	void RenderSignals(Renderer& Renderer, const World& World, const Rect2D& VisibleArea) const;
 
 	void RenderTrain(Renderer& Renderer, const Train& Train) const;
 
+	/*
+	 * The part of the world that is on the screen, grown by a tile on every side so that it includes everything that is
+	 * drawn around the tiles near the edges of the screen.
+	 */
+	Rect2D VisibleWorldArea(glm::vec2 FramebufferSize) const;
+
 	glm::vec2 CursorPositionToWorldCoordinates(glm::ivec2 CursorPosition, glm::ivec2 CursorAreaBoundaries) const;
 
 	glm::ivec2 WorldPositionToTileCoordinates(glm::vec2 WorldPosition) const;
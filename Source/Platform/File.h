@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string_view>
 #include <vector>
 
@@ -15,6 +16,11 @@ public:
 
 	virtual bool Write(const uint8_t* Buffer, size_t Size) = 0;
 
+	/*
+	 * Blocks until everything written so far has reached the disk.
+	 */
+	virtual bool Flush() = 0;
+
 	virtual size_t Size() const = 0;
 
 	virtual void Seek(ptrdiff_t Offset) = 0;
@@ -24,6 +30,17 @@ public:
 	virtual size_t Tell() const = 0;
 };
 
+/*
+ * Read-only view of a whole file mapped into the address space. The data stays valid until the object is destroyed.
+ */
+class MappedFile
+{
+public:
+	virtual ~MappedFile() = default;
+
+	virtual std::span<const uint8_t> Data() const = 0;
+};
+
 class FileSystem
 {
 public:
@@ -42,6 +59,14 @@ public:
 
 	static std::unique_ptr<File> Open(std::string_view Path, OpenMode OpenMode, AccessMode AccessMode);
 
+	static std::unique_ptr<MappedFile> MapFile(std::string_view Path);
+
+	/*
+	 * Renames a file, replacing the destination if it already exists. The replacement is atomic, so the destination
+	 * always holds either the old or the new contents in full.
+	 */
+	static bool Rename(std::string_view From, std::string_view To);
+
 	static std::optional<std::vector<uint8_t>> ReadFileAsBytes(std::string_view Path);
 
 	static std::optional<std::string> ReadFileAsString(std::string_view Path);
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <cstdint>
+
 namespace Time
 {
 	using Point = uint64_t;
 
 	Point Now();
 
+	uint64_t Frequency();
+
 	float Duration(Point Start, Point End);
 
 	void Sleep(uint32_t Millis);
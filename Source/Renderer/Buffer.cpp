@@ -1,5 +1,30 @@
 #include "Buffer.h"
 
+#include <cstring>
+
+#include "Core/Assert.h"
+#include "Core/FrameStats.h"
+#include "Core/Logger.h"
+
+// NOTE: glad is generated for GL 4.2, buffer storage is core since 4.4 and is loaded by hand
+using BufferStorageFunction = void (APIENTRYP)(GLenum Target, GLsizeiptr Size, const void* Data, GLbitfield Flags);
+static BufferStorageFunction s_BufferStorage = nullptr;
+
+static constexpr GLbitfield MapPersistentBit = 0x0040;
+static constexpr GLbitfield MapCoherentBit = 0x0080;
+
+static bool IsExtensionSupported(const char* Name)
+{
+	GLint ExtensionCount = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &ExtensionCount);
+	for (GLint Index = 0; Index < ExtensionCount; Index++)
+	{
+		if (std::strcmp(reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, Index)), Name) == 0)
+			return true;
+	}
+	return false;
+}
+
 Buffer::~Buffer()
 {
 	glDeleteBuffers(1, &m_Buffer);
@@ -9,6 +34,7 @@ std::unique_ptr<Buffer> Buffer::Create(size_t Size, std::optional<void*> Data, G
 {
 	GLuint Buffer;
 	glGenBuffers(1, &Buffer);
+	GFrameStats.Current().BufferCreations++;
 
 	glBindBuffer(GL_COPY_WRITE_BUFFER, Buffer);
 	glBufferData(GL_COPY_WRITE_BUFFER, Size, Data.value_or(nullptr), Usage);
@@ -16,6 +42,43 @@ std::unique_ptr<Buffer> Buffer::Create(size_t Size, std::optional<void*> Data, G
 	return std::unique_ptr<class Buffer>(new class Buffer(Buffer, Size));
 }
 
+std::unique_ptr<Buffer> Buffer::CreatePersistentlyMapped(size_t Size)
+{
+	if (!s_BufferStorage)
+		return nullptr;
+
+	GLuint Buffer;
+	glGenBuffers(1, &Buffer);
+	GFrameStats.Current().BufferCreations++;
+
+	auto Flags = GL_MAP_WRITE_BIT | MapPersistentBit | MapCoherentBit;
+	glBindBuffer(GL_COPY_WRITE_BUFFER, Buffer);
+	s_BufferStorage(GL_COPY_WRITE_BUFFER, Size, nullptr, Flags);
+
+	auto* Address = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, Size, Flags);
+	if (!Address)
+	{
+		BD_LOG_ERROR("Could not map a persistent buffer of {} bytes", Size);
+		glDeleteBuffers(1, &Buffer);
+		return nullptr;
+	}
+
+	auto Result = std::unique_ptr<class Buffer>(new class Buffer(Buffer, Size));
+	Result->m_IsPersistentlyMapped = true;
+	Result->m_MappedAddress = Address;
+	return Result;
+}
+
+void Buffer::LoadExtensions(GLADloadproc Loader)
+{
+	auto IsCore = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 4);
+	if (IsCore || IsExtensionSupported("GL_ARB_buffer_storage"))
+		s_BufferStorage = reinterpret_cast<BufferStorageFunction>(Loader("glBufferStorage"));
+
+	if (!s_BufferStorage)
+		BD_LOG_INFO("Persistently mapped buffers are not supported, streamed geometry falls back to orphaning");
+}
+
 void* Buffer::Map(bool IsReading, bool IsWriting) const
 {
 	if (m_MappedAddress.has_value())
@@ -34,13 +97,35 @@ void* Buffer::Map(bool IsReading, bool IsWriting) const
 	return *m_MappedAddress;
 }
 
+void* Buffer::MapDiscard() const
+{
+	if (m_MappedAddress.has_value())
+		return *m_MappedAddress;
+
+	Bind(GL_COPY_WRITE_BUFFER);
+	m_MappedAddress = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, m_Size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	return *m_MappedAddress;
+}
+
 void Buffer::Unmap() const
 {
+	if (m_IsPersistentlyMapped)
+		return;
+
 	Bind(GL_COPY_WRITE_BUFFER);
 	glUnmapBuffer(GL_COPY_WRITE_BUFFER);
 	m_MappedAddress = std::nullopt;
 }
 
+void Buffer::Update(size_t Offset, size_t Size, const void* Data) const
+{
+	BD_ASSERT(Offset + Size <= m_Size);
+	BD_ASSERT(!m_MappedAddress.has_value());
+
+	Bind(GL_COPY_WRITE_BUFFER);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, Offset, Size, Data);
+}
+
 void Buffer::Bind(GLenum Target) const
 {
 	glBindBuffer(Target, m_Buffer);
@@ -51,6 +136,11 @@ size_t Buffer::Size() const
 	return m_Size;
 }
 
+bool Buffer::IsPersistentlyMapped() const
+{
+	return m_IsPersistentlyMapped;
+}
+
 Buffer::Buffer(GLuint Buffer, size_t Size)
 	: m_Buffer(Buffer)
 	, m_Size(Size)
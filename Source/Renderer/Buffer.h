@@ -11,19 +11,49 @@ public:
 
 	static std::unique_ptr<Buffer> Create(size_t Size, std::optional<void*> Data, GLenum Usage);
 
+	/*
+	 * Creates a write-only buffer that stays mapped for its whole lifetime. Writes become visible to the GPU without
+	 * unmapping it, so the caller has to make sure the GPU is done with a range before overwriting it. Returns nullptr
+	 * if the driver does not support persistent mapping.
+	 */
+	static std::unique_ptr<Buffer> CreatePersistentlyMapped(size_t Size);
+
+	/*
+	 * Loads the functions that glad was not generated for. Has to be called once the GL context is current.
+	 */
+	static void LoadExtensions(GLADloadproc Loader);
+
 	void* Map(bool IsReading, bool IsWriting) const;
 
+	/*
+	 * Maps the whole buffer for writing and orphans its previous contents, so mapping never waits for the GPU to finish
+	 * reading them.
+	 */
+	void* MapDiscard() const;
+
 	void Unmap() const;
 
+	/*
+	 * Overwrites a range of the buffer without mapping it.
+	 */
+	void Update(size_t Offset, size_t Size, const void* Data) const;
+
 	void Bind(GLenum Target) const;
 
 	size_t Size() const;
 
+	bool IsPersistentlyMapped() const;
+
 private:
 	GLuint m_Buffer;
 	size_t m_Size;
+	bool m_IsPersistentlyMapped = false;
 	
 	mutable std::optional<void*> m_MappedAddress;
 
 	Buffer(GLuint Buffer, size_t Size);
+
+	GLuint GetNativeHandle() const { return m_Buffer; }
+
+	friend class TextureBuffer;
 };
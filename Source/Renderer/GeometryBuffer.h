@@ -1,11 +1,14 @@
 #pragma once
 
+#include <array>
 #include <glm/glm.hpp>
 #include <memory>
 #include <span>
 
 #include "Core/Assert.h"
+#include "Core/Profiler.h"
 #include "Renderer/Buffer.h"
+#include "Renderer/RenderState.h"
 
 #define VERTEX_DESCRIPTION_BEGIN(Class)                                                                  \
 namespace VAOBindingsRegister {                                                                          \
@@ -35,13 +38,31 @@ namespace VAOBindingsRegister
 	}
 }
 
+enum class GeometryBufferUsage
+{
+	Static,
+	Dynamic,
+
+	/*
+	 * For geometry that is rewritten several times per frame. The buffer is split into regions that the GPU reads from
+	 * in turns, and stays mapped all the time, so writing vertices never waits for the GPU. Every Reset() starts a new
+	 * batch right after the previous one in the current region, NextRegion() moves on to the next region once the GPU
+	 * may still be reading the current one (e.g. at the start of a frame). If the driver does not support persistent
+	 * mapping, the buffer is orphaned on every Reset() instead.
+	 */
+	Streaming,
+};
+
 template<typename VertexType>
 class GeometryBuffer
 {
 public:
 	~GeometryBuffer();
 
-	static std::unique_ptr<GeometryBuffer> Create(size_t VertexCount, bool IsDynamic, const std::optional<std::span<const VertexType>>& InitialContents = std::nullopt);
+	/*
+	 * VertexCount is the capacity of a single region for streaming buffers.
+	 */
+	static std::unique_ptr<GeometryBuffer> Create(size_t VertexCount, GeometryBufferUsage Usage, const std::optional<std::span<const VertexType>>& InitialContents = std::nullopt);
 
 	void AppendVertex(const VertexType& Vertex);
 
@@ -51,22 +72,47 @@ public:
 
 	void Flush();
 
+	void NextRegion();
+
 	void Bind() const;
 
+	/*
+	 * Index of the first vertex written since the last Reset(), draws have to start from it.
+	 */
+	size_t FirstVertex() const;
+
 	size_t VertexCount() const;
 
+	size_t Capacity() const;
+
+	/*
+	 * How many more vertices fit before the next Reset().
+	 */
+	size_t FreeVertexCount() const;
+
 private:
+	static constexpr uint32_t s_RegionCount = 3;
+
 	std::unique_ptr<Buffer> m_VertexBuffer;
 	GLuint m_VAO = 0;
 
-	bool m_IsDynamic = false;
+	GeometryBufferUsage m_Usage = GeometryBufferUsage::Static;
 
 	VertexType* m_NextVertex = nullptr;
 	VertexType* m_OnePastLastVertex = nullptr;
 
+	size_t m_FirstVertex = 0;
 	size_t m_VertexCount = 0;
 
-	GeometryBuffer(std::unique_ptr<Buffer> VertexBuffer, bool IsDynamic, size_t InitialVertexCount);
+	// NOTE: only used by persistently mapped streaming buffers
+	size_t m_RegionCapacity = 0;
+	uint32_t m_Region = 0;
+	size_t m_RegionUsedVertexCount = 0;
+	std::array<GLsync, s_RegionCount> m_RegionFences = {};
+
+	GeometryBuffer(std::unique_ptr<Buffer> VertexBuffer, GeometryBufferUsage Usage, size_t InitialVertexCount, size_t RegionCapacity);
+
+	bool IsPersistentlyMapped() const;
 
 	void AddVAOBinding(uint32_t Index, uint32_t Size, uint32_t Stride, size_t Offset);
 	
@@ -76,17 +122,36 @@ private:
 template<typename VertexType>
 GeometryBuffer<VertexType>::~GeometryBuffer()
 {
+	for (auto Fence : m_RegionFences)
+	{
+		if (Fence)
+			glDeleteSync(Fence);
+	}
+	GRenderState.OnVertexArrayDeleted(m_VAO);
 	glDeleteVertexArrays(1, &m_VAO);
 }
 
 template<typename VertexType>
-std::unique_ptr<GeometryBuffer<VertexType>> GeometryBuffer<VertexType>::Create(size_t VertexCount, bool IsDynamic, const std::optional<std::span<const VertexType>>& InitialContents)
+std::unique_ptr<GeometryBuffer<VertexType>> GeometryBuffer<VertexType>::Create(size_t VertexCount, GeometryBufferUsage Usage, const std::optional<std::span<const VertexType>>& InitialContents)
 {
-	auto VertexBuffer = Buffer::Create(VertexCount * sizeof(VertexType), {}, IsDynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+	BD_ASSERT(Usage != GeometryBufferUsage::Streaming || !InitialContents.has_value());
+	if (Usage == GeometryBufferUsage::Streaming)
+	{
+		if (auto VertexBuffer = Buffer::CreatePersistentlyMapped(VertexCount * s_RegionCount * sizeof(VertexType)))
+			return std::unique_ptr<GeometryBuffer>(new GeometryBuffer(std::move(VertexBuffer), Usage, 0, VertexCount));
+	}
+
+	auto BufferUsage = GL_STATIC_DRAW;
+	if (Usage == GeometryBufferUsage::Dynamic)
+		BufferUsage = GL_DYNAMIC_DRAW;
+	if (Usage == GeometryBufferUsage::Streaming)
+		BufferUsage = GL_STREAM_DRAW;
+
+	auto VertexBuffer = Buffer::Create(VertexCount * sizeof(VertexType), {}, BufferUsage);
 	if (!VertexBuffer)
 		return nullptr;
 
-	BD_ASSERT(IsDynamic || InitialContents.has_value());
+	BD_ASSERT(Usage != GeometryBufferUsage::Static || InitialContents.has_value());
 
 	size_t InitialVertexCount = 0;
 	if (InitialContents.has_value())
@@ -100,7 +165,7 @@ std::unique_ptr<GeometryBuffer<VertexType>> GeometryBuffer<VertexType>::Create(s
 		InitialVertexCount = InitialContents->size();
 	}
 
-	return std::unique_ptr<GeometryBuffer>(new GeometryBuffer(std::move(VertexBuffer), IsDynamic, InitialVertexCount));
+	return std::unique_ptr<GeometryBuffer>(new GeometryBuffer(std::move(VertexBuffer), Usage, InitialVertexCount, VertexCount));
 }
 
 template<typename VertexType>
@@ -121,24 +186,73 @@ void GeometryBuffer<VertexType>::AppendVertices(std::span<const VertexType> Vert
 template<typename VertexType>
 void GeometryBuffer<VertexType>::Reset()
 {
-	BD_ASSERT(m_IsDynamic);
-	m_NextVertex = static_cast<VertexType*>(m_VertexBuffer->Map(false, true));
-	m_OnePastLastVertex = m_NextVertex + (m_VertexBuffer->Size() / sizeof(VertexType));
+	BD_ASSERT(m_Usage != GeometryBufferUsage::Static);
+	if (IsPersistentlyMapped())
+	{
+		auto* RegionStart = static_cast<VertexType*>(m_VertexBuffer->Map(false, true)) + m_Region * m_RegionCapacity;
+		m_FirstVertex = m_Region * m_RegionCapacity + m_RegionUsedVertexCount;
+		m_NextVertex = RegionStart + m_RegionUsedVertexCount;
+		m_OnePastLastVertex = RegionStart + m_RegionCapacity;
+	}
+	else
+	{
+		auto* Memory = m_Usage == GeometryBufferUsage::Streaming ? m_VertexBuffer->MapDiscard() : m_VertexBuffer->Map(false, true);
+		m_FirstVertex = 0;
+		m_NextVertex = static_cast<VertexType*>(Memory);
+		m_OnePastLastVertex = m_NextVertex + Capacity();
+	}
 	m_VertexCount = 0;
 }
 
 template<typename VertexType>
 void GeometryBuffer<VertexType>::Flush()
 {
-	m_VertexBuffer->Unmap();
+	// NOTE: the mapping is coherent, the vertices are visible to the GPU as is and the region keeps them until NextRegion()
+	if (IsPersistentlyMapped())
+		m_RegionUsedVertexCount += m_VertexCount;
+	else
+		m_VertexBuffer->Unmap();
 	m_NextVertex = nullptr;
 	m_OnePastLastVertex = nullptr;
 }
 
+template<typename VertexType>
+void GeometryBuffer<VertexType>::NextRegion()
+{
+	BD_ASSERT(m_Usage == GeometryBufferUsage::Streaming);
+	if (!IsPersistentlyMapped())
+		return;
+
+	// NOTE: the fence goes after every draw that reads the current region, the region is only written again once it signals
+	m_RegionFences[m_Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	m_Region = (m_Region + 1) % s_RegionCount;
+	m_RegionUsedVertexCount = 0;
+
+	if (auto Fence = m_RegionFences[m_Region])
+	{
+		if (glClientWaitSync(Fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+		{
+			// NOTE: only happens if the GPU is more than two regions behind
+			BD_PROFILE_SCOPE("GeometryBuffer::WaitForRegion");
+			while (glClientWaitSync(Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000) == GL_TIMEOUT_EXPIRED)
+			{
+			}
+		}
+		glDeleteSync(Fence);
+		m_RegionFences[m_Region] = nullptr;
+	}
+}
+
 template<typename VertexType>
 void GeometryBuffer<VertexType>::Bind() const
 {
-	glBindVertexArray(m_VAO);
+	GRenderState.BindVertexArray(m_VAO);
+}
+
+template<typename VertexType>
+size_t GeometryBuffer<VertexType>::FirstVertex() const
+{
+	return m_FirstVertex;
 }
 
 template<typename VertexType>
@@ -148,13 +262,26 @@ size_t GeometryBuffer<VertexType>::VertexCount() const
 }
 
 template<typename VertexType>
-GeometryBuffer<VertexType>::GeometryBuffer(std::unique_ptr<Buffer> VertexBuffer, bool IsDynamic, size_t InitialVertexCount)
+size_t GeometryBuffer<VertexType>::Capacity() const
+{
+	return IsPersistentlyMapped() ? m_RegionCapacity : m_VertexBuffer->Size() / sizeof(VertexType);
+}
+
+template<typename VertexType>
+size_t GeometryBuffer<VertexType>::FreeVertexCount() const
+{
+	return static_cast<size_t>(m_OnePastLastVertex - m_NextVertex);
+}
+
+template<typename VertexType>
+GeometryBuffer<VertexType>::GeometryBuffer(std::unique_ptr<Buffer> VertexBuffer, GeometryBufferUsage Usage, size_t InitialVertexCount, size_t RegionCapacity)
 	: m_VertexBuffer(std::move(VertexBuffer))
-	, m_IsDynamic(IsDynamic)
+	, m_Usage(Usage)
 	, m_VertexCount(InitialVertexCount)
+	, m_RegionCapacity(RegionCapacity)
 {
 	glGenVertexArrays(1, &m_VAO);
-	glBindVertexArray(m_VAO);
+	GRenderState.BindVertexArray(m_VAO);
 
 	m_VertexBuffer->Bind(GL_ARRAY_BUFFER);
 
@@ -167,3 +294,9 @@ void GeometryBuffer<VertexType>::AddVAOBinding(uint32_t Index, uint32_t Size, ui
 	glVertexAttribPointer(Index, Size, GL_FLOAT, false, Stride, reinterpret_cast<const void*>(Offset));
 	glEnableVertexAttribArray(Index);
 }
+
+template<typename VertexType>
+bool GeometryBuffer<VertexType>::IsPersistentlyMapped() const
+{
+	return m_VertexBuffer->IsPersistentlyMapped();
+}
@@ -0,0 +1,128 @@
+#include "RenderState.h"
+
+#include "Core/Assert.h"
+#include "Core/FrameStats.h"
+
+RenderState GRenderState;
+
+void RenderState::UseProgram(GLuint Program)
+{
+	auto& Stats = GFrameStats.Current();
+	if (m_Program == Program)
+	{
+		Stats.ElidedStateChanges++;
+		return;
+	}
+
+	glUseProgram(Program);
+	m_Program = Program;
+	Stats.StateChanges++;
+}
+
+void RenderState::BindVertexArray(GLuint VertexArray)
+{
+	auto& Stats = GFrameStats.Current();
+	if (m_VertexArray == VertexArray)
+	{
+		Stats.ElidedStateChanges++;
+		return;
+	}
+
+	glBindVertexArray(VertexArray);
+	m_VertexArray = VertexArray;
+	Stats.StateChanges++;
+}
+
+void RenderState::BindTexture(uint32_t Unit, GLenum Target, GLuint Texture)
+{
+	auto& Stats = GFrameStats.Current();
+	auto& Bound = BoundTexture(Unit, Target);
+	if (Bound == Texture)
+	{
+		Stats.ElidedStateChanges++;
+		return;
+	}
+
+	if (m_ActiveTextureUnit != Unit)
+	{
+		glActiveTexture(GL_TEXTURE0 + Unit);
+		m_ActiveTextureUnit = Unit;
+	}
+	glBindTexture(Target, Texture);
+	Bound = Texture;
+	Stats.StateChanges++;
+	Stats.TextureBinds++;
+}
+
+uint32_t RenderState::BindTexture(GLenum Target, GLuint Texture)
+{
+	uint32_t LeastRecentlyUsedUnit = 0;
+	for (uint32_t Unit = 0; Unit < MaxTextureUnitCount; Unit++)
+	{
+		if (BoundTexture(Unit, Target) == Texture)
+		{
+			LeastRecentlyUsedUnit = Unit;
+			break;
+		}
+		if (m_TextureUnitLastUse[Unit] < m_TextureUnitLastUse[LeastRecentlyUsedUnit])
+			LeastRecentlyUsedUnit = Unit;
+	}
+
+	BindTexture(LeastRecentlyUsedUnit, Target, Texture);
+	m_TextureUnitLastUse[LeastRecentlyUsedUnit] = ++m_TextureUseCount;
+	return LeastRecentlyUsedUnit;
+}
+
+void RenderState::SetBlending(bool IsEnabled)
+{
+	auto& Stats = GFrameStats.Current();
+	if (m_IsBlendingEnabled == IsEnabled)
+	{
+		Stats.ElidedStateChanges++;
+		return;
+	}
+
+	if (IsEnabled)
+		glEnable(GL_BLEND);
+	else
+		glDisable(GL_BLEND);
+	m_IsBlendingEnabled = IsEnabled;
+	Stats.StateChanges++;
+}
+
+void RenderState::OnProgramDeleted(GLuint Program)
+{
+	// NOTE: a program that is in use is only deleted once it is not anymore
+	if (m_Program == Program)
+		UseProgram(0);
+}
+
+void RenderState::OnVertexArrayDeleted(GLuint VertexArray)
+{
+	// NOTE: deleting the bound vertex array binds the default one instead
+	if (m_VertexArray == VertexArray)
+		m_VertexArray = 0;
+}
+
+void RenderState::OnTextureDeleted(GLuint Texture)
+{
+	// NOTE: deleting a texture unbinds it from every unit, an empty unit is the first one to be reused
+	for (uint32_t Index = 0; Index < MaxTextureUnitCount; Index++)
+	{
+		auto& Unit = m_TextureUnits[Index];
+		if (Unit.Texture2D == Texture)
+			Unit.Texture2D = 0;
+		if (Unit.TextureBuffer == Texture)
+			Unit.TextureBuffer = 0;
+		if (Unit.Texture2D == 0 && Unit.TextureBuffer == 0)
+			m_TextureUnitLastUse[Index] = 0;
+	}
+}
+
+GLuint& RenderState::BoundTexture(uint32_t Unit, GLenum Target)
+{
+	BD_ASSERT(Unit < MaxTextureUnitCount);
+	BD_ASSERT(Target == GL_TEXTURE_2D || Target == GL_TEXTURE_BUFFER);
+
+	return Target == GL_TEXTURE_2D ? m_TextureUnits[Unit].Texture2D : m_TextureUnits[Unit].TextureBuffer;
+}
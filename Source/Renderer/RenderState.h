@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <glad/glad.h>
+
+/*
+ * Mirrors the parts of the GL state that change between draws, so that setting a piece of state to what it already is
+ * does not reach the driver. Every change to the tracked state has to go through here, otherwise the mirror no longer
+ * matches the context and a needed change could be skipped.
+ */
+class RenderState
+{
+public:
+	static constexpr uint32_t MaxTextureUnitCount = 16;
+
+	void UseProgram(GLuint Program);
+
+	void BindVertexArray(GLuint VertexArray);
+
+	/*
+	 * Target is either GL_TEXTURE_2D or GL_TEXTURE_BUFFER.
+	 */
+	void BindTexture(uint32_t Unit, GLenum Target, GLuint Texture);
+
+	/*
+	 * Binds the texture to any unit and returns it, which is the unit that the sampler has to read from. A texture that is
+	 * already bound keeps its unit, otherwise it replaces the texture that was used the longest time ago. Textures thus
+	 * stay bound across draws and frames, and are only bound again once every unit was needed for other textures since.
+	 */
+	uint32_t BindTexture(GLenum Target, GLuint Texture);
+
+	void SetBlending(bool IsEnabled);
+
+	/*
+	 * Have to be called when the object is deleted, since GL may hand its name out to the next object that gets created.
+	 */
+	void OnProgramDeleted(GLuint Program);
+	void OnVertexArrayDeleted(GLuint VertexArray);
+	void OnTextureDeleted(GLuint Texture);
+
+private:
+	struct TextureUnit
+	{
+		GLuint Texture2D = 0;
+		GLuint TextureBuffer = 0;
+	};
+
+	// NOTE: all of these start out with the defaults of a fresh context
+	GLuint m_Program = 0;
+	GLuint m_VertexArray = 0;
+	uint32_t m_ActiveTextureUnit = 0;
+	std::array<TextureUnit, MaxTextureUnitCount> m_TextureUnits = {};
+	bool m_IsBlendingEnabled = false;
+
+	// NOTE: value of m_TextureUseCount when a texture was last bound to the unit through BindTexture(Target, Texture)
+	std::array<uint64_t, MaxTextureUnitCount> m_TextureUnitLastUse = {};
+	uint64_t m_TextureUseCount = 0;
+
+	GLuint& BoundTexture(uint32_t Unit, GLenum Target);
+};
+
+extern RenderState GRenderState;
@@ -2,14 +2,26 @@
 
 #include <glad/glad.h>
 
+#include "Core/FrameStats.h"
 #include "Core/Logger.h"
+#include "Core/Profiler.h"
+
+VERTEX_DESCRIPTION_BEGIN(GridVertex)
+	VERTEX_DESCRIPTION_ELEMENT(Position)
+VERTEX_DESCRIPTION_END()
+
+static constexpr GridVertex ScreenQuadVertices[] =
+{
+	{ { -1.0f, -1.0f } }, { { 1.0f, -1.0f } }, { { 1.0f, 1.0f } },
+	{ { -1.0f, -1.0f } }, { { 1.0f, 1.0f } }, { { -1.0f, 1.0f } },
+};
 
 VERTEX_DESCRIPTION_BEGIN(LineVertex)
 	VERTEX_DESCRIPTION_ELEMENT(Position)
 	VERTEX_DESCRIPTION_ELEMENT(Color)
 VERTEX_DESCRIPTION_END()
 
-std::unique_ptr<Renderer> Renderer::Create(Window& Window)
+std::unique_ptr<Renderer> Renderer::Create(Window& Window, AssetRegistry& Assets)
 {
 	Window.MakeGLContextCurrent();
 
@@ -24,20 +36,41 @@ std::unique_ptr<Renderer> Renderer::Create(Window& Window)
 		BD_LOG_ERROR("Could not load GL functions");
 		return nullptr;
 	}
+	Buffer::LoadExtensions(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
 
-	auto VectorIconShader = Shader::Create("Resources/Shaders/VectorIcon.vert", "Resources/Shaders/VectorIcon.frag");
+	auto VectorIconShader = Assets.GetShader("Resources/Shaders/VectorIcon.vert", "Resources/Shaders/VectorIcon.frag");
 	if (!VectorIconShader)
 		return nullptr;
 
-	auto LineGeometryBuffer = GeometryBuffer<LineVertex>::Create(s_MaxLineCount * 2, true);
+	auto VectorIconInstancedShader = Assets.GetShader("Resources/Shaders/VectorIconInstanced.vert", "Resources/Shaders/VectorIcon.frag");
+	if (!VectorIconInstancedShader)
+		return nullptr;
+
+	auto IconInstanceBuffer = TextureBuffer::Create(s_InitialIconInstanceCount * sizeof(VectorIconInstance), GL_RGBA32F);
+	if (!IconInstanceBuffer)
+		return nullptr;
+
+	auto TrackShader = Assets.GetShader("Resources/Shaders/Track.vert", "Resources/Shaders/Line.frag");
+	if (!TrackShader)
+		return nullptr;
+
+	auto ScreenQuad = GeometryBuffer<GridVertex>::Create(std::size(ScreenQuadVertices), GeometryBufferUsage::Static, ScreenQuadVertices);
+	if (!ScreenQuad)
+		return nullptr;
+
+	auto GridShader = Assets.GetShader("Resources/Shaders/Grid.vert", "Resources/Shaders/Grid.frag");
+	if (!GridShader)
+		return nullptr;
+
+	auto LineGeometryBuffer = GeometryBuffer<LineVertex>::Create(s_InitialLineCount * 2, GeometryBufferUsage::Streaming);
 	if (!LineGeometryBuffer)
 		return nullptr;
 
-	auto LineShader = Shader::Create("Resources/Shaders/Line.vert", "Resources/Shaders/Line.frag");
+	auto LineShader = Assets.GetShader("Resources/Shaders/Line.vert", "Resources/Shaders/Line.frag");
 	if (!LineShader)
 		return nullptr;
 
-	return std::unique_ptr<Renderer>(new Renderer(Window, std::move(VectorIconShader), std::move(LineGeometryBuffer), std::move(LineShader)));
+	return std::unique_ptr<Renderer>(new Renderer(Window, Assets, std::move(VectorIconShader), std::move(VectorIconInstancedShader), std::move(IconInstanceBuffer), std::move(TrackShader), std::move(ScreenQuad), std::move(GridShader), std::move(LineGeometryBuffer), std::move(LineShader)));
 }
 
 void Renderer::BeginFrame()
@@ -48,26 +81,28 @@ void Renderer::BeginFrame()
 	
 	m_ViewProjectionMatrix = glm::mat4(1.0f);
 
+	GrowLineGeometryBufferIfNeeded();
+	m_FrameLineVertexCount = 0;
+
+	m_LineGeometryBuffer->NextRegion();
 	m_LineGeometryBuffer->Reset();
 }
 
 void Renderer::Flush()
 {
-	m_LineGeometryBuffer->Flush();
-
-	m_LineShader->Bind();
-	m_LineShader->SetUniform("u_ViewMatrix", m_ViewProjectionMatrix);
-
-	m_LineGeometryBuffer->Bind();
-	glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(m_LineGeometryBuffer->VertexCount()));
+	BD_PROFILE_FUNCTION();
 
+	FlushLines();
 	m_LineGeometryBuffer->Reset();
 }
 
 void Renderer::EndFrame()
 {
+	BD_PROFILE_FUNCTION();
+
 	Flush();
 
+	BD_PROFILE_SCOPE("SwapBuffers");
 	m_Window.SwapBuffers();
 }
 
@@ -80,17 +115,145 @@ void Renderer::Draw(const VectorIcon& Icon, const glm::mat4& TransformationMatri
 {
 	auto MVP = m_ViewProjectionMatrix * TransformationMatrix;
 
+	GRenderState.SetBlending(false);
 	m_VectorIconShader->Bind();
 	m_VectorIconShader->SetUniform("u_MVP", MVP);
 
 	Icon.GeometryBuffer().Bind();
 	glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(Icon.GeometryBuffer().VertexCount()));
+	GFrameStats.Current().DrawCalls++;
+}
+
+void Renderer::Draw(const VectorIcon& Icon, std::span<const VectorIconInstance> Instances)
+{
+	if (Instances.empty() || !ReserveIconInstances(Instances.size()))
+		return;
+
+	m_IconInstanceBuffer->Replace(Instances.data(), Instances.size_bytes());
+
+	GRenderState.SetBlending(false);
+	m_VectorIconInstancedShader->Bind();
+	m_VectorIconInstancedShader->SetUniform("u_ViewProjectionMatrix", m_ViewProjectionMatrix);
+	m_IconInstanceBuffer->Bind(s_IconInstanceTextureUnit);
+
+	Icon.GeometryBuffer().Bind();
+	glDrawArraysInstanced(GL_TRIANGLES, 0, static_cast<GLsizei>(Icon.GeometryBuffer().VertexCount()), static_cast<GLsizei>(Instances.size()));
+	GFrameStats.Current().DrawCalls++;
+}
+
+void Renderer::Draw(const TrackMesh& Mesh, std::span<const glm::vec3> StateColors, std::span<const TrackMesh::SegmentRange> Ranges)
+{
+	BD_ASSERT(StateColors.size() <= TrackMesh::MaxColorCount);
+	if (Ranges.empty())
+		return;
+
+	m_TrackRangeFirstVertices.clear();
+	m_TrackRangeVertexCounts.clear();
+	for (const auto& Range : Ranges)
+	{
+		m_TrackRangeFirstVertices.push_back(static_cast<GLint>(2 * Range.FirstSegment));
+		m_TrackRangeVertexCounts.push_back(static_cast<GLsizei>(2 * Range.SegmentCount));
+	}
+
+	GRenderState.SetBlending(false);
+	m_TrackShader->Bind();
+	m_TrackShader->SetUniform("u_ViewMatrix", m_ViewProjectionMatrix);
+	for (uint32_t Index = 0; Index < StateColors.size(); Index++)
+		m_TrackShader->SetUniform(s_TrackStateColorsLocation + Index, StateColors[Index]);
+
+	Mesh.Bind(s_TrackSegmentStateTextureUnit);
+	glMultiDrawArrays(GL_LINES, m_TrackRangeFirstVertices.data(), m_TrackRangeVertexCounts.data(), static_cast<GLsizei>(Ranges.size()));
+	GFrameStats.Current().DrawCalls++;
 }
 
 void Renderer::DrawLine(glm::vec2 From, glm::vec2 To, glm::vec3 Color)
 {
+	// NOTE: draws what fits and continues in a fresh region, the buffer is then grown before the next frame
+	if (m_LineGeometryBuffer->FreeVertexCount() < 2)
+	{
+		FlushLines();
+		m_LineGeometryBuffer->NextRegion();
+		m_LineGeometryBuffer->Reset();
+		GFrameStats.Current().LineOverflowFlushes++;
+	}
+
 	m_LineGeometryBuffer->AppendVertex({ .Position = From, .Color = Color });
 	m_LineGeometryBuffer->AppendVertex({ .Position = To, .Color = Color });
+	m_FrameLineVertexCount += 2;
+	GFrameStats.Current().LineVertices += 2;
+}
+
+bool Renderer::ReserveIconInstances(size_t InstanceCount)
+{
+	auto Capacity = m_IconInstanceBuffer->Size() / sizeof(VectorIconInstance);
+	if (InstanceCount <= Capacity)
+		return true;
+
+	while (Capacity < InstanceCount)
+		Capacity *= 2;
+
+	auto IconInstanceBuffer = TextureBuffer::Create(Capacity * sizeof(VectorIconInstance), GL_RGBA32F);
+	if (!IconInstanceBuffer)
+	{
+		BD_LOG_ERROR("Could not grow the icon instance buffer to {} instances", Capacity);
+		return false;
+	}
+
+	BD_LOG_INFO("Grew the icon instance buffer to {} instances", Capacity);
+	m_IconInstanceBuffer = std::move(IconInstanceBuffer);
+	return true;
+}
+
+void Renderer::DrawGrid(glm::vec2 Origin, float Spacing, glm::vec4 Color)
+{
+	GRenderState.SetBlending(true);
+	m_GridShader->Bind();
+	// NOTE: inverted once here rather than for every vertex of the quad
+	m_GridShader->SetUniform("u_ScreenToWorldMatrix", glm::inverse(m_ViewProjectionMatrix));
+	m_GridShader->SetUniform("u_Origin", Origin);
+	m_GridShader->SetUniform("u_Spacing", Spacing);
+	m_GridShader->SetUniform("u_Color", Color);
+
+	m_ScreenQuad->Bind();
+	glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_ScreenQuad->VertexCount()));
+	GFrameStats.Current().DrawCalls++;
+}
+
+void Renderer::FlushLines()
+{
+	m_LineGeometryBuffer->Flush();
+	if (m_LineGeometryBuffer->VertexCount() == 0)
+		return;
+
+	GRenderState.SetBlending(false);
+	m_LineShader->Bind();
+	m_LineShader->SetUniform("u_ViewMatrix", m_ViewProjectionMatrix);
+
+	m_LineGeometryBuffer->Bind();
+	glDrawArrays(GL_LINES, static_cast<GLint>(m_LineGeometryBuffer->FirstVertex()), static_cast<GLsizei>(m_LineGeometryBuffer->VertexCount()));
+	GFrameStats.Current().DrawCalls++;
+}
+
+void Renderer::GrowLineGeometryBufferIfNeeded()
+{
+	GFrameStats.Current().LineVertexCapacity = static_cast<uint32_t>(m_LineGeometryBuffer->Capacity());
+	if (m_FrameLineVertexCount <= m_LineGeometryBuffer->Capacity())
+		return;
+
+	auto Capacity = m_LineGeometryBuffer->Capacity();
+	while (Capacity < m_FrameLineVertexCount)
+		Capacity *= 2;
+
+	auto LineGeometryBuffer = GeometryBuffer<LineVertex>::Create(Capacity, GeometryBufferUsage::Streaming);
+	if (!LineGeometryBuffer)
+	{
+		BD_LOG_WARNING("Could not grow the line buffer to {} vertices, lines will keep being drawn in several chunks", Capacity);
+		return;
+	}
+
+	BD_LOG_INFO("Grew the line buffer from {} to {} vertices", m_LineGeometryBuffer->Capacity(), Capacity);
+	m_LineGeometryBuffer = std::move(LineGeometryBuffer);
+	GFrameStats.Current().LineVertexCapacity = static_cast<uint32_t>(Capacity);
 }
 
 glm::vec2 Renderer::FramebufferSize() const
@@ -98,13 +261,19 @@ glm::vec2 Renderer::FramebufferSize() const
 	return { m_Window.Width(), m_Window.Height() };
 }
 
-Renderer::Renderer(Window& Window, std::unique_ptr<Shader> VectorIconShader, std::unique_ptr<GeometryBuffer<LineVertex>> LineGeometryBuffer, std::unique_ptr<Shader> LineShader)
+Renderer::Renderer(Window& Window, AssetRegistry& Assets, std::shared_ptr<Shader> VectorIconShader, std::shared_ptr<Shader> VectorIconInstancedShader, std::unique_ptr<TextureBuffer> IconInstanceBuffer, std::shared_ptr<Shader> TrackShader, std::unique_ptr<GeometryBuffer<GridVertex>> ScreenQuad, std::shared_ptr<Shader> GridShader, std::unique_ptr<GeometryBuffer<LineVertex>> LineGeometryBuffer, std::shared_ptr<Shader> LineShader)
 	: m_Window(Window)
+	, m_Assets(Assets)
 	, m_VectorIconShader(std::move(VectorIconShader))
+	, m_VectorIconInstancedShader(std::move(VectorIconInstancedShader))
+	, m_IconInstanceBuffer(std::move(IconInstanceBuffer))
+	, m_TrackShader(std::move(TrackShader))
+	, m_ScreenQuad(std::move(ScreenQuad))
+	, m_GridShader(std::move(GridShader))
 	, m_LineGeometryBuffer(std::move(LineGeometryBuffer))
 	, m_LineShader(std::move(LineShader))
 {
+	// NOTE: blending is only turned on for the draws that need it, everything else is opaque
 	glEnable(GL_MULTISAMPLE);
-	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
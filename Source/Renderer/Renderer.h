@@ -2,11 +2,30 @@
 
 #include <glm/glm.hpp>
 
+#include "Core/AssetRegistry.h"
+#include "Core/FrameStats.h"
 #include "Renderer/GeometryBuffer.h"
+#include "Renderer/RenderState.h"
 #include "Renderer/Shader.h"
+#include "Renderer/TextureBuffer.h"
+#include "Renderer/TrackMesh.h"
 #include "Renderer/VectorIcon.h"
 #include "Renderer/Window.h"
 
+/*
+ * An instance of a vector icon placed halfway between From and To, with the +Y axis of the icon pointing from From to To.
+ */
+struct VectorIconInstance
+{
+	glm::vec2 From;
+	glm::vec2 To;
+};
+
+struct GridVertex
+{
+	glm::vec2 Position;
+};
+
 struct LineVertex
 {
 	glm::vec2 Position;
@@ -16,7 +35,7 @@ struct LineVertex
 class Renderer
 {
 public:
-	static std::unique_ptr<Renderer> Create(Window& Window);
+	static std::unique_ptr<Renderer> Create(Window& Window, AssetRegistry& Assets);
 	
 	void BeginFrame();
 
@@ -28,40 +47,109 @@ public:
 
 	void Draw(const VectorIcon& Icon, const glm::mat4& TransformationMatrix);
 
+	/*
+	 * Draws every instance of the icon with a single draw call.
+	 */
+	void Draw(const VectorIcon& Icon, std::span<const VectorIconInstance> Instances);
+
+	/*
+	 * Draws the given ranges of segments of the mesh with a single draw call. StateColors are indexed by the colour
+	 * index of every segment.
+	 */
+	void Draw(const TrackMesh& Mesh, std::span<const glm::vec3> StateColors, std::span<const TrackMesh::SegmentRange> Ranges);
+
+	/*
+	 * Draws the triangles of the buffer blended over what is already there.
+	 */
 	template<typename VertexType>
 	void DrawWithShader(const GeometryBuffer<VertexType>& Buffer, const Shader& Shader);
 
+	template<typename VertexType>
+	void DrawWithShader(const GeometryBuffer<VertexType>& Buffer, const Shader& Shader, size_t FirstVertex, size_t VertexCount);
+
 	void DrawLine(glm::vec2 From, glm::vec2 To, glm::vec3 Color);
 
+	/*
+	 * Covers the whole screen with anti-aliased grid lines that run through Origin every Spacing world units. The grid
+	 * is computed per pixel, so its cost does not depend on the number of visible lines.
+	 */
+	void DrawGrid(glm::vec2 Origin, float Spacing, glm::vec4 Color);
+
 	glm::vec2 FramebufferSize() const;
 
+	AssetRegistry& Assets() { return m_Assets; }
+
 private:
 	Window& m_Window;
+	AssetRegistry& m_Assets;
 
 	glm::mat4 m_ViewProjectionMatrix = {};
 
 	/***************************************
 	 ********* VECTOR ICON DRAWING *********
 	 ***************************************/
-	std::unique_ptr<Shader> m_VectorIconShader;
+	std::shared_ptr<Shader> m_VectorIconShader;
+
+	// NOTE: has to match the layout of VectorIconInstanced.vert
+	static constexpr uint32_t s_IconInstanceTextureUnit = 1;
+	static constexpr size_t s_InitialIconInstanceCount = 256;
+
+	std::shared_ptr<Shader> m_VectorIconInstancedShader;
+	std::unique_ptr<TextureBuffer> m_IconInstanceBuffer;
+
+	/**************************************
+	 ********* TRACK DRAWING **************
+	 **************************************/
+	// NOTE: have to match the layout of Track.vert
+	static constexpr uint32_t s_TrackStateColorsLocation = 2;
+	static constexpr uint32_t s_TrackSegmentStateTextureUnit = 1;
+
+	std::shared_ptr<Shader> m_TrackShader;
+
+	// NOTE: only kept around so that their memory is reused between frames
+	std::vector<GLint> m_TrackRangeFirstVertices;
+	std::vector<GLsizei> m_TrackRangeVertexCounts;
+
+	/**************************************
+	 ********* GRID DRAWING ***************
+	 **************************************/
+	std::unique_ptr<GeometryBuffer<GridVertex>> m_ScreenQuad;
+	std::shared_ptr<Shader> m_GridShader;
 
 	/**************************************
 	 ********* LINE DRAWING *********
 	 **************************************/
-	static constexpr size_t s_MaxLineCount = 4096;
+	static constexpr size_t s_InitialLineCount = 4096;
 
 	std::unique_ptr<GeometryBuffer<LineVertex>> m_LineGeometryBuffer;
-	std::unique_ptr<Shader> m_LineShader;
+	std::shared_ptr<Shader> m_LineShader;
+
+	// NOTE: lines drawn since the start of the frame, the buffer grows to fit all of them before the next frame starts
+	size_t m_FrameLineVertexCount = 0;
 
-	Renderer(Window& Window, std::unique_ptr<Shader> VectorIconShader, std::unique_ptr<GeometryBuffer<LineVertex>> LineGeometryBuffer, std::unique_ptr<Shader> LineShader);
+	Renderer(Window& Window, AssetRegistry& Assets, std::shared_ptr<Shader> VectorIconShader, std::shared_ptr<Shader> VectorIconInstancedShader, std::unique_ptr<TextureBuffer> IconInstanceBuffer, std::shared_ptr<Shader> TrackShader, std::unique_ptr<GeometryBuffer<GridVertex>> ScreenQuad, std::shared_ptr<Shader> GridShader, std::unique_ptr<GeometryBuffer<LineVertex>> LineGeometryBuffer, std::shared_ptr<Shader> LineShader);
+
+	bool ReserveIconInstances(size_t InstanceCount);
+
+	void FlushLines();
+
+	void GrowLineGeometryBufferIfNeeded();
 };
 
 template<typename VertexType>
 void Renderer::DrawWithShader(const GeometryBuffer<VertexType>& Buffer, const Shader& Shader)
 {
+	DrawWithShader(Buffer, Shader, Buffer.FirstVertex(), Buffer.VertexCount());
+}
+
+template<typename VertexType>
+void Renderer::DrawWithShader(const GeometryBuffer<VertexType>& Buffer, const Shader& Shader, size_t FirstVertex, size_t VertexCount)
+{
+	GRenderState.SetBlending(true);
 	Shader.Bind();
 
 	Buffer.Bind();
-	glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(Buffer.VertexCount()));
+	glDrawArrays(GL_TRIANGLES, static_cast<GLint>(FirstVertex), static_cast<GLsizei>(VertexCount));
+	GFrameStats.Current().DrawCalls++;
 }
 	
@@ -1,21 +1,45 @@
 #include "Shader.h"
 
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <vector>
+
+#include "Core/AssetArchive.h"
 #include "Core/Assert.h"
 #include "Core/Logger.h"
+#include "Core/Profiler.h"
+#include "Platform/File.h"
+#include "Renderer/RenderState.h"
+
+/*
+ * Linked programs are cached on disk as driver specific binaries, so that later launches can skip compiling and
+ * linking. The cache key covers both sources and the driver identification, so editing a shader or updating the
+ * driver simply misses the cache. A binary that the driver rejects anyway (e.g. after an update that kept the version
+ * string) is recompiled and overwritten.
+ */
+static constexpr const char* ProgramCacheDirectory = "Files/ShaderCache";
+static constexpr std::array<char, 4> ProgramCacheMagic = { 'B', 'D', 'S', 'P' };
+static constexpr uint32_t ProgramCacheVersion = 1;
 
-static std::optional<GLuint> LoadAndCompileShader(GLenum Type, std::string_view Path)
+struct ProgramCacheHeader
 {
-	auto MaybeSource = FileSystem::ReadFileAsString(Path);
-	if (!MaybeSource)
-	{
-		BD_LOG_ERROR("Could not load shader; file {} is unaccessible", Path);
-		return std::nullopt;
-	}
-	auto Source = MaybeSource.value().c_str();
+	std::array<char, 4> Magic;
+	uint32_t Version;
+	uint64_t Key;
+	uint32_t BinaryFormat;
+	uint32_t BinarySize;
+};
+
+static std::optional<GLuint> CompileShader(GLenum Type, std::string_view Source, std::string_view Path)
+{
+	auto SourceData = Source.data();
+	auto SourceLength = static_cast<GLint>(Source.size());
 
 	auto Shader = glCreateShader(Type);
 	BD_ASSERT(Shader);
-	glShaderSource(Shader, 1, &Source, nullptr);
+	glShaderSource(Shader, 1, &SourceData, &SourceLength);
 
 	glCompileShader(Shader);
 	GLint CompileStatus;
@@ -28,51 +52,234 @@ static std::optional<GLuint> LoadAndCompileShader(GLenum Type, std::string_view
 	BD_LOG_ERROR("Failed to compile shader loaded from path {}:", Path);
 	BD_LOG_ERROR("{}", ErrorMessage);
 
+	glDeleteShader(Shader);
+	return std::nullopt;
+}
+
+static bool IsProgramCacheSupported()
+{
+	static const bool IsSupported = []()
+	{
+		GLint FormatCount = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &FormatCount);
+		if (FormatCount == 0)
+			BD_LOG_INFO("The driver does not support program binaries, shaders will be compiled on every launch");
+		return FormatCount > 0;
+	}();
+	return IsSupported;
+}
+
+static uint64_t ComputeProgramCacheKey(std::string_view VertexShaderSource, std::string_view FragmentShaderSource)
+{
+	// NOTE: 64 bit FNV-1a, every part is followed by a zero byte so that moving text from one part into the next changes the key
+	uint64_t Hash = 0xcbf29ce484222325ull;
+	auto Append = [&](std::string_view Part)
+	{
+		for (auto Character : Part)
+		{
+			Hash ^= static_cast<uint8_t>(Character);
+			Hash *= 0x100000001b3ull;
+		}
+		Hash *= 0x100000001b3ull;
+	};
+
+	Append(VertexShaderSource);
+	Append(FragmentShaderSource);
+	for (auto Name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+	{
+		auto* String = reinterpret_cast<const char*>(glGetString(Name));
+		Append(String ? String : "");
+	}
+	return Hash;
+}
+
+static std::string ProgramCachePath(uint64_t Key)
+{
+	return std::format("{}/{:016x}.bin", ProgramCacheDirectory, Key);
+}
+
+static std::optional<GLuint> LoadCachedProgram(uint64_t Key)
+{
+	auto File = FileSystem::MapFile(ProgramCachePath(Key));
+	if (!File)
+		return std::nullopt;
+
+	auto Data = File->Data();
+	ProgramCacheHeader Header;
+	if (Data.size() < sizeof(Header))
+		return std::nullopt;
+	std::memcpy(&Header, Data.data(), sizeof(Header));
+	if (Header.Magic != ProgramCacheMagic || Header.Version != ProgramCacheVersion || Header.Key != Key || Header.BinarySize != Data.size() - sizeof(Header))
+		return std::nullopt;
+
+	GLuint Program = glCreateProgram();
+	glProgramBinary(Program, Header.BinaryFormat, Data.data() + sizeof(Header), static_cast<GLsizei>(Header.BinarySize));
+
+	GLint LinkStatus;
+	glGetProgramiv(Program, GL_LINK_STATUS, &LinkStatus);
+	if (LinkStatus)
+		return Program;
+
+	BD_LOG_INFO("Cached shader program {} was rejected by the driver, recompiling it", ProgramCachePath(Key));
+	glDeleteProgram(Program);
 	return std::nullopt;
 }
 
+static void StoreProgramInCache(GLuint Program, uint64_t Key)
+{
+	GLint BinaryLength = 0;
+	glGetProgramiv(Program, GL_PROGRAM_BINARY_LENGTH, &BinaryLength);
+	if (BinaryLength <= 0)
+		return;
+
+	std::vector<uint8_t> Buffer(sizeof(ProgramCacheHeader) + BinaryLength);
+	GLenum BinaryFormat = 0;
+	GLsizei WrittenLength = 0;
+	glGetProgramBinary(Program, BinaryLength, &WrittenLength, &BinaryFormat, Buffer.data() + sizeof(ProgramCacheHeader));
+	Buffer.resize(sizeof(ProgramCacheHeader) + WrittenLength);
+
+	ProgramCacheHeader Header = {
+		.Magic = ProgramCacheMagic,
+		.Version = ProgramCacheVersion,
+		.Key = Key,
+		.BinaryFormat = BinaryFormat,
+		.BinarySize = static_cast<uint32_t>(WrittenLength),
+	};
+	std::memcpy(Buffer.data(), &Header, sizeof(Header));
+
+	std::error_code Error;
+	std::filesystem::create_directories(ProgramCacheDirectory, Error);
+
+	// NOTE: written next to the final file and renamed, so that a crash never leaves a truncated binary in the cache
+	auto Path = ProgramCachePath(Key);
+	auto TemporaryPath = Path + ".tmp";
+	{
+		auto File = FileSystem::Open(TemporaryPath, FileSystem::OpenMode::CreateNew, FileSystem::AccessMode::ReadWrite);
+		if (!File || !File->Write(Buffer.data(), Buffer.size()))
+		{
+			BD_LOG_WARNING("Could not write shader program cache file {}", TemporaryPath);
+			return;
+		}
+	}
+	if (!FileSystem::Rename(TemporaryPath, Path))
+		BD_LOG_WARNING("Could not replace shader program cache file {}", Path);
+}
+
 Shader::~Shader()
 {
+	GRenderState.OnProgramDeleted(m_Program);
 	glDeleteProgram(m_Program);
 }
 
 std::unique_ptr<Shader> Shader::Create(std::string_view VertexShaderPath, std::string_view FragmentShaderPath)
 {
-	auto MaybeVertexShader = LoadAndCompileShader(GL_VERTEX_SHADER, VertexShaderPath);
+	BD_PROFILE_FUNCTION();
+
+	auto VertexShaderFile = AssetArchive::MapAsset(VertexShaderPath);
+	if (!VertexShaderFile)
+	{
+		BD_LOG_ERROR("Could not load shader; file {} is unaccessible", VertexShaderPath);
+		return nullptr;
+	}
+	auto FragmentShaderFile = AssetArchive::MapAsset(FragmentShaderPath);
+	if (!FragmentShaderFile)
+	{
+		BD_LOG_ERROR("Could not load shader; file {} is unaccessible", FragmentShaderPath);
+		return nullptr;
+	}
+	std::string_view VertexShaderSource(reinterpret_cast<const char*>(VertexShaderFile->Data().data()), VertexShaderFile->Data().size());
+	std::string_view FragmentShaderSource(reinterpret_cast<const char*>(FragmentShaderFile->Data().data()), FragmentShaderFile->Data().size());
+
+	auto UseProgramCache = IsProgramCacheSupported();
+	auto CacheKey = UseProgramCache ? ComputeProgramCacheKey(VertexShaderSource, FragmentShaderSource) : 0;
+	if (UseProgramCache)
+	{
+		if (auto CachedProgram = LoadCachedProgram(CacheKey))
+		{
+			BD_LOG_DEBUG("Loaded shader program ({}, {}) from the program cache", VertexShaderPath, FragmentShaderPath);
+			return std::unique_ptr<Shader>(new Shader(*CachedProgram));
+		}
+	}
+
+	auto MaybeVertexShader = CompileShader(GL_VERTEX_SHADER, VertexShaderSource, VertexShaderPath);
 	if (!MaybeVertexShader.has_value())
 		return nullptr;
 	auto VertexShader = MaybeVertexShader.value();
 
-	auto MaybeFragmentShader = LoadAndCompileShader(GL_FRAGMENT_SHADER, FragmentShaderPath);
+	auto MaybeFragmentShader = CompileShader(GL_FRAGMENT_SHADER, FragmentShaderSource, FragmentShaderPath);
 	if (!MaybeFragmentShader.has_value())
+	{
+		glDeleteShader(VertexShader);
 		return nullptr;
+	}
 	auto FragmentShader = MaybeFragmentShader.value();
 
 	GLuint ShaderProgram = glCreateProgram();
 	glAttachShader(ShaderProgram, VertexShader);
 	glAttachShader(ShaderProgram, FragmentShader);
+	if (UseProgramCache)
+		glProgramParameteri(ShaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	glLinkProgram(ShaderProgram);
 
+	// NOTE: the program keeps what it needs, the shader objects are freed once they are detached
+	glDetachShader(ShaderProgram, VertexShader);
+	glDetachShader(ShaderProgram, FragmentShader);
+	glDeleteShader(VertexShader);
+	glDeleteShader(FragmentShader);
+
 	GLint LinkStatus;
 	glGetProgramiv(ShaderProgram, GL_LINK_STATUS, &LinkStatus);
 	if (LinkStatus)
+	{
+		if (UseProgramCache)
+			StoreProgramInCache(ShaderProgram, CacheKey);
 		return std::unique_ptr<Shader>(new Shader(ShaderProgram));
+	}
 
 	char ErrorMessage[2048];
 	glGetProgramInfoLog(ShaderProgram, sizeof(ErrorMessage) - 1, nullptr, ErrorMessage);
 	BD_LOG_ERROR("Failed to link shader program (vertex shader {}, fragment shader {})", VertexShaderPath, FragmentShaderPath);
 	BD_LOG_ERROR("{}", ErrorMessage);
 
+	glDeleteProgram(ShaderProgram);
 	return nullptr;
 }
 
 void Shader::Bind() const
 {
-	glUseProgram(m_Program);
+	GRenderState.UseProgram(m_Program);
 }
 
+GLint Shader::UniformLocation(std::string_view Name) const
+{
+	auto It = m_UniformLocations.find(Name);
+	return It != m_UniformLocations.end() ? It->second : -1;
+}
 
 Shader::Shader(GLuint Program)
 	: m_Program(Program)
 {
+	GLint UniformCount = 0;
+	GLint MaxNameLength = 0;
+	glGetProgramiv(m_Program, GL_ACTIVE_UNIFORMS, &UniformCount);
+	glGetProgramiv(m_Program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &MaxNameLength);
+
+	std::string Name(MaxNameLength, '\0');
+	for (GLint Index = 0; Index < UniformCount; Index++)
+	{
+		GLsizei NameLength = 0;
+		GLint Size = 0;
+		GLenum Type = 0;
+		glGetActiveUniform(m_Program, Index, MaxNameLength, &NameLength, &Size, &Type, Name.data());
+
+		auto UniformName = std::string(Name.data(), NameLength);
+		auto Location = glGetUniformLocation(m_Program, UniformName.c_str());
+		if (Location < 0)
+			continue;
+
+		// NOTE: arrays are reported as "Name[0]", but are just as well set through "Name"
+		if (UniformName.ends_with("[0]"))
+			m_UniformLocations.emplace(UniformName.substr(0, UniformName.size() - 3), Location);
+		m_UniformLocations.emplace(std::move(UniformName), Location);
+	}
 }
@@ -4,9 +4,12 @@
 #include <glm/fwd.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <memory>
+#include <string>
 #include <string_view>
+#include <unordered_map>
 
 #include "Core/Assert.h"
+#include "Renderer/RenderState.h"
 #include "Renderer/Texture.h"
 
 class Shader
@@ -24,16 +27,31 @@ public:
 	template<typename DataType>
 	void SetUniform(uint32_t Index, const DataType& Value);
 
+	/*
+	 * Returns -1 if the program has no active uniform with that name.
+	 */
+	GLint UniformLocation(std::string_view Name) const;
+
 private:
+	struct UniformNameHash
+	{
+		using is_transparent = void;
+
+		size_t operator()(std::string_view Name) const { return std::hash<std::string_view>()(Name); }
+	};
+
 	GLuint m_Program = 0;
 
+	// NOTE: filled in once the program is linked, looking a uniform up by its name never reaches the driver
+	std::unordered_map<std::string, GLint, UniformNameHash, std::equal_to<>> m_UniformLocations;
+
 	explicit Shader(GLuint Program);
 };
 
 template<typename DataType>
 void Shader::SetUniform(std::string_view Name, const DataType& Value)
 {
-	auto Location = glGetUniformLocation(m_Program, Name.data());
+	auto Location = UniformLocation(Name);
 	if (Location < 0)
 		return;
 
@@ -52,8 +70,7 @@ void Shader::SetUniform(uint32_t Index, const DataType& Value)
 template<>
 inline void Shader::SetUniform(uint32_t Index, const float& Value)
 {
-	Bind();
-	glUniform1fv(Index, 1, &Value);
+	glProgramUniform1fv(m_Program, Index, 1, &Value);
 }
 
 /*
@@ -62,22 +79,19 @@ inline void Shader::SetUniform(uint32_t Index, const float& Value)
 template<>
 inline void Shader::SetUniform(uint32_t Index, const glm::vec2& Value)
 {
-	Bind();
-	glUniform2fv(Index, 1, glm::value_ptr(Value));
+	glProgramUniform2fv(m_Program, Index, 1, glm::value_ptr(Value));
 }
 
 template<>
 inline void Shader::SetUniform(uint32_t Index, const glm::vec3& Value)
 {
-	Bind();
-	glUniform3fv(Index, 1, glm::value_ptr(Value));
+	glProgramUniform3fv(m_Program, Index, 1, glm::value_ptr(Value));
 }
 
 template<>
 inline void Shader::SetUniform(uint32_t Index, const glm::vec4& Value)
 {
-	Bind();
-	glUniform4fv(Index, 1, glm::value_ptr(Value));
+	glProgramUniform4fv(m_Program, Index, 1, glm::value_ptr(Value));
 }
 
 /*
@@ -86,8 +100,7 @@ inline void Shader::SetUniform(uint32_t Index, const glm::vec4& Value)
 template<>
 inline void Shader::SetUniform(uint32_t Index, const glm::mat4& Value)
 {
-	Bind();
-	glUniformMatrix4fv(Index, 1, false, glm::value_ptr(Value));
+	glProgramUniformMatrix4fv(m_Program, Index, 1, false, glm::value_ptr(Value));
 }
 
 /*
@@ -96,14 +109,6 @@ inline void Shader::SetUniform(uint32_t Index, const glm::mat4& Value)
 template<>
 inline void Shader::SetUniform(uint32_t Index, const Texture& Value)
 {
-	static constexpr uint32_t MaxTextureUnitCount = 16;
-	static uint32_t NextTextureUnit = 0;
-
-	glActiveTexture(NextTextureUnit);
-	glBindTexture(GL_TEXTURE_2D, Value.GetNativeHandle());
-
-	Bind();
-	glUniform1ui(Index, GL_TEXTURE0 + NextTextureUnit);
-
-	NextTextureUnit = (NextTextureUnit + 1) % MaxTextureUnitCount;
+	auto Unit = GRenderState.BindTexture(GL_TEXTURE_2D, Value.GetNativeHandle());
+	glProgramUniform1i(m_Program, Index, static_cast<GLint>(Unit));
 }
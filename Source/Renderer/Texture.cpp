@@ -3,34 +3,42 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
+#include "Core/AssetArchive.h"
+#include "Core/Assert.h"
+#include "Core/CookedAsset.h"
 #include "Core/Logger.h"
+#include "Renderer/RenderState.h"
 
 Texture::~Texture()
 {
+	GRenderState.OnTextureDeleted(m_Texture);
 	glDeleteTextures(1, &m_Texture);
 }
 
 std::unique_ptr<Texture> Texture::Load(std::string_view Path)
 {
-	int Width, Height, Channels;
-	auto* Image = stbi_load(Path.data(), &Width, &Height, &Channels, 0);
-
+	auto Image = LoadImage(Path);
 	if (!Image)
 		return nullptr;
 
-	if (Channels != 3 && Channels != 4)
+	return Create(Image->Dimensions, Image->ChannelCount, Image->Pixels);
+}
+
+std::unique_ptr<Texture> Texture::Create(glm::ivec2 Dimensions, uint32_t ChannelCount, std::span<const uint8_t> Pixels)
+{
+	if (ChannelCount != 3 && ChannelCount != 4)
 	{
-		BD_LOG_ERROR("Texture::Load: Unsupported number of channels: {0}", Channels);
+		BD_LOG_ERROR("Texture::Create: Unsupported number of channels: {0}", ChannelCount);
 		return nullptr;
 	}
+	BD_ASSERT(Pixels.size() == static_cast<size_t>(Dimensions.x) * Dimensions.y * ChannelCount);
 
 	GLuint Texture;
 	glGenTextures(1, &Texture);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, Texture);
+	GRenderState.BindTexture(GL_TEXTURE_2D, Texture);
 
-	GLenum Format = (Channels == 3 ? GL_RGB : GL_RGBA);
-	glTexImage2D(GL_TEXTURE_2D, 0, Format, Width, Height, 0, Format, GL_UNSIGNED_BYTE, Image);
+	GLenum Format = (ChannelCount == 3 ? GL_RGB : GL_RGBA);
+	glTexImage2D(GL_TEXTURE_2D, 0, Format, Dimensions.x, Dimensions.y, 0, Format, GL_UNSIGNED_BYTE, Pixels.data());
 	glGenerateMipmap(GL_TEXTURE_2D);
 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -38,7 +46,72 @@ std::unique_ptr<Texture> Texture::Load(std::string_view Path)
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
+	return std::unique_ptr<class Texture>(new class Texture(Texture, Dimensions));
+}
+
+std::optional<TextureImage> Texture::LoadImage(std::string_view Path)
+{
+	if (auto Cooked = CookedAsset::Open(Path, CookedAssetKind::Texture))
+	{
+		auto Header = Cooked->Read<CookedHeader>();
+		if (Header && Header->Width > 0 && Header->Height > 0)
+		{
+			auto Pixels = Cooked->ReadArray<uint8_t>(static_cast<size_t>(Header->Width) * Header->Height * Header->ChannelCount);
+			if (Pixels)
+			{
+				return TextureImage{
+					.Dimensions = { Header->Width, Header->Height },
+					.ChannelCount = Header->ChannelCount,
+					.Pixels = std::vector<uint8_t>(Pixels->begin(), Pixels->end()),
+				};
+			}
+		}
+		BD_LOG_WARNING("Cooked texture {} is corrupted, loading the source image instead", Path);
+	}
+
+	return Decode(Path);
+}
+
+std::optional<TextureImage> Texture::Decode(std::string_view Path)
+{
+	auto File = AssetArchive::MapAsset(Path);
+	if (!File)
+		return std::nullopt;
+
+	int Width, Height, Channels;
+	auto* Image = stbi_load_from_memory(File->Data().data(), static_cast<int>(File->Data().size()), &Width, &Height, &Channels, 0);
+
+	if (!Image)
+		return std::nullopt;
+
+	if (Channels != 3 && Channels != 4)
+	{
+		BD_LOG_ERROR("Texture::Decode: Unsupported number of channels: {0}", Channels);
+		stbi_image_free(Image);
+		return std::nullopt;
+	}
+
+	TextureImage Result = {
+		.Dimensions = { Width, Height },
+		.ChannelCount = static_cast<uint32_t>(Channels),
+		.Pixels = std::vector<uint8_t>(Image, Image + static_cast<size_t>(Width) * Height * Channels),
+	};
 	stbi_image_free(Image);
 
-	return std::unique_ptr<class Texture>(new class Texture(Texture, { Width, Height} ));
+	return Result;
+}
+
+bool Texture::Cook(std::string_view Path)
+{
+	auto Image = Decode(Path);
+	if (!Image)
+	{
+		BD_LOG_ERROR("Could not decode image {}", Path);
+		return false;
+	}
+
+	CookedAssetWriter Writer(CookedAssetKind::Texture);
+	Writer.Write(CookedHeader{ .Width = Image->Dimensions.x, .Height = Image->Dimensions.y, .ChannelCount = Image->ChannelCount, .Padding = 0 });
+	Writer.WriteArray(std::span<const uint8_t>(Image->Pixels));
+	return Writer.Finish(Path);
 }
@@ -2,16 +2,52 @@
 
 #include <glad/glad.h>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <vector>
 #include <glm/vec2.hpp>
 
+struct TextureImage
+{
+	glm::ivec2 Dimensions = {};
+	uint32_t ChannelCount = 0;
+	std::vector<uint8_t> Pixels;
+};
+
 class Texture
 {
 public:
 	~Texture();
 
+	/*
+	 * Loads the cooked version of the image if there is an up to date one, otherwise decodes the source image.
+	 */
 	static std::unique_ptr<Texture> Load(std::string_view Path);
 
+	static std::unique_ptr<Texture> Create(glm::ivec2 Dimensions, uint32_t ChannelCount, std::span<const uint8_t> Pixels);
+
+	/*
+	 * Returns the pixels of the cooked version of the image if there is an up to date one, otherwise decodes the source
+	 * image. Does not create any GPU resources, so it can be called from any thread.
+	 */
+	static std::optional<TextureImage> LoadImage(std::string_view Path);
+
+	static std::optional<TextureImage> Decode(std::string_view Path);
+
+	/*
+	 * Writes the decoded pixels of the source image into a cooked asset.
+	 */
+	static bool Cook(std::string_view Path);
+
+	struct CookedHeader
+	{
+		int32_t Width;
+		int32_t Height;
+		uint32_t ChannelCount;
+		uint32_t Padding;
+	};
+
 	glm::ivec2 Dimensions() { return m_Dimensions; }
 
 private:
@@ -0,0 +1,56 @@
+#include "TextureBuffer.h"
+
+#include <cstring>
+
+#include "Core/Assert.h"
+#include "Renderer/RenderState.h"
+
+TextureBuffer::~TextureBuffer()
+{
+	GRenderState.OnTextureDeleted(m_Texture);
+	glDeleteTextures(1, &m_Texture);
+}
+
+std::unique_ptr<TextureBuffer> TextureBuffer::Create(size_t Size, GLenum Format)
+{
+	auto Storage = Buffer::Create(Size, {}, GL_DYNAMIC_DRAW);
+	if (!Storage)
+		return nullptr;
+
+	GLuint Texture;
+	glGenTextures(1, &Texture);
+	GRenderState.BindTexture(0, GL_TEXTURE_BUFFER, Texture);
+	glTexBuffer(GL_TEXTURE_BUFFER, Format, Storage->GetNativeHandle());
+
+	return std::unique_ptr<TextureBuffer>(new TextureBuffer(std::move(Storage), Texture));
+}
+
+void TextureBuffer::Update(size_t Offset, size_t Size, const void* Data) const
+{
+	m_Buffer->Update(Offset, Size, Data);
+}
+
+void TextureBuffer::Replace(const void* Data, size_t Size) const
+{
+	BD_ASSERT(Size <= m_Buffer->Size());
+
+	auto* Memory = m_Buffer->MapDiscard();
+	std::memcpy(Memory, Data, Size);
+	m_Buffer->Unmap();
+}
+
+void TextureBuffer::Bind(uint32_t TextureUnit) const
+{
+	GRenderState.BindTexture(TextureUnit, GL_TEXTURE_BUFFER, m_Texture);
+}
+
+size_t TextureBuffer::Size() const
+{
+	return m_Buffer->Size();
+}
+
+TextureBuffer::TextureBuffer(std::unique_ptr<Buffer> Buffer, GLuint Texture)
+	: m_Buffer(std::move(Buffer))
+	, m_Texture(Texture)
+{
+}
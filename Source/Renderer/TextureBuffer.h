@@ -0,0 +1,42 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <memory>
+
+#include "Renderer/Buffer.h"
+
+/*
+ * A buffer that shaders read through texelFetch() on a samplerBuffer, for data that is indexed by something other than
+ * the vertex (e.g. by the segment or the instance being drawn).
+ */
+class TextureBuffer
+{
+public:
+	~TextureBuffer();
+
+	/*
+	 * Format is the sized internal format of a single texel, e.g. GL_R8UI or GL_RGBA32F.
+	 */
+	static std::unique_ptr<TextureBuffer> Create(size_t Size, GLenum Format);
+
+	/*
+	 * Overwrites a range of the buffer.
+	 */
+	void Update(size_t Offset, size_t Size, const void* Data) const;
+
+	/*
+	 * Writes Data at the start of the buffer and discards the rest of its previous contents, so it never waits for the
+	 * GPU to finish the draws that read them.
+	 */
+	void Replace(const void* Data, size_t Size) const;
+
+	void Bind(uint32_t TextureUnit) const;
+
+	size_t Size() const;
+
+private:
+	std::unique_ptr<Buffer> m_Buffer;
+	GLuint m_Texture = 0;
+
+	TextureBuffer(std::unique_ptr<Buffer> Buffer, GLuint Texture);
+};
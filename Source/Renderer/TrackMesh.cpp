@@ -0,0 +1,79 @@
+#include "TrackMesh.h"
+
+#include <algorithm>
+
+#include "Core/Assert.h"
+#include "Core/FrameStats.h"
+
+VERTEX_DESCRIPTION_BEGIN(TrackMeshVertex)
+	VERTEX_DESCRIPTION_ELEMENT(Position)
+	VERTEX_DESCRIPTION_ELEMENT(InactivePosition)
+VERTEX_DESCRIPTION_END()
+
+// NOTE: has to match the decoding in Track.vert
+static constexpr uint8_t SegmentActiveBit = 0x4;
+
+std::unique_ptr<TrackMesh> TrackMesh::Create(std::span<const TrackMeshSegment> Segments)
+{
+	BD_ASSERT(!Segments.empty());
+
+	std::vector<TrackMeshVertex> Vertices;
+	Vertices.reserve(2 * Segments.size());
+	for (const auto& Segment : Segments)
+	{
+		Vertices.push_back({ .Position = Segment.From, .InactivePosition = Segment.InactiveFrom });
+		Vertices.push_back({ .Position = Segment.To, .InactivePosition = Segment.To });
+	}
+
+	auto Geometry = GeometryBuffer<TrackMeshVertex>::Create(Vertices.size(), GeometryBufferUsage::Static, Vertices);
+	if (!Geometry)
+		return nullptr;
+
+	auto SegmentStateBuffer = TextureBuffer::Create(Segments.size(), GL_R8UI);
+	if (!SegmentStateBuffer)
+		return nullptr;
+
+	return std::unique_ptr<TrackMesh>(new TrackMesh(std::move(Geometry), std::move(SegmentStateBuffer), Segments.size()));
+}
+
+void TrackMesh::SetSegmentState(uint32_t Segment, uint32_t ColorIndex, bool IsActive)
+{
+	BD_ASSERT(Segment < m_SegmentStates.size());
+	BD_ASSERT(ColorIndex < MaxColorCount);
+
+	auto State = static_cast<uint8_t>(ColorIndex | (IsActive ? SegmentActiveBit : 0));
+	if (m_SegmentStates[Segment] == State)
+		return;
+
+	m_SegmentStates[Segment] = State;
+	m_FirstChangedSegment = std::min<size_t>(m_FirstChangedSegment, Segment);
+	m_OnePastLastChangedSegment = std::max<size_t>(m_OnePastLastChangedSegment, Segment + 1);
+}
+
+void TrackMesh::UploadSegmentStates()
+{
+	if (m_FirstChangedSegment >= m_OnePastLastChangedSegment)
+		return;
+
+	auto ChangedCount = m_OnePastLastChangedSegment - m_FirstChangedSegment;
+	m_SegmentStateBuffer->Update(m_FirstChangedSegment, ChangedCount, m_SegmentStates.data() + m_FirstChangedSegment);
+	GFrameStats.Current().TrackSegmentUploads += static_cast<uint32_t>(ChangedCount);
+
+	m_FirstChangedSegment = m_SegmentStates.size();
+	m_OnePastLastChangedSegment = 0;
+}
+
+void TrackMesh::Bind(uint32_t SegmentStateTextureUnit) const
+{
+	m_GeometryBuffer->Bind();
+	m_SegmentStateBuffer->Bind(SegmentStateTextureUnit);
+}
+
+TrackMesh::TrackMesh(std::unique_ptr<GeometryBuffer<TrackMeshVertex>> GeometryBuffer, std::unique_ptr<TextureBuffer> SegmentStateBuffer, size_t SegmentCount)
+	: m_GeometryBuffer(std::move(GeometryBuffer))
+	, m_SegmentStateBuffer(std::move(SegmentStateBuffer))
+	, m_SegmentStates(SegmentCount, 0)
+	, m_FirstChangedSegment(0)
+	, m_OnePastLastChangedSegment(SegmentCount)
+{
+}
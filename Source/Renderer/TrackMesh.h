@@ -0,0 +1,68 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "Renderer/GeometryBuffer.h"
+#include "Renderer/TextureBuffer.h"
+
+struct TrackMeshVertex
+{
+	glm::vec2 Position;
+
+	// NOTE: where the vertex is drawn while its segment is not a part of the active path
+	glm::vec2 InactivePosition;
+};
+
+struct TrackMeshSegment
+{
+	glm::vec2 From;
+	glm::vec2 To;
+
+	// NOTE: inactive segments are drawn from here to To
+	glm::vec2 InactiveFrom;
+};
+
+/*
+ * Geometry of every track segment, drawn as lines. It never changes after creation: the colour of every segment and
+ * whether it is a part of the active path are kept in a texture buffer of one byte per segment that the vertex shader
+ * reads, so a change in the state of the track only uploads the bytes that changed.
+ */
+class TrackMesh
+{
+public:
+	static constexpr uint32_t MaxColorCount = 4;
+
+	struct SegmentRange
+	{
+		uint32_t FirstSegment = 0;
+		uint32_t SegmentCount = 0;
+	};
+
+	static std::unique_ptr<TrackMesh> Create(std::span<const TrackMeshSegment> Segments);
+
+	void SetSegmentState(uint32_t Segment, uint32_t ColorIndex, bool IsActive);
+
+	/*
+	 * Uploads every segment state that was set since the last upload.
+	 */
+	void UploadSegmentStates();
+
+	/*
+	 * Binds the geometry and the segment states, the latter to the given texture unit.
+	 */
+	void Bind(uint32_t SegmentStateTextureUnit) const;
+
+private:
+	std::unique_ptr<GeometryBuffer<TrackMeshVertex>> m_GeometryBuffer;
+
+	std::unique_ptr<TextureBuffer> m_SegmentStateBuffer;
+
+	std::vector<uint8_t> m_SegmentStates;
+	size_t m_FirstChangedSegment = 0;
+	size_t m_OnePastLastChangedSegment = 0;
+
+	TrackMesh(std::unique_ptr<GeometryBuffer<TrackMeshVertex>> GeometryBuffer, std::unique_ptr<TextureBuffer> SegmentStateBuffer, size_t SegmentCount);
+};
@@ -4,7 +4,9 @@
 #include <glm/gtc/constants.hpp>
 #include <nlohmann/json.hpp>
 
+#include "Core/AssetArchive.h"
 #include "Core/Assert.h"
+#include "Core/CookedAsset.h"
 #include "Platform/File.h"
 
 VERTEX_DESCRIPTION_BEGIN(VectorIconVertex)
@@ -235,7 +237,59 @@ static bool ParseNode(const nlohmann::json& Node, VectorIconBuilder& Builder)
 	}
 }
 
+std::unique_ptr<VectorIcon> VectorIcon::Create(std::span<const VectorIconVertex> Vertices)
+{
+	BD_ASSERT(Vertices.size() % 3 == 0);
+
+	auto Geometry = ::GeometryBuffer<VectorIconVertex>::Create(Vertices.size(), GeometryBufferUsage::Static, Vertices);
+	if (!Geometry)
+		return nullptr;
+
+	std::vector<glm::vec2> Positions(Vertices.size());
+	std::ranges::transform(Vertices, Positions.begin(), [](const VectorIconVertex& Vertex) { return Vertex.Position; });
+	return std::unique_ptr<VectorIcon>(new VectorIcon(std::move(Positions), std::move(Geometry)));
+}
+
 std::unique_ptr<VectorIcon> VectorIcon::CreateFromString(std::string_view String)
+{
+	auto Vertices = Tessellate(String);
+	if (!Vertices.has_value())
+		return nullptr;
+
+	return Create(*Vertices);
+}
+
+std::unique_ptr<VectorIcon> VectorIcon::LoadFromFile(std::string_view Path)
+{
+	auto Vertices = LoadVertices(Path);
+	if (!Vertices.has_value())
+		return nullptr;
+
+	return Create(*Vertices);
+}
+
+std::optional<std::vector<VectorIconVertex>> VectorIcon::LoadVertices(std::string_view Path)
+{
+	if (auto Cooked = CookedAsset::Open(Path, CookedAssetKind::VectorIcon))
+	{
+		auto Header = Cooked->Read<CookedHeader>();
+		if (Header && Header->VertexCount % 3 == 0)
+		{
+			auto Vertices = Cooked->ReadArray<VectorIconVertex>(Header->VertexCount);
+			if (Vertices)
+				return std::vector<VectorIconVertex>(Vertices->begin(), Vertices->end());
+		}
+		BD_LOG_WARNING("Cooked vector icon {} is corrupted, loading the source instead", Path);
+	}
+
+	auto File = AssetArchive::MapAsset(Path);
+	if (!File)
+		return std::nullopt;
+
+	return Tessellate({ reinterpret_cast<const char*>(File->Data().data()), File->Data().size() });
+}
+
+std::optional<std::vector<VectorIconVertex>> VectorIcon::Tessellate(std::string_view String)
 {
 	using namespace nlohmann;
 
@@ -244,7 +298,7 @@ std::unique_ptr<VectorIcon> VectorIcon::CreateFromString(std::string_view String
 	{
 		BD_LOG_ERROR("Failed to create VectorIcon from string: no nodes array");
 		BD_LOG_DEBUG("JSON string: \n{}", String);
-		return nullptr;
+		return std::nullopt;
 	}
 
 	VectorIconBuilder Builder;
@@ -253,20 +307,32 @@ std::unique_ptr<VectorIcon> VectorIcon::CreateFromString(std::string_view String
 	for (const auto& Node : Nodes)
 	{
 		if (!ParseNode(Node, Builder))
-			return nullptr;
+			return std::nullopt;
 	}
 
-	return Builder.Build();
+	return Builder.Vertices();
 }
 
-std::unique_ptr<VectorIcon> VectorIcon::LoadFromFile(std::string_view Path)
+bool VectorIcon::Cook(std::string_view Path)
 {
-	auto MaybeContents = FileSystem::ReadFileAsString(Path);
-	if (!MaybeContents.has_value())
-		return nullptr;
+	auto File = AssetArchive::MapAsset(Path);
+	if (!File)
+	{
+		BD_LOG_ERROR("Could not read vector icon {}", Path);
+		return false;
+	}
+
+	auto Vertices = Tessellate({ reinterpret_cast<const char*>(File->Data().data()), File->Data().size() });
+	if (!Vertices.has_value())
+	{
+		BD_LOG_ERROR("Could not parse vector icon {}", Path);
+		return false;
+	}
 
-	auto String = MaybeContents.value();
-	return CreateFromString(String);
+	CookedAssetWriter Writer(CookedAssetKind::VectorIcon);
+	Writer.Write(CookedHeader{ .VertexCount = static_cast<uint32_t>(Vertices->size()), .Padding = 0 });
+	Writer.WriteArray(std::span<const VectorIconVertex>(*Vertices));
+	return Writer.Finish(Path);
 }
 
 const GeometryBuffer<VectorIconVertex>& VectorIcon::GeometryBuffer() const
@@ -338,13 +404,7 @@ void VectorIconBuilder::AddPolygon(const std::vector<glm::vec2>& Vertices, glm::
 
 std::unique_ptr<VectorIcon> VectorIconBuilder::Build() const
 {
-	auto Geometry = GeometryBuffer<VectorIconVertex>::Create(m_Vertices.size(), false, m_Vertices);
-	if (!Geometry)
-		return nullptr;
-
-	std::vector<glm::vec2> Vertices(m_Vertices.size());
-	std::ranges::transform(m_Vertices, Vertices.begin(), [](const VectorIconVertex& Vertex) { return Vertex.Position; });
-	return std::unique_ptr<VectorIcon>(new VectorIcon(Vertices, std::move(Geometry)));
+	return VectorIcon::Create(m_Vertices);
 }
 
 void VectorIconBuilder::AddTriangle(glm::vec2 V1, glm::vec2 V2, glm::vec2 V3, glm::vec4 Color)
@@ -2,6 +2,8 @@
 
 #include <glm/glm.hpp>
 #include <memory>
+#include <optional>
+#include <span>
 #include <vector>
 
 #include "Renderer/GeometryBuffer.h"
@@ -15,10 +17,33 @@ struct VectorIconVertex
 class VectorIcon
 {
 public:
+	static std::unique_ptr<VectorIcon> Create(std::span<const VectorIconVertex> Vertices);
+
 	static std::unique_ptr<VectorIcon> CreateFromString(std::string_view String);
 
+	/*
+	 * Loads the pre-tessellated cooked version of the icon if there is an up to date one, otherwise parses the source.
+	 */
 	static std::unique_ptr<VectorIcon> LoadFromFile(std::string_view Path);
 
+	/*
+	 * Returns the triangles of the icon without creating any GPU resources, so it can be called from any thread.
+	 */
+	static std::optional<std::vector<VectorIconVertex>> LoadVertices(std::string_view Path);
+
+	/*
+	 * Parses an icon description and turns it into a list of triangles, without creating any GPU resources.
+	 */
+	static std::optional<std::vector<VectorIconVertex>> Tessellate(std::string_view String);
+
+	static bool Cook(std::string_view Path);
+
+	struct CookedHeader
+	{
+		uint32_t VertexCount;
+		uint32_t Padding;
+	};
+
 	const GeometryBuffer<VectorIconVertex>& GeometryBuffer() const;
 
 	bool IsPointInside(glm::vec2 Point, const glm::mat4& TransformationMatrix) const;
@@ -29,8 +54,6 @@ private:
 	std::vector<glm::vec2> m_Vertices;
 
 	VectorIcon(std::vector<glm::vec2> Vertices, std::unique_ptr<class GeometryBuffer<VectorIconVertex>> GeometryBuffer);
-
-	friend class VectorIconBuilder;
 };
 
 class VectorIconBuilder
@@ -48,6 +71,8 @@ public:
 
 	std::unique_ptr<VectorIcon> Build() const;
 
+	const std::vector<VectorIconVertex>& Vertices() const { return m_Vertices; }
+
 private:
 	std::vector<VectorIconVertex> m_Vertices;
 
@@ -32,6 +32,20 @@ static int MouseButtonToGLFWCode(MouseButton::Button Button)
 	}
 }
 
+static Key::Key KeyFromGLFWCode(int GLFWKey)
+{
+	if (GLFWKey >= GLFW_KEY_F1 && GLFWKey <= GLFW_KEY_F12)
+		return static_cast<Key::Key>(Key::F1 + (GLFWKey - GLFW_KEY_F1));
+
+	switch (GLFWKey)
+	{
+	case GLFW_KEY_ESCAPE:
+		return Key::Escape;
+	default:
+		return Key::Unknown;
+	}
+}
+
 static void GLFWErrorCallback(int Error, const char* Description)
 {
 	BD_LOG_ERROR("GLFW error (code {}): {}", Error, Description);
@@ -132,6 +146,11 @@ void Window::AddMouseScrollCallback(std::function<MouseScrollCallbackType>&& Cal
 	m_MouseScrollCallbacks.push_back(std::move(Callback));
 }
 
+void Window::AddKeyCallback(std::function<KeyCallbackType>&& Callback)
+{
+	m_KeyCallbacks.push_back(std::move(Callback));
+}
+
 bool Window::IsMouseButtonPressed(MouseButton::Button Button) const
 {
 	return glfwGetMouseButton(m_Window, MouseButtonToGLFWCode(Button)) == GLFW_PRESS;
@@ -165,6 +184,10 @@ Window::Window(GLFWwindow* Window)
 	{
 		static_cast<class Window*>(glfwGetWindowUserPointer(GLFWWindow))->MouseButtonCallback(Button, Action);
 	});
+	glfwSetKeyCallback(m_Window, [](GLFWwindow* GLFWWindow, int Key, int, int Action, int)
+	{
+		static_cast<class Window*>(glfwGetWindowUserPointer(GLFWWindow))->KeyCallback(Key, Action);
+	});
 }
 
 void Window::MouseButtonCallback(int GLFWButton, int GLFWAction)
@@ -187,3 +210,18 @@ void Window::ScrollCallback(double YOffset)
 	for (const auto& Callback : m_MouseScrollCallbacks)
 		Callback(Offset);
 }
+
+void Window::KeyCallback(int GLFWKey, int GLFWAction)
+{
+	// NOTE: key repeats are not reported, only the initial press and the release
+	if (GLFWAction == GLFW_REPEAT)
+		return;
+
+	auto Key = KeyFromGLFWCode(GLFWKey);
+	if (Key == Key::Unknown)
+		return;
+
+	auto Type = (GLFWAction == GLFW_PRESS ? ButtonEventType::Press : ButtonEventType::Release);
+	for (const auto& Callback : m_KeyCallbacks)
+		Callback(Key, Type);
+}
@@ -36,6 +36,9 @@ public:
 	using MouseScrollCallbackType = void(int32_t);
 	void AddMouseScrollCallback(std::function<MouseScrollCallbackType>&& Callback);
 
+	using KeyCallbackType = void(Key::Key, ButtonEventType::Type);
+	void AddKeyCallback(std::function<KeyCallbackType>&& Callback);
+
 	glm::ivec2 GetCursorPosition() const;
 	glm::ivec2 GetCursorDelta() const;
 
@@ -50,6 +53,7 @@ private:
 
 	std::vector<std::function<MouseButtonCallbackType>> m_MouseButtonCallbacks;
 	std::vector<std::function<MouseScrollCallbackType>> m_MouseScrollCallbacks;
+	std::vector<std::function<KeyCallbackType>> m_KeyCallbacks;
 
 	static constexpr int s_GLVersionMajor = 4;
 	static constexpr int s_GLVersionMinor = 2;
@@ -62,4 +66,6 @@ private:
 	void MouseButtonCallback(int GLFWButton, int GLFWAction);
 
 	void ScrollCallback(double YOffset);
+
+	void KeyCallback(int GLFWKey, int GLFWAction);
 };
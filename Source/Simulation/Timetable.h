@@ -112,6 +112,8 @@ private:
 
 	TimetableState m_State = TimetableState::NotSpawned;
 
+	friend class WorldStateHistory;
+
 	void AddScoreForAction(WorldTime TimetableTime, WorldTime ActualTime, bool CorrectTrack)
 	{
 		static constexpr uint32_t BaseScoreValue = 40;
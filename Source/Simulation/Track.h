@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <bit>
 #include <cstdint>
 #include <glm/gtc/constants.hpp>
@@ -7,6 +8,7 @@
 #include <type_traits>
 
 #include "Core/Assert.h"
+#include "Core/FixedVector.h"
 
 enum class TrackDirection : uint8_t
 {
@@ -207,6 +209,13 @@ constexpr bool IsDeadEnd(TrackDirection Direction)
 		Direction == TrackDirection::W || Direction == TrackDirection::NW);
 }
 
+/*
+ * Every direction makes a valid path with at most three others (the opposite one and its two neighbors), so a tile
+ * can have at most 8 * 3 / 2 distinct paths through it.
+ */
+static constexpr size_t MaxPathsInTile = 12;
+using TrackPathList = FixedVector<TrackDirection, MaxPathsInTile>;
+
 constexpr bool AreTilesNeighbors(glm::ivec2 Lhs, glm::ivec2 Rhs)
 {
 	auto Delta = Lhs - Rhs;
@@ -255,6 +264,11 @@ struct TrackTile
 		m_State[StateArrayIndex(Direction)] = State;
 	}
 
+	constexpr bool HasSameStates(const TrackTile& Other) const
+	{
+		return std::ranges::equal(m_State, Other.m_State);
+	}
+
 	constexpr bool IsConnectedTo(const TrackTile& Other) const
 	{
 		return AreTilesNeighbors(Tile, Other.Tile) && !!(ConnectedDirections & TrackDirectionFromVector(Other.Tile - Tile));
@@ -1,12 +1,16 @@
 #include "World.h"
 
 #include <algorithm>
-#include <functional>
+#include <memory_resource>
 #include <stack>
 #include <unordered_set>
 #include <glm/ext.hpp>
 
+#include "Core/AllocationTracker.h"
 #include "Core/Assert.h"
+#include "Core/FrameArena.h"
+#include "Core/FrameStats.h"
+#include "Core/Profiler.h"
 
 static bool IsValidTurn(TrackDirection From, TrackDirection To)
 {
@@ -16,7 +20,7 @@ static bool IsValidTurn(TrackDirection From, TrackDirection To)
 }
 
 // FIXME: cache the results of this or use a lookup table
-std::vector<TrackDirection> World::ListValidPathsInTile(int32_t TileX, int32_t TileY) const
+TrackPathList World::ListValidPathsInTile(int32_t TileX, int32_t TileY) const
 {
 	const auto* Tile = FindTile(TileX, TileY);
 	if (!Tile)
@@ -25,7 +29,7 @@ std::vector<TrackDirection> World::ListValidPathsInTile(int32_t TileX, int32_t T
 	if (IsDeadEnd(Tile->ConnectedDirections))
 		return { Tile->ConnectedDirections };
 
-	std::vector<TrackDirection> Result;
+	TrackPathList Result;
 	auto Directions = Tile->ConnectedDirections;
 	ForEachExistingDirection(Directions, [&](const TrackDirection& From)
 	{
@@ -80,6 +84,7 @@ void World::AddSignal(SignalLocation Location, SignalKind Kind)
 		.Kind = Kind
 	};
 	m_Signals.push_back(NewSignal);
+	OnLayoutChanged();
 }
 
 void World::SpawnTrain(std::string ID, float Length, Timetable Timetable)
@@ -99,36 +104,82 @@ void World::SpawnTrain(std::string ID, float Length, Timetable Timetable)
 
 void World::Update(float DeltaTime)
 {
+	BD_PROFILE_FUNCTION();
+
 	auto AdjustedDeltaTime = SimulationSpeed() * DeltaTime;
 	if (AdjustedDeltaTime <= 0.0f)
 		return;
 
+	m_ScratchArena.Reset();
+
+#ifdef BD_ASSERT_NO_SIMULATION_ALLOCATIONS
+	AllocationTracker::ForbidAllocationsScope NoAllocations(m_TickCount >= SteadyStateTickCount);
+#endif
+	m_TickCount++;
+
 	m_CurrentTime += AdjustedDeltaTime;
+	GFrameStats.Current().SimulationTicks++;
 
 	// Update the state of all automatic signals as necessary
-	std::ranges::for_each(m_Signals, [this](Signal& Signal)
 	{
-		if (Signal.Kind != SignalKind::Automatic)
-			return;
+		BD_PROFILE_SCOPE("World::UpdateAutomaticSignals");
+		std::ranges::for_each(m_Signals, [this](Signal& Signal)
+		{
+			if (Signal.Kind != SignalKind::Automatic)
+				return;
 
-		if (IsBlockInFrontFullyClear(Signal))
-			Signal.State = SignalState::Clear;
-		else
-			Signal.State = SignalState::Danger;
-	});
+			if (IsBlockInFrontFullyClear(Signal))
+				Signal.State = SignalState::Clear;
+			else
+				Signal.State = SignalState::Danger;
+		});
+	}
 
 	// Reset the state of all occupied tracks to free (it is easier to recompute which tiles
 	// are occupied from scratch than use the state from the previous frame).
-	std::ranges::for_each(m_TrackTiles, [](TrackTile& Tile)
+	// NOTE: the tiles are only reported as changed if they end up in a different state than they were in before the
+	//       reset, so a train that stands still or stays within the same tiles does not change any of them
+	struct OccupiedTile
+	{
+		uint32_t Index;
+		TrackTile Before;
+	};
+	FrameArena::Scope Scratch(m_ScratchArena);
+	std::pmr::vector<OccupiedTile> PreviouslyOccupiedTiles(&m_ScratchArena);
 	{
-		ForEachExistingDirection(Tile.ConnectedDirections, [&Tile](TrackDirection Direction)
+		BD_PROFILE_SCOPE("World::ResetOccupiedTrack");
+		for (uint32_t Index = 0; Index < m_TrackTiles.size(); Index++)
 		{
-			if (Tile.State(Direction) == TrackState::Occupied)
-				Tile.SetState(Direction, TrackState::Free);
-		});
-	});
+			auto& Tile = m_TrackTiles[Index];
+			if (!Tile.HasAny(TrackState::Occupied))
+				continue;
+
+			PreviouslyOccupiedTiles.push_back({ .Index = Index, .Before = Tile });
+			ForEachExistingDirection(Tile.ConnectedDirections, [&](TrackDirection Direction)
+			{
+				if (Tile.State(Direction) == TrackState::Occupied)
+					Tile.SetState(Direction, TrackState::Free);
+			});
+		}
+	}
 
 	std::ranges::for_each(m_Trains, [&](auto& Train) { UpdateTrain(Train, AdjustedDeltaTime); });
+
+	{
+		BD_PROFILE_SCOPE("World::FindChangedOccupiedTrack");
+		auto PreviouslyOccupied = PreviouslyOccupiedTiles.begin();
+		for (uint32_t Index = 0; Index < m_TrackTiles.size(); Index++)
+		{
+			const auto& Tile = m_TrackTiles[Index];
+			auto WasOccupied = PreviouslyOccupied != PreviouslyOccupiedTiles.end() && PreviouslyOccupied->Index == Index;
+			auto HasChanged = WasOccupied ? !Tile.HasSameStates(PreviouslyOccupied->Before) : Tile.HasAny(TrackState::Occupied);
+			if (WasOccupied)
+				PreviouslyOccupied++;
+
+			if (HasChanged)
+				MarkTrackTileChanged(Tile);
+		}
+	}
 }
 
 bool World::IsPoint(int32_t TileX, int32_t TileY) const
@@ -146,7 +197,7 @@ void World::SwitchPoint(int32_t TileX, int32_t TileY)
 		return;
 
 	auto NumberOfValidPositions = static_cast<uint32_t>(ListValidPathsInTile(TileX, TileY).size());
-	Tile->SelectedPath = (Tile->SelectedPath + 1) % NumberOfValidPositions;
+	SetSelectedPath(*Tile, (Tile->SelectedPath + 1) % NumberOfValidPositions);
 }
 
 void World::SwitchSignal(SignalLocation Location)
@@ -161,19 +212,25 @@ void World::SwitchSignal(SignalLocation Location)
 
 std::optional<Route> World::TryCreateRoute(SignalLocation From, SignalLocation To)
 {
+	BD_PROFILE_FUNCTION();
+
 	auto StartTileBeforeSignal = From.FromTile;
 	auto StartTileAfterSignal = From.ToTile;
 	auto EndTile = To.FromTile;
 
-	Route Result = { .From = From, .To = To };
-	Result.Tiles.push_back(StartTileBeforeSignal);
+	FrameArena::Scope Scratch(m_ScratchArena);
+
+	// NOTE: the path is built in scratch memory and only copied into the route once the search succeeds
+	std::pmr::vector<glm::ivec2> Tiles(&m_ScratchArena);
+	Tiles.push_back(StartTileBeforeSignal);
 
 	// NOTE: using vector of bytes instead of bools here because C++23 still doesn't implement vector<bool> properly
-	std::vector<uint8_t> Visited(m_TrackTiles.size(), 0);
+	std::pmr::vector<uint8_t> Visited(m_TrackTiles.size(), 0, &m_ScratchArena);
 
 	// Do recursive DFS to find a path from StartTile to EndTile
 	// FIXME: this is a very naive implementation, we should probably use A* here
-	std::function<bool(const TrackTile*, const TrackTile*)> Search = [&](const TrackTile* Current, const TrackTile* Previous)
+	// NOTE: the lambda takes itself as a parameter to recurse without going through std::function, which might allocate
+	auto Search = [&](const auto& Search, const TrackTile* Current, const TrackTile* Previous) -> bool
 	{
 		if (Visited[Current - m_TrackTiles.data()])
 			return false;
@@ -201,24 +258,26 @@ std::optional<Route> World::TryCreateRoute(SignalLocation From, SignalLocation T
 			auto* Next = FindTile(NextTileCoords.x, NextTileCoords.y);
 			BD_ASSERT(Next);
 
-			Result.Tiles.push_back(NextTileCoords);
-			if (Search(Next, Current))
+			Tiles.push_back(NextTileCoords);
+			if (Search(Search, Next, Current))
 				return true;
-			Result.Tiles.pop_back();
+			Tiles.pop_back();
 		}
 
 		return false;
 	};
 
-	Result.Tiles.push_back(StartTileAfterSignal);
-	if (Search(FindTile(From.ToTile.x, From.ToTile.y), FindTile(StartTileBeforeSignal.x, StartTileBeforeSignal.y)))
-		return Result;
+	Tiles.push_back(StartTileAfterSignal);
+	if (Search(Search, FindTile(From.ToTile.x, From.ToTile.y), FindTile(StartTileBeforeSignal.x, StartTileBeforeSignal.y)))
+		return Route{ .From = From, .To = To, .Tiles = std::vector<glm::ivec2>(Tiles.begin(), Tiles.end()) };
 
 	return std::nullopt;
 }
 
 bool World::TryOpenRoute(const Route& Route)
 {
+	BD_PROFILE_FUNCTION();
+
 	// Checking the route is clear
 	for (size_t Index = 0; Index < Route.Tiles.size() - 1; ++Index)
 	{
@@ -255,7 +314,7 @@ bool World::TryOpenRoute(const Route& Route)
 			{
 				if (PossiblePaths[PathIndex] != Path)
 					continue;
-				From->SelectedPath = static_cast<uint32_t>(PathIndex);
+				SetSelectedPath(*From, static_cast<uint32_t>(PathIndex));
 			}
 		}
 
@@ -263,14 +322,14 @@ bool World::TryOpenRoute(const Route& Route)
 
 		// NOTE: do not reserve the little piece of track before the signal
 		if (Index != 0)
-			From->SetState(Direction, TrackState::Reserved);
-		To->SetState(OppositeDirection(Direction), TrackState::Reserved);
+			SetTrackState(*From, Direction, TrackState::Reserved);
+		SetTrackState(*To, OppositeDirection(Direction), TrackState::Reserved);
 	}
 
 	// NOTE: we need to set the state of the piece of track right before the destination signal to reserved
 	auto DestinationSignalLocation = Route.To;
 	auto* LastTile = FindTile(DestinationSignalLocation.FromTile.x, DestinationSignalLocation.FromTile.y);
-	LastTile->SetState(TrackDirectionFromVector(DestinationSignalLocation.ToTile - DestinationSignalLocation.FromTile), TrackState::Reserved);
+	SetTrackState(*LastTile, TrackDirectionFromVector(DestinationSignalLocation.ToTile - DestinationSignalLocation.FromTile), TrackState::Reserved);
 
 	auto* StartSignal = FindSignal(Route.From);
 	BD_ASSERT(StartSignal);
@@ -304,6 +363,18 @@ std::span<const Train> World::Trains() const
 	return m_Trains;
 }
 
+std::span<const uint32_t> World::ChangedTrackTiles() const
+{
+	return m_ChangedTrackTiles;
+}
+
+void World::ClearChangedTrackTiles()
+{
+	for (auto Index : m_ChangedTrackTiles)
+		m_IsTrackTileChanged[Index] = 0;
+	m_ChangedTrackTiles.clear();
+}
+
 template<typename TileBorderCallbackType, typename TileCallbackType>
 float World::MoveAlongTrack(
 	const TrackTile*& Tile, TrackDirection& Direction, float& OffsetInTile,
@@ -404,6 +475,8 @@ float World::MoveAlongTrack(
 
 void World::UpdateTrain(Train& Train, float DeltaTime)
 {
+	BD_PROFILE_FUNCTION();
+
 	if (Train.Timetable.IsPresentInTheWorld())
 	{
 		Train.Timetable.Update(DeltaTime);
@@ -539,6 +612,8 @@ void World::UpdateMovingTrain(Train& Train, float DeltaTime)
 
 void World::UpdateTrackStateForTrain(const Train& Train)
 {
+	BD_PROFILE_FUNCTION();
+
 	// Go back along the train and mark all the tiles it occupies as occupied, and propagate this state to all
 	// the tiles that are connected to the current tile and do not have a track circuit break between them
 	const auto* Tile = FindTile(Train.Tile.x, Train.Tile.y);
@@ -558,7 +633,10 @@ void World::UpdateTrackStateForTrain(const Train& Train)
 
 void World::FloodFillOccupiedTrack(TrackTile* InitialTile, TrackDirection InitialTileSegment)
 {
-	std::stack<std::pair<TrackTile*, TrackDirection>> FillStack;
+	using FillStackEntry = std::pair<TrackTile*, TrackDirection>;
+
+	FrameArena::Scope Scratch(m_ScratchArena);
+	std::stack<FillStackEntry, std::pmr::vector<FillStackEntry>> FillStack{ std::pmr::vector<FillStackEntry>(&m_ScratchArena) };
 	FillStack.emplace(InitialTile, InitialTileSegment);
 
 	int RepeatCount = 0;
@@ -573,6 +651,7 @@ void World::FloodFillOccupiedTrack(TrackTile* InitialTile, TrackDirection Initia
 			continue;
 
 		// The direction we start with is always occupied
+		// NOTE: the occupied track is compared against the previous tick in Update(), so it is not marked as changed here
 		Tile->SetState(Direction, TrackState::Occupied);
 
 		// If the current direction is not a part of active path we are done with this tile
@@ -621,6 +700,46 @@ void World::AddTrackInSingleDirection(int32_t FromX, int32_t FromY, int32_t ToX,
 	}
 
 	ExistingTile->ConnectedDirections = ExistingTile->ConnectedDirections | Direction;
+	OnLayoutChanged();
+}
+
+void World::OnLayoutChanged()
+{
+	m_LayoutRevision++;
+
+	// NOTE: whoever rebuilds after a layout change starts from the current state of every tile
+	m_ChangedTrackTiles.clear();
+	m_ChangedTrackTiles.reserve(m_TrackTiles.size());
+	m_IsTrackTileChanged.assign(m_TrackTiles.size(), 0);
+}
+
+void World::SetTrackState(TrackTile& Tile, TrackDirection Direction, TrackState State)
+{
+	if (Tile.State(Direction) == State)
+		return;
+
+	Tile.SetState(Direction, State);
+	MarkTrackTileChanged(Tile);
+}
+
+void World::SetSelectedPath(TrackTile& Tile, uint32_t SelectedPath)
+{
+	if (Tile.SelectedPath == SelectedPath)
+		return;
+
+	Tile.SelectedPath = SelectedPath;
+	MarkTrackTileChanged(Tile);
+}
+
+void World::MarkTrackTileChanged(const TrackTile& Tile)
+{
+	auto Index = static_cast<uint32_t>(&Tile - m_TrackTiles.data());
+	BD_ASSERT(Index < m_IsTrackTileChanged.size());
+	if (m_IsTrackTileChanged[Index])
+		return;
+
+	m_IsTrackTileChanged[Index] = 1;
+	m_ChangedTrackTiles.push_back(Index);
 }
 
 const TrackTile* World::FindTile(int32_t TileX, int32_t TileY) const
@@ -683,8 +802,9 @@ bool World::CanMoveToTile(const TrackTile& From, const TrackTile& To) const
 
 bool World::IsBlockInFrontFullyClear(const Signal& Signal) const
 {
-	std::vector<const TrackTile*> DFSStack;
-	std::unordered_set<const TrackTile*> VisitedTiles;
+	FrameArena::Scope Scratch(m_ScratchArena);
+	std::pmr::vector<const TrackTile*> DFSStack(&m_ScratchArena);
+	std::pmr::unordered_set<const TrackTile*> VisitedTiles(&m_ScratchArena);
 
 	auto InitialTile = FindTile(Signal.Location.ToTile);
 	DFSStack.push_back(InitialTile);
@@ -728,6 +848,7 @@ void World::OverwriteTile(const TrackTile& Tile)
 		*ExistingTile = Tile;
 	else
 		m_TrackTiles.push_back(Tile);
+	OnLayoutChanged();
 }
 
 void World::OverwriteSignal(const Signal& Signal)
@@ -735,7 +856,10 @@ void World::OverwriteSignal(const Signal& Signal)
 	if (auto* ExistingSignal = FindSignal(Signal.Location))
 		*ExistingSignal = Signal;
 	else
+	{
 		m_Signals.push_back(Signal);
+		OnLayoutChanged();
+	}
 }
 
 void World::AddTrainUnsafe(const Train& Train)
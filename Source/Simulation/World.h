@@ -4,6 +4,7 @@
 #include <span>
 #include <vector>
 
+#include "Core/FrameArena.h"
 #include "Simulation/Route.h"
 #include "Simulation/Signal.h"
 #include "Simulation/Track.h"
@@ -25,7 +26,7 @@ public:
 
 	void Update(float DeltaTime);
 
-	std::vector<TrackDirection> ListValidPathsInTile(int32_t TileX, int32_t TileY) const;
+	TrackPathList ListValidPathsInTile(int32_t TileX, int32_t TileY) const;
 
 	bool IsPoint(int32_t TileX, int32_t TileY) const;
 
@@ -43,6 +44,21 @@ public:
 	std::span<const Signal> Signals() const;
 	std::span<const Train> Trains() const;
 
+	/*
+	 * Changes whenever track or signals are added, so anything built from the layout of the world (e.g. the geometry of
+	 * the track) only has to be rebuilt when the revision changes. Indices into TrackTiles() and Signals() stay valid
+	 * for as long as the revision does.
+	 */
+	uint64_t LayoutRevision() const { return m_LayoutRevision; }
+
+	/*
+	 * Indices into TrackTiles() of the tiles whose segment states or selected path changed since the last call to
+	 * ClearChangedTrackTiles(), every tile is listed at most once.
+	 */
+	std::span<const uint32_t> ChangedTrackTiles() const;
+
+	void ClearChangedTrackTiles();
+
 	float SimulationSpeed() { return m_SimulationSpeed; }
 	void SetSimulationSpeed(float NewSpeed) { m_SimulationSpeed = NewSpeed; }
 
@@ -56,9 +72,22 @@ private:
 	std::vector<Signal> m_Signals;
 	std::vector<Train> m_Trains;
 
+	uint64_t m_LayoutRevision = 0;
+	std::vector<uint32_t> m_ChangedTrackTiles;
+	std::vector<uint8_t> m_IsTrackTileChanged;
+
 	float m_SimulationSpeed = 1.0f;
 	WorldTime m_CurrentTime;
 
+	// NOTE: with BD_ASSERT_NO_SIMULATION_ALLOCATIONS, ticks after the first SteadyStateTickCount ones must not allocate.
+	//       The warm up period leaves room for containers that grow to their working size during the first few ticks.
+	static constexpr uint64_t SteadyStateTickCount = 60;
+	uint64_t m_TickCount = 0;
+
+	// NOTE: memory for temporary containers, reset at the start of every tick. Mutable because queries which are
+	//       logically const (e.g. IsBlockInFrontFullyClear) need scratch memory too.
+	mutable FrameArena m_ScratchArena;
+
 	// NOTE: TileBorderCallbackType = bool()(const TrackTile& From, const TrackTile& To);
 	//       The callback should return true if the train can proceed to the next tile.
 	// NOTE: TileCallbackType = void()(const TrackTile& Tile, TrackDirection Segment);
@@ -81,6 +110,17 @@ private:
 
 	void AddTrackInSingleDirection(int32_t FromX, int32_t FromY, int32_t ToX, int32_t ToY);
 
+	/*
+	 * Has to be called by everything that adds, removes or replaces track tiles or signals, including deserialization.
+	 */
+	void OnLayoutChanged();
+
+	void SetTrackState(TrackTile& Tile, TrackDirection Direction, TrackState State);
+
+	void SetSelectedPath(TrackTile& Tile, uint32_t SelectedPath);
+
+	void MarkTrackTileChanged(const TrackTile& Tile);
+
 	const TrackTile* FindTile(int32_t TileX, int32_t TileY) const;
 	TrackTile* FindTile(int32_t TileX, int32_t TileY);
 	const TrackTile* FindTile(glm::ivec2 Tile) const;
@@ -101,4 +141,6 @@ private:
 	void OverrideTime(WorldTime Time);
 
 	friend class WorldSerialization;
+	friend class WorldStateHistory;
+	friend class WorldBenchmarks;
 };
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+/*
+ * On-disk layout of the binary world format. A file consists of the header followed by flat arrays of fixed-size
+ * records, one per section, and a string table that every name refers into. All records are plain data with explicit
+ * padding so that a section can be used directly from a memory-mapped file once its bounds are validated.
+ *
+ * The version has to be bumped whenever the layout of any record changes.
+ */
+namespace WorldBinaryFormat
+{
+	static_assert(std::endian::native == std::endian::little, "The binary world format is stored in little endian byte order");
+
+	static constexpr std::array<char, 4> Magic = { 'B', 'D', 'W', 'B' };
+	static constexpr uint32_t Version = 1;
+
+	// NOTE: the offset of every section is a multiple of this, so records can be read in place without unaligned accesses
+	static constexpr uint32_t SectionAlignment = 8;
+
+	struct Section
+	{
+		uint32_t Offset;
+		uint32_t Count;
+	};
+
+	struct StringRef
+	{
+		uint32_t Offset;
+		uint32_t Length;
+	};
+
+	struct Header
+	{
+		std::array<char, 4> Magic;
+		uint32_t Version;
+
+		float Time;
+		uint32_t Reserved;
+
+		Section Tiles;
+		Section Signals;
+		Section TrackAreas;
+		Section TrackAreaLocations;
+		Section Exits;
+		Section Trains;
+
+		// NOTE: Count of the string table is its size in bytes
+		Section Strings;
+	};
+
+	struct Tile
+	{
+		int32_t X;
+		int32_t Y;
+		uint32_t SelectedPath;
+		uint8_t ConnectedDirections;
+		uint8_t Padding[3];
+
+		// NOTE: indexed in the same way as TrackTile stores its states, i.e. by the index of the direction bit
+		uint8_t States[8];
+	};
+
+	struct Signal
+	{
+		int32_t FromX;
+		int32_t FromY;
+		int32_t ToX;
+		int32_t ToY;
+		uint8_t State;
+		uint8_t Kind;
+		uint8_t Padding[2];
+	};
+
+	struct TrackAreaLocation
+	{
+		int32_t FromX;
+		int32_t FromY;
+		int32_t ToX;
+		int32_t ToY;
+	};
+
+	/*
+	 * Entry and stopping points of all track areas are stored back to back in the TrackAreaLocations section.
+	 */
+	struct TrackArea
+	{
+		StringRef Name;
+		uint32_t FirstEntryPoint;
+		uint32_t EntryPointCount;
+		uint32_t FirstStoppingPoint;
+		uint32_t StoppingPointCount;
+	};
+
+	struct Exit
+	{
+		StringRef Name;
+		int32_t X;
+		int32_t Y;
+		uint8_t SpawnDirection;
+		uint8_t Padding[3];
+	};
+
+	struct Train
+	{
+		StringRef ID;
+		int32_t TileX;
+		int32_t TileY;
+		float OffsetInTile;
+		float Length;
+		uint8_t Direction;
+		uint8_t Padding[3];
+
+		float SpawnTime;
+		float ArrivalTime;
+		float DepartureTime;
+		float LeaveTime;
+		StringRef SpawnLocation;
+		StringRef PreferredTrack;
+		StringRef LeaveLocation;
+		float MinStopDuration;
+	};
+
+	static_assert(sizeof(Header) == 72);
+	static_assert(sizeof(Tile) == 24);
+	static_assert(sizeof(Signal) == 20);
+	static_assert(sizeof(TrackAreaLocation) == 16);
+	static_assert(sizeof(TrackArea) == 24);
+	static_assert(sizeof(Exit) == 20);
+	static_assert(sizeof(Train) == 72);
+}
@@ -0,0 +1,357 @@
+#include "WorldSerialization.h"
+
+#include <cstring>
+#include <unordered_map>
+
+#include "Simulation/WorldBinaryFormat.h"
+
+namespace
+{
+	class BinaryWorldWriter
+	{
+	public:
+		BinaryWorldWriter()
+		{
+			m_Buffer.resize(sizeof(WorldBinaryFormat::Header));
+		}
+
+		template<typename RecordType>
+		WorldBinaryFormat::Section AddSection(const std::vector<RecordType>& Records)
+		{
+			auto Offset = AlignBuffer();
+			auto Size = Records.size() * sizeof(RecordType);
+			m_Buffer.resize(Offset + Size);
+			if (Size > 0)
+				std::memcpy(m_Buffer.data() + Offset, Records.data(), Size);
+
+			return { .Offset = static_cast<uint32_t>(Offset), .Count = static_cast<uint32_t>(Records.size()) };
+		}
+
+		WorldBinaryFormat::StringRef AddString(std::string_view String)
+		{
+			// NOTE: names of track areas and exits are repeated in every timetable, so it's worth storing each of them only once
+			auto [It, Inserted] = m_StringRefs.try_emplace(std::string(String), WorldBinaryFormat::StringRef{});
+			if (Inserted)
+			{
+				It->second = { .Offset = static_cast<uint32_t>(m_Strings.size()), .Length = static_cast<uint32_t>(String.size()) };
+				m_Strings += String;
+			}
+			return It->second;
+		}
+
+		std::vector<uint8_t> Finish(WorldBinaryFormat::Header Header)
+		{
+			auto Offset = AlignBuffer();
+			m_Buffer.resize(Offset + m_Strings.size());
+			std::memcpy(m_Buffer.data() + Offset, m_Strings.data(), m_Strings.size());
+			Header.Strings = { .Offset = static_cast<uint32_t>(Offset), .Count = static_cast<uint32_t>(m_Strings.size()) };
+
+			std::memcpy(m_Buffer.data(), &Header, sizeof(Header));
+			return std::move(m_Buffer);
+		}
+
+	private:
+		std::vector<uint8_t> m_Buffer;
+
+		std::string m_Strings;
+		std::unordered_map<std::string, WorldBinaryFormat::StringRef> m_StringRefs;
+
+		size_t AlignBuffer()
+		{
+			auto Offset = (m_Buffer.size() + WorldBinaryFormat::SectionAlignment - 1) / WorldBinaryFormat::SectionAlignment * WorldBinaryFormat::SectionAlignment;
+			m_Buffer.resize(Offset);
+			return Offset;
+		}
+	};
+
+	class BinaryWorldReader
+	{
+	public:
+		explicit BinaryWorldReader(std::span<const uint8_t> Data)
+			: m_Data(Data)
+		{
+		}
+
+		template<typename RecordType>
+		std::optional<std::span<const RecordType>> Section(WorldBinaryFormat::Section Section) const
+		{
+			if (Section.Offset % WorldBinaryFormat::SectionAlignment != 0)
+				return std::nullopt;
+			if (static_cast<uint64_t>(Section.Offset) + static_cast<uint64_t>(Section.Count) * sizeof(RecordType) > m_Data.size())
+				return std::nullopt;
+
+			return std::span(reinterpret_cast<const RecordType*>(m_Data.data() + Section.Offset), Section.Count);
+		}
+
+		void SetStrings(std::string_view Strings) { m_Strings = Strings; }
+
+		std::optional<std::string_view> String(WorldBinaryFormat::StringRef Ref) const
+		{
+			if (static_cast<uint64_t>(Ref.Offset) + Ref.Length > m_Strings.size())
+				return std::nullopt;
+			return m_Strings.substr(Ref.Offset, Ref.Length);
+		}
+
+	private:
+		std::span<const uint8_t> m_Data;
+		std::string_view m_Strings;
+	};
+}
+
+bool WorldSerialization::IsBinary(std::string_view Source)
+{
+	return Source.size() >= WorldBinaryFormat::Magic.size() && std::equal(WorldBinaryFormat::Magic.begin(), WorldBinaryFormat::Magic.end(), Source.begin());
+}
+
+std::vector<uint8_t> WorldSerialization::SerializeBinary(const World& World)
+{
+	BinaryWorldWriter Writer;
+
+	WorldBinaryFormat::Header Header = {
+		.Magic = WorldBinaryFormat::Magic,
+		.Version = WorldBinaryFormat::Version,
+		.Time = World.CurrentTime().SecondsSinceStart(),
+	};
+
+	std::vector<WorldBinaryFormat::Tile> Tiles;
+	Tiles.reserve(World.TrackTiles().size());
+	for (const auto& Tile : World.TrackTiles())
+	{
+		WorldBinaryFormat::Tile Record = {
+			.X = Tile.Tile.x,
+			.Y = Tile.Tile.y,
+			.SelectedPath = Tile.SelectedPath,
+			.ConnectedDirections = std::to_underlying(Tile.ConnectedDirections),
+		};
+		for (uint32_t Index = 0; Index < 8; Index++)
+			Record.States[Index] = static_cast<uint8_t>(Tile.State(static_cast<TrackDirection>(1 << Index)));
+		Tiles.push_back(Record);
+	}
+	Header.Tiles = Writer.AddSection(Tiles);
+
+	std::vector<WorldBinaryFormat::Signal> Signals;
+	Signals.reserve(World.Signals().size());
+	for (const auto& Signal : World.Signals())
+	{
+		Signals.push_back({
+			.FromX = Signal.Location.FromTile.x,
+			.FromY = Signal.Location.FromTile.y,
+			.ToX = Signal.Location.ToTile.x,
+			.ToY = Signal.Location.ToTile.y,
+			.State = static_cast<uint8_t>(Signal.State),
+			.Kind = static_cast<uint8_t>(Signal.Kind),
+		});
+	}
+	Header.Signals = Writer.AddSection(Signals);
+
+	std::vector<WorldBinaryFormat::TrackArea> TrackAreas;
+	std::vector<WorldBinaryFormat::TrackAreaLocation> TrackAreaLocations;
+	auto AddLocations = [&](const std::vector<TrackAreaLocation>& Locations)
+	{
+		auto First = static_cast<uint32_t>(TrackAreaLocations.size());
+		for (const auto& Location : Locations)
+			TrackAreaLocations.push_back({ Location.TileFrom.x, Location.TileFrom.y, Location.TileTo.x, Location.TileTo.y });
+		return First;
+	};
+	for (const auto& TrackArea : World.TrackAreas())
+	{
+		WorldBinaryFormat::TrackArea Record = { .Name = Writer.AddString(TrackArea.Name) };
+		Record.FirstEntryPoint = AddLocations(TrackArea.EntryPoints);
+		Record.EntryPointCount = static_cast<uint32_t>(TrackArea.EntryPoints.size());
+		Record.FirstStoppingPoint = AddLocations(TrackArea.StoppingPoints);
+		Record.StoppingPointCount = static_cast<uint32_t>(TrackArea.StoppingPoints.size());
+		TrackAreas.push_back(Record);
+	}
+	Header.TrackAreas = Writer.AddSection(TrackAreas);
+	Header.TrackAreaLocations = Writer.AddSection(TrackAreaLocations);
+
+	std::vector<WorldBinaryFormat::Exit> Exits;
+	for (const auto& Exit : World.Exits())
+	{
+		Exits.push_back({
+			.Name = Writer.AddString(Exit.Name),
+			.X = Exit.Location.x,
+			.Y = Exit.Location.y,
+			.SpawnDirection = std::to_underlying(Exit.SpawnDirection),
+		});
+	}
+	Header.Exits = Writer.AddSection(Exits);
+
+	std::vector<WorldBinaryFormat::Train> Trains;
+	Trains.reserve(World.Trains().size());
+	for (const auto& Train : World.Trains())
+	{
+		Trains.push_back({
+			.ID = Writer.AddString(Train.ID),
+			.TileX = Train.Tile.x,
+			.TileY = Train.Tile.y,
+			.OffsetInTile = Train.OffsetInTile,
+			.Length = Train.Length,
+			.Direction = std::to_underlying(Train.Direction),
+			.SpawnTime = Train.Timetable.SpawnTime.SecondsSinceStart(),
+			.ArrivalTime = Train.Timetable.ArrivalTime.SecondsSinceStart(),
+			.DepartureTime = Train.Timetable.DepartureTime.SecondsSinceStart(),
+			.LeaveTime = Train.Timetable.LeaveTime.SecondsSinceStart(),
+			.SpawnLocation = Writer.AddString(Train.Timetable.SpawnLocation),
+			.PreferredTrack = Writer.AddString(Train.Timetable.PreferredTrack),
+			.LeaveLocation = Writer.AddString(Train.Timetable.LeaveLocation),
+			.MinStopDuration = Train.Timetable.MinStopDuration,
+		});
+	}
+	Header.Trains = Writer.AddSection(Trains);
+
+	return Writer.Finish(Header);
+}
+
+World WorldSerialization::DeserializeBinary(std::span<const uint8_t> Source)
+{
+	World Result;
+
+	// NOTE: records are read in place, which needs the same alignment as the sections have within the file. Mapped files
+	//       are always page aligned, so the copy is only made for buffers that come from elsewhere.
+	if (reinterpret_cast<uintptr_t>(Source.data()) % WorldBinaryFormat::SectionAlignment != 0)
+	{
+		std::vector<uint64_t> AlignedCopy((Source.size() + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+		std::memcpy(AlignedCopy.data(), Source.data(), Source.size());
+		return DeserializeBinary({ reinterpret_cast<const uint8_t*>(AlignedCopy.data()), Source.size() });
+	}
+
+	if (Source.size() < sizeof(WorldBinaryFormat::Header))
+	{
+		BD_LOG_WARNING("Cannot deserialize binary world: file is too small");
+		return Result;
+	}
+
+	WorldBinaryFormat::Header Header;
+	std::memcpy(&Header, Source.data(), sizeof(Header));
+	if (Header.Magic != WorldBinaryFormat::Magic || Header.Version != WorldBinaryFormat::Version)
+	{
+		BD_LOG_WARNING("Cannot deserialize binary world with version {}, expected version {}", Header.Version, WorldBinaryFormat::Version);
+		return Result;
+	}
+
+	BinaryWorldReader Reader(Source);
+	auto Tiles = Reader.Section<WorldBinaryFormat::Tile>(Header.Tiles);
+	auto Signals = Reader.Section<WorldBinaryFormat::Signal>(Header.Signals);
+	auto TrackAreas = Reader.Section<WorldBinaryFormat::TrackArea>(Header.TrackAreas);
+	auto TrackAreaLocations = Reader.Section<WorldBinaryFormat::TrackAreaLocation>(Header.TrackAreaLocations);
+	auto Exits = Reader.Section<WorldBinaryFormat::Exit>(Header.Exits);
+	auto Trains = Reader.Section<WorldBinaryFormat::Train>(Header.Trains);
+	auto Strings = Reader.Section<char>(Header.Strings);
+	if (!Tiles || !Signals || !TrackAreas || !TrackAreaLocations || !Exits || !Trains || !Strings)
+	{
+		BD_LOG_WARNING("Cannot deserialize binary world: a section is out of bounds");
+		return Result;
+	}
+	Reader.SetStrings({ Strings->data(), Strings->size() });
+
+	Result.OverrideTime(WorldTime::FromSeconds(Header.Time));
+
+	// NOTE: tiles and signals are unique by construction, so they skip the lookups that OverwriteTile and OverwriteSignal do
+	Result.m_TrackTiles.reserve(Tiles->size());
+	for (const auto& Record : *Tiles)
+	{
+		auto& Tile = Result.m_TrackTiles.emplace_back(glm::ivec2(Record.X, Record.Y), static_cast<TrackDirection>(Record.ConnectedDirections));
+		Tile.SelectedPath = Record.SelectedPath;
+		for (uint32_t Index = 0; Index < 8; Index++)
+		{
+			if (Record.States[Index] > static_cast<uint8_t>(TrackState::Occupied))
+			{
+				BD_LOG_WARNING("Invalid tile state in binary world");
+				return World();
+			}
+			Tile.SetState(static_cast<TrackDirection>(1 << Index), static_cast<TrackState>(Record.States[Index]));
+		}
+	}
+
+	Result.m_Signals.reserve(Signals->size());
+	for (const auto& Record : *Signals)
+	{
+		if (Record.State >= static_cast<uint8_t>(SignalState::_Count) || Record.Kind > static_cast<uint8_t>(SignalKind::Automatic))
+		{
+			BD_LOG_WARNING("Invalid signal description in binary world");
+			return World();
+		}
+
+		Result.m_Signals.push_back({
+			.Location = { .FromTile = { Record.FromX, Record.FromY }, .ToTile = { Record.ToX, Record.ToY } },
+			.State = static_cast<SignalState>(Record.State),
+			.Kind = static_cast<SignalKind>(Record.Kind),
+		});
+	}
+	Result.OnLayoutChanged();
+
+	auto ReadLocations = [&](uint32_t First, uint32_t Count) -> std::optional<std::vector<TrackAreaLocation>>
+	{
+		if (static_cast<uint64_t>(First) + Count > TrackAreaLocations->size())
+			return std::nullopt;
+
+		std::vector<TrackAreaLocation> Locations;
+		Locations.reserve(Count);
+		for (const auto& Location : TrackAreaLocations->subspan(First, Count))
+			Locations.push_back({ .TileFrom = { Location.FromX, Location.FromY }, .TileTo = { Location.ToX, Location.ToY } });
+		return Locations;
+	};
+
+	for (const auto& Record : *TrackAreas)
+	{
+		auto Name = Reader.String(Record.Name);
+		auto EntryPoints = ReadLocations(Record.FirstEntryPoint, Record.EntryPointCount);
+		auto StoppingPoints = ReadLocations(Record.FirstStoppingPoint, Record.StoppingPointCount);
+		if (!Name || !EntryPoints || !StoppingPoints)
+		{
+			BD_LOG_WARNING("Invalid track area description in binary world");
+			return World();
+		}
+
+		Result.AddTrackArea({ .Name = std::string(*Name), .EntryPoints = std::move(*EntryPoints), .StoppingPoints = std::move(*StoppingPoints) });
+	}
+
+	for (const auto& Record : *Exits)
+	{
+		auto Name = Reader.String(Record.Name);
+		if (!Name)
+		{
+			BD_LOG_WARNING("Invalid exit description in binary world");
+			return World();
+		}
+
+		Result.AddExit({ .Name = std::string(*Name), .Location = { Record.X, Record.Y }, .SpawnDirection = static_cast<TrackDirection>(Record.SpawnDirection) });
+	}
+
+	Result.m_Trains.reserve(Trains->size());
+	for (const auto& Record : *Trains)
+	{
+		auto ID = Reader.String(Record.ID);
+		auto SpawnLocation = Reader.String(Record.SpawnLocation);
+		auto PreferredTrack = Reader.String(Record.PreferredTrack);
+		auto LeaveLocation = Reader.String(Record.LeaveLocation);
+		if (!ID || !SpawnLocation || !PreferredTrack || !LeaveLocation)
+		{
+			BD_LOG_WARNING("Invalid train description in binary world");
+			return World();
+		}
+
+		auto Timetable = ::Timetable(
+			WorldTime::FromSeconds(Record.SpawnTime),
+			WorldTime::FromSeconds(Record.ArrivalTime),
+			WorldTime::FromSeconds(Record.DepartureTime),
+			WorldTime::FromSeconds(Record.LeaveTime),
+			std::string(*SpawnLocation),
+			std::string(*PreferredTrack),
+			std::string(*LeaveLocation),
+			Record.MinStopDuration
+		);
+
+		Result.AddTrainUnsafe({
+			.ID = std::string(*ID),
+			.Tile = { Record.TileX, Record.TileY },
+			.OffsetInTile = Record.OffsetInTile,
+			.Direction = static_cast<TrackDirection>(Record.Direction),
+			.Length = Record.Length,
+			.Timetable = std::move(Timetable),
+		});
+	}
+
+	return Result;
+}
@@ -1,456 +1,980 @@
 #include "WorldSerialization.h"
 
+#include <bit>
+#include <limits>
 #include <nlohmann/json.hpp>
+#include <optional>
 #include <ranges>
+#include <unordered_map>
+
+#include "Core/AssetArchive.h"
+#include "Core/CookedAsset.h"
+#include "Core/JSONWriter.h"
+#include "Platform/File.h"
 
 using namespace nlohmann;
 
-json SerializeMeta(const World& World)
+static const char* SignalKindToString(SignalKind Kind)
 {
-	json Result;
+	switch (Kind)
+	{
+	case SignalKind::Manual:
+		return "manual";
+	case SignalKind::Automatic:
+		return "automatic";
+	default:
+		BD_ASSERT(false);
+	}
+}
 
-	Result["time"] = World.CurrentTime().SecondsSinceStart();
+// NOTE: keys are written in alphabetical order and empty top-level collections as null, which is what the DOM based
+//       serializer (nlohmann::json::dump(4)) used to produce, so that existing files can be diffed against new ones
 
-	return Result;
+static void WriteVec2(JSONWriter& Writer, std::string_view Key, glm::ivec2 Vector)
+{
+	Writer.Key(Key);
+	Writer.BeginArray();
+	Writer.Int(Vector.x);
+	Writer.Int(Vector.y);
+	Writer.EndArray();
 }
 
-json SerializeTile(const TrackTile& Tile)
+static void WriteTrackAreaLocation(JSONWriter& Writer, const TrackAreaLocation& Location)
 {
-	json Result;
-
-	Result["coordinates"] = std::array{ Tile.Tile.x, Tile.Tile.y };
-	Result["directions"] = Tile.ConnectedDirections;
-	Result["selected_path"] = Tile.SelectedPath;
-
-	Result["states"] = json::array();
-	ForEachExistingDirection(Tile.ConnectedDirections, [&](TrackDirection Direction)
-	{
-		Result["states"].push_back(Tile.State(Direction));
-	});
-
-	return Result;
+	Writer.BeginObject();
+	WriteVec2(Writer, "from", Location.TileFrom);
+	WriteVec2(Writer, "to", Location.TileTo);
+	Writer.EndObject();
 }
 
-json SerializeTiles(const World& World)
+template<typename ElementType, typename WriteElementFuncType>
+static void WriteSection(JSONWriter& Writer, std::string_view Key, std::span<const ElementType> Elements, WriteElementFuncType&& WriteElement)
 {
-	json Result;
-
-	size_t Index = 0;
-	for (const auto& Tile : World.TrackTiles())
+	Writer.Key(Key);
+	if (Elements.empty())
 	{
-		Result[Index] = SerializeTile(Tile);
-		++Index;
+		Writer.Null();
+		return;
 	}
 
-	return Result;
+	Writer.BeginArray();
+	for (const auto& Element : Elements)
+		WriteElement(Element);
+	Writer.EndArray();
 }
 
-std::string SignalKindToString(SignalKind Kind)
+static void WriteExit(JSONWriter& Writer, const Exit& Exit)
 {
-	switch (Kind)
-	{
-	case SignalKind::Manual:
-		return "manual";
-	case SignalKind::Automatic:
-		return "automatic";
-	default:
-		BD_ASSERT(false);
-	}
+	Writer.BeginObject();
+	WriteVec2(Writer, "location", Exit.Location);
+	Writer.Key("name");
+	Writer.String(Exit.Name);
+	Writer.Key("spawn_direction");
+	Writer.String(TrackDirectionToString(Exit.SpawnDirection));
+	Writer.EndObject();
 }
 
-json SerializeSignal(const Signal& Signal)
+static void WriteSignal(JSONWriter& Writer, const Signal& Signal)
 {
-	json Result;
-
-	Result["from"] = std::array{ Signal.Location.FromTile.x, Signal.Location.FromTile.y };
-	Result["to"] = std::array{ Signal.Location.ToTile.x, Signal.Location.ToTile.y };
-	Result["state"] = Signal.State;
-	Result["kind"] = SignalKindToString(Signal.Kind);
-
-	return Result;
+	Writer.BeginObject();
+	WriteVec2(Writer, "from", Signal.Location.FromTile);
+	Writer.Key("kind");
+	Writer.String(SignalKindToString(Signal.Kind));
+	Writer.Key("state");
+	Writer.Int(static_cast<int64_t>(Signal.State));
+	WriteVec2(Writer, "to", Signal.Location.ToTile);
+	Writer.EndObject();
 }
 
-json SerializeSignals(const World& World)
+static void WriteTile(JSONWriter& Writer, const TrackTile& Tile)
 {
-	json Result;
-
-	size_t Index = 0;
-	for (const auto& Signal : World.Signals())
+	Writer.BeginObject();
+	WriteVec2(Writer, "coordinates", Tile.Tile);
+	Writer.Key("directions");
+	Writer.UInt(std::to_underlying(Tile.ConnectedDirections));
+	Writer.Key("selected_path");
+	Writer.UInt(Tile.SelectedPath);
+	Writer.Key("states");
+	Writer.BeginArray();
+	ForEachExistingDirection(Tile.ConnectedDirections, [&](TrackDirection Direction)
 	{
-		Result[Index++] = SerializeSignal(Signal);
-	}
-
-	return Result;
+		Writer.Int(static_cast<int64_t>(Tile.State(Direction)));
+	});
+	Writer.EndArray();
+	Writer.EndObject();
 }
 
-json SerializeTrackArea(const TrackArea& TrackArea)
+static void WriteTrackArea(JSONWriter& Writer, const TrackArea& TrackArea)
 {
-	json Result;
+	Writer.BeginObject();
 
-	Result["name"] = TrackArea.Name;
-	Result["entry_points"] = json::array();
+	// FIXME: stopping points have always been written into entry_points, so they come back as entry points on load. Kept
+	//        as is for now because fixing it changes the contents of every saved level.
+	Writer.Key("entry_points");
+	Writer.BeginArray();
 	for (const auto& EntryPoint : TrackArea.EntryPoints)
-	{
-		json JSONEntryPoint = {
-			{ "from", json::array({ EntryPoint.TileFrom.x, EntryPoint.TileFrom.y }) },
-			{ "to", json::array({ EntryPoint.TileTo.x, EntryPoint.TileTo.y }) },
-		};
-		Result["entry_points"].push_back(JSONEntryPoint);
-	}
-	Result["stopping_points"] = json::array();
+		WriteTrackAreaLocation(Writer, EntryPoint);
 	for (const auto& StoppingPoint : TrackArea.StoppingPoints)
-	{
-		json JSONStoppingPoint = {
-			{ "from", json::array({ StoppingPoint.TileFrom.x, StoppingPoint.TileFrom.y }) },
-			{ "to", json::array({ StoppingPoint.TileTo.x, StoppingPoint.TileTo.y }) },
-		};
-		Result["entry_points"].push_back(JSONStoppingPoint);
-	}
+		WriteTrackAreaLocation(Writer, StoppingPoint);
+	Writer.EndArray();
 
-	return Result;
+	Writer.Key("name");
+	Writer.String(TrackArea.Name);
+	Writer.Key("stopping_points");
+	Writer.BeginArray();
+	Writer.EndArray();
+
+	Writer.EndObject();
 }
 
-json SerializeTrackAreas(const World& World)
+static void WriteTimetable(JSONWriter& Writer, const Timetable& Timetable)
 {
-	json Result;
-
-	size_t Index = 0;
-	for (const auto& TrackArea : World.TrackAreas())
-	{
-		Result[Index++] = SerializeTrackArea(TrackArea);
-	}
-
-	return Result;
+	Writer.BeginObject();
+	Writer.Key("arrival_time");
+	Writer.Float(Timetable.ArrivalTime.SecondsSinceStart());
+	Writer.Key("departure_time");
+	Writer.Float(Timetable.DepartureTime.SecondsSinceStart());
+	Writer.Key("leave_location");
+	Writer.String(Timetable.LeaveLocation);
+	Writer.Key("leave_time");
+	Writer.Float(Timetable.LeaveTime.SecondsSinceStart());
+	Writer.Key("min_stop");
+	Writer.Float(Timetable.MinStopDuration);
+	Writer.Key("preferred_track");
+	Writer.String(Timetable.PreferredTrack);
+	Writer.Key("spawn_location");
+	Writer.String(Timetable.SpawnLocation);
+	Writer.Key("spawn_time");
+	Writer.Float(Timetable.SpawnTime.SecondsSinceStart());
+	Writer.EndObject();
 }
 
-json SerializeExit(const Exit& Exit)
+static void WriteTrain(JSONWriter& Writer, const Train& Train)
 {
-	json Result = {
-		{ "name", Exit.Name },
-		{ "location", json::array({ Exit.Location.x, Exit.Location.y }) },
-		{ "spawn_direction", TrackDirectionToString(Exit.SpawnDirection) }
-	};
-	return Result;
+	Writer.BeginObject();
+	Writer.Key("direction");
+	Writer.UInt(std::to_underlying(Train.Direction));
+	Writer.Key("id");
+	Writer.String(Train.ID);
+	Writer.Key("length");
+	Writer.Float(Train.Length);
+	Writer.Key("offset");
+	Writer.Float(Train.OffsetInTile);
+	WriteVec2(Writer, "tile", Train.Tile);
+	Writer.Key("timetable");
+	WriteTimetable(Writer, Train.Timetable);
+	Writer.EndObject();
 }
 
-json SerializeExits(const World& World)
+static void WriteWorld(JSONWriter& Writer, const World& World)
 {
-	json Result;
+	Writer.BeginObject();
 
-	for (const auto& Exit : World.Exits())
-		Result.push_back(SerializeExit(Exit));
+	WriteSection(Writer, "exits", World.Exits(), [&](const Exit& Exit) { WriteExit(Writer, Exit); });
 
-	return Result;
+	Writer.Key("meta");
+	Writer.BeginObject();
+	Writer.Key("time");
+	Writer.Float(World.CurrentTime().SecondsSinceStart());
+	Writer.EndObject();
+
+	WriteSection(Writer, "signals", World.Signals(), [&](const Signal& Signal) { WriteSignal(Writer, Signal); });
+	WriteSection(Writer, "tiles", World.TrackTiles(), [&](const TrackTile& Tile) { WriteTile(Writer, Tile); });
+	WriteSection(Writer, "track_areas", World.TrackAreas(), [&](const TrackArea& TrackArea) { WriteTrackArea(Writer, TrackArea); });
+	WriteSection(Writer, "trains", World.Trains(), [&](const Train& Train) { WriteTrain(Writer, Train); });
+
+	Writer.EndObject();
 }
 
-json SerializeTimetable(const Timetable& Timetable)
+std::string WorldSerialization::Serialize(const World& World, JSONWriter::Style Style)
 {
-	json Result = {
-		{ "spawn_time", Timetable.SpawnTime.SecondsSinceStart() },
-		{ "arrival_time", Timetable.ArrivalTime.SecondsSinceStart() },
-		{ "departure_time", Timetable.DepartureTime.SecondsSinceStart() },
-		{ "leave_time", Timetable.LeaveTime.SecondsSinceStart() },
-		{ "spawn_location", Timetable.SpawnLocation },
-		{ "preferred_track", Timetable.PreferredTrack },
-		{ "leave_location", Timetable.LeaveLocation },
-		{ "min_stop", Timetable.MinStopDuration },
-	};
-	return Result;
+	JSONWriter Writer(Style);
+	WriteWorld(Writer, World);
+	Writer.Finish();
+	return Writer.TakeBuffer();
 }
 
-json SerializeTrain(const Train& Train)
+bool WorldSerialization::Serialize(const World& World, File& Output, JSONWriter::Style Style)
 {
-	json Result;
-
-	Result["id"] = Train.ID;
-	Result["direction"] = Train.Direction;
-	Result["offset"] = Train.OffsetInTile;
-	Result["tile"] = std::array{ Train.Tile.x, Train.Tile.y };
-	Result["length"] = Train.Length;
-	Result["timetable"] = SerializeTimetable(Train.Timetable);
-
-	return Result;
+	JSONWriter Writer(Output, Style);
+	WriteWorld(Writer, World);
+	return Writer.Finish();
 }
 
-json SerializeTrains(const World& World)
+namespace
 {
-	json Result;
+	enum class WorldSection
+	{
+		None,
+		Meta,
+		Tiles,
+		Signals,
+		TrackAreas,
+		Exits,
+		Trains,
+	};
 
-	size_t Index = 0;
-	for (const auto& Train : World.Trains())
+	WorldSection WorldSectionFromKey(std::string_view Key)
 	{
-		Result[Index++] = SerializeTrain(Train);
+		if (Key == "meta")
+			return WorldSection::Meta;
+		if (Key == "tiles")
+			return WorldSection::Tiles;
+		if (Key == "signals")
+			return WorldSection::Signals;
+		if (Key == "track_areas")
+			return WorldSection::TrackAreas;
+		if (Key == "exits")
+			return WorldSection::Exits;
+		if (Key == "trains")
+			return WorldSection::Trains;
+		return WorldSection::None;
 	}
 
-	return Result;
-}
+	uint64_t TileKey(glm::ivec2 Tile)
+	{
+		return (static_cast<uint64_t>(static_cast<uint32_t>(Tile.x)) << 32) | static_cast<uint32_t>(Tile.y);
+	}
 
-std::string WorldSerialization::Serialize(const World& World)
-{
-	json Root;
+	struct SignalKeyHash
+	{
+		size_t operator()(const std::pair<uint64_t, uint64_t>& Key) const
+		{
+			return std::hash<uint64_t>()(Key.first * 0x9E3779B97F4A7C15ull ^ Key.second);
+		}
+	};
 
-	Root["meta"] = SerializeMeta(World);
-	Root["tiles"] = SerializeTiles(World);
-	Root["signals"] = SerializeSignals(World);
-	Root["track_areas"] = SerializeTrackAreas(World);
-	Root["exits"] = SerializeExits(World);
-	Root["trains"] = SerializeTrains(World);
+	/*
+	 * A scalar value as reported by the SAX parser. The string is only valid for the duration of the callback.
+	 */
+	struct JSONScalar
+	{
+		enum class ScalarType
+		{
+			Null,
+			Boolean,
+			Integer,
+			Unsigned,
+			Float,
+			String,
+		};
 
-	return Root.dump(4);
-}
+		ScalarType Type = ScalarType::Null;
+		int64_t Integer = 0;
+		double Float = 0.0;
+		std::string* String = nullptr;
 
-/*
- * Parses a JSON object of the form:
- * {
- *     "from": [ FromX, FromY ],
- *	   "to": [ ToX, ToY ],
- * }
- * into a pair of vectors { { FromX, FromY }, { ToX, ToY } }
- */
-std::optional<std::pair<glm::ivec2, glm::ivec2>> DeserializeFromToVecPair(const json& JSON)
-{
-	if (!JSON.contains("from") || !JSON["from"].is_array() || JSON["from"].size() != 2 ||
-		!JSON["from"][0].is_number_integer() || !JSON["from"][1].is_number_integer() ||
-		!JSON.contains("to") || !JSON["to"].is_array() || JSON["to"].size() != 2 ||
-		!JSON["to"][0].is_number_integer() || !JSON["to"][1].is_number_integer())
-	{
-		return std::nullopt;
-	}
+		bool IsNumber() const { return IsInteger() || Type == ScalarType::Float; }
+		bool IsInteger() const { return Type == ScalarType::Integer || Type == ScalarType::Unsigned; }
+		bool IsUnsigned() const { return Type == ScalarType::Unsigned; }
+		bool IsString() const { return Type == ScalarType::String; }
 
-	return std::make_pair(
-		glm::ivec2(JSON["from"][0], JSON["from"][1]),
-		glm::ivec2(JSON["to"][0], JSON["to"][1])
-	);
-}
+		float AsFloat() const { return static_cast<float>(Type == ScalarType::Float ? Float : static_cast<double>(Integer)); }
+	};
 
-std::optional<TrackTile> DeserializeTile(const json& Tile)
-{
-	if (!Tile.contains("coordinates") || !Tile["coordinates"].is_array() || Tile["coordinates"].size() != 2 ||
-		!Tile["coordinates"][0].is_number_integer() || !Tile["coordinates"][1].is_number_integer() ||
-		!Tile.contains("directions") || !Tile["directions"].is_number_unsigned() ||
-		!Tile.contains("selected_path") || !Tile["selected_path"].is_number_unsigned() ||
-		!Tile.contains("states") || !Tile["states"].is_array())
+	using JSONVec2 = std::array<std::optional<int32_t>, 2>;
+
+	struct PendingLocation
 	{
-		BD_LOG_WARNING("Invalid tile description");
-		return std::nullopt;
-	}
+		JSONVec2 From;
+		JSONVec2 To;
 
-	TrackTile Result(glm::ivec2(Tile["coordinates"][0], Tile["coordinates"][1]), Tile["directions"]);
-	Result.SelectedPath = Tile["selected_path"];
+		bool IsComplete() const { return From[0] && From[1] && To[0] && To[1]; }
+	};
 
-	size_t NextStateIndex = 0;
-	ForEachExistingDirection(Result.ConnectedDirections, [&](TrackDirection Direction)
+	struct PendingTile
 	{
-		Result.SetState(Direction, Tile["states"][NextStateIndex++]);
-	});
+		JSONVec2 Coordinates;
+		std::optional<TrackDirection> Directions;
+		std::optional<uint32_t> SelectedPath;
+		bool HasStates = false;
+		FixedVector<TrackState, 8> States;
+		bool IsValid = true;
+	};
 
-	return Result;
-}
+	struct PendingSignal
+	{
+		PendingLocation Location;
+		std::optional<SignalState> State;
+		std::optional<SignalKind> Kind;
+		bool IsValid = true;
+	};
 
-SignalKind SignalKindFromString(std::string_view SignalKind)
-{
-	if (SignalKind == "manual")
-		return SignalKind::Manual;
-	if (SignalKind == "automatic")
-		return SignalKind::Automatic;
-	BD_UNREACHABLE();
-}
+	struct PendingTrackArea
+	{
+		std::optional<std::string> Name;
+		bool HasEntryPoints = false;
+		bool HasStoppingPoints = false;
+		std::vector<TrackAreaLocation> EntryPoints;
+		std::vector<TrackAreaLocation> StoppingPoints;
+		PendingLocation CurrentLocation;
+		bool IsValid = true;
+	};
 
-std::optional<Signal> DeserializeSignal(const json& Signal)
-{
-	if (!Signal.contains("state") || !Signal["state"].is_number_unsigned())
+	struct PendingExit
 	{
-		BD_LOG_WARNING("Invalid signal description");
-		return std::nullopt;
-	}
+		std::optional<std::string> Name;
+		JSONVec2 Location;
+		std::optional<TrackDirection> SpawnDirection;
+		bool IsValid = true;
+	};
 
-	auto MaybeFromToPair = DeserializeFromToVecPair(Signal);
-	if (!MaybeFromToPair.has_value())
-		return std::nullopt;
-	auto [From, To] = MaybeFromToPair.value();
-
-	struct Signal Result = {
-		.Location = {
-			.FromTile = From,
-			.ToTile = To
-		},
-		.State = Signal["state"],
-		.Kind = SignalKindFromString(Signal["kind"])
+	struct PendingTrain
+	{
+		std::optional<std::string> ID;
+		std::optional<TrackDirection> Direction;
+		std::optional<float> OffsetInTile;
+		JSONVec2 Tile;
+		std::optional<float> Length;
+
+		std::optional<float> SpawnTime;
+		std::optional<float> ArrivalTime;
+		std::optional<float> DepartureTime;
+		std::optional<float> LeaveTime;
+		std::optional<std::string> SpawnLocation;
+		std::optional<std::string> PreferredTrack;
+		std::optional<std::string> LeaveLocation;
+		std::optional<float> MinStopDuration;
+
+		bool IsValid = true;
 	};
-	return Result;
-}
 
-std::optional<TrackArea> DeserializeTrackArea(const json& JSONTrackArea)
-{
-	if (!JSONTrackArea.contains("name") || !JSONTrackArea["name"].is_string() ||
-		!JSONTrackArea.contains("entry_points") || !JSONTrackArea["entry_points"].is_array() ||
-		!JSONTrackArea.contains("stopping_points") || !JSONTrackArea["stopping_points"].is_array())
+	void SetVec2Component(JSONVec2& Vector, uint32_t Index, const JSONScalar& Value, bool& IsValid)
 	{
-		return std::nullopt;
+		if (Index >= Vector.size() || !Value.IsInteger())
+		{
+			IsValid = false;
+			return;
+		}
+		Vector[Index] = static_cast<int32_t>(Value.Integer);
 	}
 
-	std::vector<TrackAreaLocation> EntryPoints;
-	for (const auto& EntryPoint : JSONTrackArea["entry_points"])
+	template<typename ValueType>
+	void SetNumber(std::optional<ValueType>& Target, const JSONScalar& Value, bool& IsValid)
 	{
-		auto MaybeFromToVecPair = DeserializeFromToVecPair(EntryPoint);
-		if (!MaybeFromToVecPair.has_value())
-			return std::nullopt;
-		auto [From, To] = MaybeFromToVecPair.value();
-		EntryPoints.emplace_back(From, To);
+		if (!Value.IsNumber())
+			IsValid = false;
+		else
+			Target = static_cast<ValueType>(Value.AsFloat());
 	}
 
-	std::vector<TrackAreaLocation> StoppingPoints;
-	for (const auto& StoppingPoint : JSONTrackArea["stopping_points"])
+	void SetString(std::optional<std::string>& Target, const JSONScalar& Value, bool& IsValid)
 	{
-		auto MaybeFromToVecPair = DeserializeFromToVecPair(StoppingPoint);
-		if (!MaybeFromToVecPair.has_value())
-			return std::nullopt;
-		auto [From, To] = MaybeFromToVecPair.value();
-		StoppingPoints.emplace_back(From, To);
+		if (!Value.IsString())
+			IsValid = false;
+		else
+			Target = std::move(*Value.String);
 	}
 
-	return TrackArea{
-		.Name = JSONTrackArea["name"],
-		.EntryPoints = EntryPoints,
-		.StoppingPoints = StoppingPoints
+	/*
+	 * Builds the contents of a world directly from the events of nlohmann's SAX parser, one element at a time, so that
+	 * the document never has to be held in memory as a whole. Tiles and signals are deduplicated through hash maps
+	 * rather than World::OverwriteTile/OverwriteSignal, which would make loading quadratic in the size of the level.
+	 *
+	 * The stack of open containers mirrors the structure of the document:
+	 * [0] root object -> [1] section -> [2] element of a section -> [3] array or object inside of an element -> ...
+	 */
+	class WorldJSONReader : public json_sax<json>
+	{
+	public:
+		std::optional<float> Time;
+		std::vector<TrackTile> Tiles;
+		std::vector<Signal> Signals;
+		std::vector<TrackArea> TrackAreas;
+		std::vector<Exit> Exits;
+		std::vector<Train> Trains;
+
+		WorldJSONReader()
+		{
+			m_Stack.reserve(8);
+		}
+
+		virtual bool null() override
+		{
+			return OnScalar({ .Type = JSONScalar::ScalarType::Null });
+		}
+
+		virtual bool boolean(bool Value) override
+		{
+			return OnScalar({ .Type = JSONScalar::ScalarType::Boolean, .Integer = Value });
+		}
+
+		virtual bool number_integer(number_integer_t Value) override
+		{
+			return OnScalar({ .Type = JSONScalar::ScalarType::Integer, .Integer = Value });
+		}
+
+		virtual bool number_unsigned(number_unsigned_t Value) override
+		{
+			return OnScalar({ .Type = JSONScalar::ScalarType::Unsigned, .Integer = static_cast<int64_t>(Value) });
+		}
+
+		virtual bool number_float(number_float_t Value, const string_t&) override
+		{
+			return OnScalar({ .Type = JSONScalar::ScalarType::Float, .Float = Value });
+		}
+
+		virtual bool string(string_t& Value) override
+		{
+			return OnScalar({ .Type = JSONScalar::ScalarType::String, .String = &Value });
+		}
+
+		virtual bool binary(binary_t&) override
+		{
+			return OnScalar({});
+		}
+
+		virtual bool start_object(size_t) override
+		{
+			OnContainerStart(false);
+			return true;
+		}
+
+		virtual bool key(string_t& Key) override
+		{
+			m_Stack.back().Key = Key;
+			if (m_Stack.size() == 1)
+				m_Section = WorldSectionFromKey(Key);
+			return true;
+		}
+
+		virtual bool end_object() override
+		{
+			OnContainerEnd();
+			return true;
+		}
+
+		virtual bool start_array(size_t) override
+		{
+			OnContainerStart(true);
+			return true;
+		}
+
+		virtual bool end_array() override
+		{
+			OnContainerEnd();
+			return true;
+		}
+
+		virtual bool parse_error(size_t Position, const std::string&, const detail::exception& Exception) override
+		{
+			BD_LOG_ERROR("Cannot parse world JSON at byte {}: {}", Position, Exception.what());
+			return false;
+		}
+
+	private:
+		struct Container
+		{
+			bool IsArray = false;
+			std::string Key;
+			uint32_t Index = 0;
+		};
+
+		std::vector<Container> m_Stack;
+		WorldSection m_Section = WorldSection::None;
+
+		PendingTile m_Tile;
+		PendingSignal m_Signal;
+		PendingTrackArea m_TrackArea;
+		PendingExit m_Exit;
+		PendingTrain m_Train;
+
+		std::unordered_map<uint64_t, size_t> m_TileIndices;
+		std::unordered_map<std::pair<uint64_t, uint64_t>, size_t, SignalKeyHash> m_SignalIndices;
+
+		size_t Depth() const { return m_Stack.size(); }
+		const std::string& KeyAt(size_t Level) const { return m_Stack[Level].Key; }
+		uint32_t IndexAt(size_t Level) const { return m_Stack[Level].Index; }
+
+		bool IsInsideSectionArray() const { return Depth() >= 2 && m_Stack[1].IsArray; }
+
+		void AdvanceIndex()
+		{
+			if (!m_Stack.empty() && m_Stack.back().IsArray)
+				m_Stack.back().Index++;
+		}
+
+		void OnContainerStart(bool IsArray)
+		{
+			if (Depth() == 2 && IsInsideSectionArray())
+				BeginElement();
+
+			if (Depth() == 3 && IsInsideSectionArray())
+			{
+				const auto& Key = KeyAt(2);
+				if (m_Section == WorldSection::Tiles && Key == "states")
+					m_Tile.HasStates = IsArray;
+				else if (m_Section == WorldSection::TrackAreas && Key == "entry_points")
+					m_TrackArea.HasEntryPoints = IsArray;
+				else if (m_Section == WorldSection::TrackAreas && Key == "stopping_points")
+					m_TrackArea.HasStoppingPoints = IsArray;
+			}
+
+			if (Depth() == 4 && m_Section == WorldSection::TrackAreas && IsInsideSectionArray())
+				m_TrackArea.CurrentLocation = {};
+
+			m_Stack.push_back({ .IsArray = IsArray });
+		}
+
+		void OnContainerEnd()
+		{
+			m_Stack.pop_back();
+
+			if (Depth() == 2 && IsInsideSectionArray())
+				EndElement();
+			else if (Depth() == 4 && m_Section == WorldSection::TrackAreas && IsInsideSectionArray() && m_Stack[3].IsArray)
+				EndTrackAreaLocation();
+
+			AdvanceIndex();
+		}
+
+		bool OnScalar(const JSONScalar& Value)
+		{
+			switch (m_Section)
+			{
+			case WorldSection::Meta:
+				if (Depth() == 2 && !m_Stack[1].IsArray && KeyAt(1) == "time" && Value.IsNumber())
+					Time = Value.AsFloat();
+				break;
+			case WorldSection::Tiles:
+				if (IsInsideSectionArray())
+					OnTileScalar(Value);
+				break;
+			case WorldSection::Signals:
+				if (IsInsideSectionArray())
+					OnSignalScalar(Value);
+				break;
+			case WorldSection::TrackAreas:
+				if (IsInsideSectionArray())
+					OnTrackAreaScalar(Value);
+				break;
+			case WorldSection::Exits:
+				if (IsInsideSectionArray())
+					OnExitScalar(Value);
+				break;
+			case WorldSection::Trains:
+				if (IsInsideSectionArray())
+					OnTrainScalar(Value);
+				break;
+			default:
+				break;
+			}
+
+			AdvanceIndex();
+			return true;
+		}
+
+		void OnTileScalar(const JSONScalar& Value)
+		{
+			if (Depth() == 3)
+			{
+				const auto& Key = KeyAt(2);
+				if (Key == "directions")
+				{
+					if (Value.IsUnsigned() && Value.Integer <= std::numeric_limits<uint8_t>::max())
+						m_Tile.Directions = static_cast<TrackDirection>(Value.Integer);
+					else
+						m_Tile.IsValid = false;
+				}
+				else if (Key == "selected_path")
+				{
+					if (Value.IsUnsigned())
+						m_Tile.SelectedPath = static_cast<uint32_t>(Value.Integer);
+					else
+						m_Tile.IsValid = false;
+				}
+			}
+			else if (Depth() == 4)
+			{
+				const auto& Key = KeyAt(2);
+				if (Key == "coordinates")
+				{
+					SetVec2Component(m_Tile.Coordinates, IndexAt(3), Value, m_Tile.IsValid);
+				}
+				else if (Key == "states")
+				{
+					if (Value.IsUnsigned() && Value.Integer <= static_cast<int64_t>(TrackState::Occupied) && m_Tile.States.size() < m_Tile.States.capacity())
+						m_Tile.States.push_back(static_cast<TrackState>(Value.Integer));
+					else
+						m_Tile.IsValid = false;
+				}
+			}
+		}
+
+		void OnLocationScalar(PendingLocation& Location, std::string_view Key, uint32_t Index, const JSONScalar& Value, bool& IsValid)
+		{
+			if (Key == "from")
+				SetVec2Component(Location.From, Index, Value, IsValid);
+			else if (Key == "to")
+				SetVec2Component(Location.To, Index, Value, IsValid);
+		}
+
+		void OnSignalScalar(const JSONScalar& Value)
+		{
+			if (Depth() == 3)
+			{
+				const auto& Key = KeyAt(2);
+				if (Key == "state")
+				{
+					if (Value.IsUnsigned() && Value.Integer < static_cast<int64_t>(SignalState::_Count))
+						m_Signal.State = static_cast<SignalState>(Value.Integer);
+					else
+						m_Signal.IsValid = false;
+				}
+				else if (Key == "kind")
+				{
+					if (Value.IsString() && *Value.String == "manual")
+						m_Signal.Kind = SignalKind::Manual;
+					else if (Value.IsString() && *Value.String == "automatic")
+						m_Signal.Kind = SignalKind::Automatic;
+					else
+						m_Signal.IsValid = false;
+				}
+			}
+			else if (Depth() == 4)
+			{
+				OnLocationScalar(m_Signal.Location, KeyAt(2), IndexAt(3), Value, m_Signal.IsValid);
+			}
+		}
+
+		void OnTrackAreaScalar(const JSONScalar& Value)
+		{
+			if (Depth() == 3 && KeyAt(2) == "name")
+				SetString(m_TrackArea.Name, Value, m_TrackArea.IsValid);
+			else if (Depth() == 6)
+				OnLocationScalar(m_TrackArea.CurrentLocation, KeyAt(4), IndexAt(5), Value, m_TrackArea.IsValid);
+		}
+
+		void OnExitScalar(const JSONScalar& Value)
+		{
+			if (Depth() == 3)
+			{
+				const auto& Key = KeyAt(2);
+				if (Key == "name")
+				{
+					SetString(m_Exit.Name, Value, m_Exit.IsValid);
+				}
+				else if (Key == "spawn_direction")
+				{
+					if (Value.IsString())
+						m_Exit.SpawnDirection = TrackDirectionFromString(*Value.String);
+					else
+						m_Exit.IsValid = false;
+				}
+			}
+			else if (Depth() == 4 && KeyAt(2) == "location")
+			{
+				SetVec2Component(m_Exit.Location, IndexAt(3), Value, m_Exit.IsValid);
+			}
+		}
+
+		void OnTrainScalar(const JSONScalar& Value)
+		{
+			if (Depth() == 3)
+			{
+				const auto& Key = KeyAt(2);
+				if (Key == "id")
+				{
+					SetString(m_Train.ID, Value, m_Train.IsValid);
+				}
+				else if (Key == "direction")
+				{
+					if (Value.IsUnsigned() && Value.Integer <= std::numeric_limits<uint8_t>::max())
+						m_Train.Direction = static_cast<TrackDirection>(Value.Integer);
+					else
+						m_Train.IsValid = false;
+				}
+				else if (Key == "offset")
+				{
+					SetNumber(m_Train.OffsetInTile, Value, m_Train.IsValid);
+				}
+				else if (Key == "length")
+				{
+					SetNumber(m_Train.Length, Value, m_Train.IsValid);
+				}
+			}
+			else if (Depth() == 4 && KeyAt(2) == "tile")
+			{
+				SetVec2Component(m_Train.Tile, IndexAt(3), Value, m_Train.IsValid);
+			}
+			else if (Depth() == 4 && KeyAt(2) == "timetable" && !m_Stack[3].IsArray)
+			{
+				const auto& Key = KeyAt(3);
+				if (Key == "spawn_time")
+					SetNumber(m_Train.SpawnTime, Value, m_Train.IsValid);
+				else if (Key == "arrival_time")
+					SetNumber(m_Train.ArrivalTime, Value, m_Train.IsValid);
+				else if (Key == "departure_time")
+					SetNumber(m_Train.DepartureTime, Value, m_Train.IsValid);
+				else if (Key == "leave_time")
+					SetNumber(m_Train.LeaveTime, Value, m_Train.IsValid);
+				else if (Key == "spawn_location")
+					SetString(m_Train.SpawnLocation, Value, m_Train.IsValid);
+				else if (Key == "preferred_track")
+					SetString(m_Train.PreferredTrack, Value, m_Train.IsValid);
+				else if (Key == "leave_location")
+					SetString(m_Train.LeaveLocation, Value, m_Train.IsValid);
+				else if (Key == "min_stop")
+					SetNumber(m_Train.MinStopDuration, Value, m_Train.IsValid);
+			}
+		}
+
+		void BeginElement()
+		{
+			switch (m_Section)
+			{
+			case WorldSection::Tiles:
+				m_Tile = {};
+				break;
+			case WorldSection::Signals:
+				m_Signal = {};
+				break;
+			case WorldSection::TrackAreas:
+				m_TrackArea = {};
+				break;
+			case WorldSection::Exits:
+				m_Exit = {};
+				break;
+			case WorldSection::Trains:
+				m_Train = {};
+				break;
+			default:
+				break;
+			}
+		}
+
+		void EndElement()
+		{
+			switch (m_Section)
+			{
+			case WorldSection::Tiles:
+				EndTile();
+				break;
+			case WorldSection::Signals:
+				EndSignal();
+				break;
+			case WorldSection::TrackAreas:
+				EndTrackArea();
+				break;
+			case WorldSection::Exits:
+				EndExit();
+				break;
+			case WorldSection::Trains:
+				EndTrain();
+				break;
+			default:
+				break;
+			}
+		}
+
+		void EndTile()
+		{
+			if (!m_Tile.IsValid || !m_Tile.Coordinates[0] || !m_Tile.Coordinates[1] || !m_Tile.Directions || !m_Tile.SelectedPath || !m_Tile.HasStates ||
+				m_Tile.States.size() < static_cast<size_t>(std::popcount(std::to_underlying(*m_Tile.Directions))))
+			{
+				BD_LOG_WARNING("Invalid tile description");
+				return;
+			}
+
+			TrackTile Tile(glm::ivec2(*m_Tile.Coordinates[0], *m_Tile.Coordinates[1]), *m_Tile.Directions);
+			Tile.SelectedPath = *m_Tile.SelectedPath;
+
+			size_t NextStateIndex = 0;
+			ForEachExistingDirection(Tile.ConnectedDirections, [&](TrackDirection Direction)
+			{
+				Tile.SetState(Direction, m_Tile.States[NextStateIndex++]);
+			});
+
+			auto [It, Inserted] = m_TileIndices.try_emplace(TileKey(Tile.Tile), Tiles.size());
+			if (Inserted)
+				Tiles.push_back(Tile);
+			else
+				Tiles[It->second] = Tile;
+		}
+
+		void EndSignal()
+		{
+			if (!m_Signal.IsValid || !m_Signal.Location.IsComplete() || !m_Signal.State || !m_Signal.Kind)
+			{
+				BD_LOG_WARNING("Invalid signal description");
+				return;
+			}
+
+			Signal Signal = {
+				.Location = {
+					.FromTile = { *m_Signal.Location.From[0], *m_Signal.Location.From[1] },
+					.ToTile = { *m_Signal.Location.To[0], *m_Signal.Location.To[1] },
+				},
+				.State = *m_Signal.State,
+				.Kind = *m_Signal.Kind,
+			};
+
+			auto [It, Inserted] = m_SignalIndices.try_emplace({ TileKey(Signal.Location.FromTile), TileKey(Signal.Location.ToTile) }, Signals.size());
+			if (Inserted)
+				Signals.push_back(Signal);
+			else
+				Signals[It->second] = Signal;
+		}
+
+		void EndTrackAreaLocation()
+		{
+			const auto& Location = m_TrackArea.CurrentLocation;
+			if (!Location.IsComplete())
+			{
+				m_TrackArea.IsValid = false;
+				return;
+			}
+
+			TrackAreaLocation Result = {
+				.TileFrom = { *Location.From[0], *Location.From[1] },
+				.TileTo = { *Location.To[0], *Location.To[1] },
+			};
+
+			const auto& ListKey = KeyAt(2);
+			if (ListKey == "entry_points")
+				m_TrackArea.EntryPoints.push_back(Result);
+			else if (ListKey == "stopping_points")
+				m_TrackArea.StoppingPoints.push_back(Result);
+		}
+
+		void EndTrackArea()
+		{
+			if (!m_TrackArea.IsValid || !m_TrackArea.Name || !m_TrackArea.HasEntryPoints || !m_TrackArea.HasStoppingPoints)
+			{
+				BD_LOG_WARNING("Invalid track area description");
+				return;
+			}
+
+			TrackAreas.push_back({
+				.Name = std::move(*m_TrackArea.Name),
+				.EntryPoints = std::move(m_TrackArea.EntryPoints),
+				.StoppingPoints = std::move(m_TrackArea.StoppingPoints),
+			});
+		}
+
+		void EndExit()
+		{
+			if (!m_Exit.IsValid || !m_Exit.Name || !m_Exit.Location[0] || !m_Exit.Location[1] || !m_Exit.SpawnDirection)
+			{
+				BD_LOG_WARNING("Invalid exit description");
+				return;
+			}
+
+			Exits.push_back({
+				.Name = std::move(*m_Exit.Name),
+				.Location = { *m_Exit.Location[0], *m_Exit.Location[1] },
+				.SpawnDirection = *m_Exit.SpawnDirection,
+			});
+		}
+
+		void EndTrain()
+		{
+			auto& Pending = m_Train;
+			if (!Pending.IsValid || !Pending.ID || !Pending.Direction || !Pending.OffsetInTile || !Pending.Tile[0] || !Pending.Tile[1] || !Pending.Length ||
+				!Pending.SpawnTime || !Pending.ArrivalTime || !Pending.DepartureTime || !Pending.LeaveTime ||
+				!Pending.SpawnLocation || !Pending.PreferredTrack || !Pending.LeaveLocation || !Pending.MinStopDuration)
+			{
+				BD_LOG_WARNING("Invalid train description");
+				return;
+			}
+
+			auto Timetable = ::Timetable(
+				WorldTime::FromSeconds(*Pending.SpawnTime),
+				WorldTime::FromSeconds(*Pending.ArrivalTime),
+				WorldTime::FromSeconds(*Pending.DepartureTime),
+				WorldTime::FromSeconds(*Pending.LeaveTime),
+				std::move(*Pending.SpawnLocation),
+				std::move(*Pending.PreferredTrack),
+				std::move(*Pending.LeaveLocation),
+				*Pending.MinStopDuration
+			);
+
+			Trains.push_back({
+				.ID = std::move(*Pending.ID),
+				.Tile = { *Pending.Tile[0], *Pending.Tile[1] },
+				.OffsetInTile = *Pending.OffsetInTile,
+				.Direction = *Pending.Direction,
+				.Length = *Pending.Length,
+				.Timetable = std::move(Timetable),
+			});
+		}
 	};
 }
 
-std::optional<Exit> DeserializeExit(const json& JSONExit)
+World WorldSerialization::Deserialize(std::string_view Source)
 {
-	if (!JSONExit.contains("name") || !JSONExit["name"].is_string() ||
-		!JSONExit.contains("location") || !JSONExit["location"].is_array() ||
-		JSONExit["location"].size() != 2 ||
-		!JSONExit["location"][0].is_number_integer() || !JSONExit["location"][1].is_number_integer() ||
-		!JSONExit.contains("spawn_direction") || !JSONExit["spawn_direction"].is_string())
-	{
-		return std::nullopt;
-	}
-
-	return Exit{
-		.Name = JSONExit["name"],
-		.Location = { JSONExit["location"][0], JSONExit["location"][1] },
-		.SpawnDirection = TrackDirectionFromString(JSONExit["spawn_direction"])
-	};
+	if (IsBinary(Source))
+		return DeserializeBinary({ reinterpret_cast<const uint8_t*>(Source.data()), Source.size() });
+	return DeserializeJSON(Source);
 }
 
-std::optional<Timetable> DeserializeTimetable(const json& JSONTimetable)
+World WorldSerialization::DeserializeFromFile(std::string_view Path)
 {
-	if (!JSONTimetable.contains("spawn_time") || !JSONTimetable["spawn_time"].is_number() ||
-		!JSONTimetable.contains("arrival_time") || !JSONTimetable["arrival_time"].is_number() ||
-		!JSONTimetable.contains("departure_time") || !JSONTimetable["departure_time"].is_number() ||
-		!JSONTimetable.contains("leave_time") || !JSONTimetable["leave_time"].is_number() ||
-		!JSONTimetable.contains("spawn_location") || !JSONTimetable["spawn_location"].is_string() ||
-		!JSONTimetable.contains("preferred_track") || !JSONTimetable["preferred_track"].is_string() ||
-		!JSONTimetable.contains("leave_location") || !JSONTimetable["leave_location"].is_string() ||
-		!JSONTimetable.contains("min_stop") || !JSONTimetable["min_stop"].is_number())
+	if (auto Cooked = CookedAsset::Open(Path, CookedAssetKind::Level))
+		return DeserializeBinary(Cooked->ReadRemaining());
+
+	auto File = AssetArchive::MapAsset(Path);
+	if (!File)
 	{
-		return std::nullopt;
+		BD_LOG_ERROR("Cannot open world file {}", Path);
+		return World();
 	}
 
-	auto Result = Timetable(
-		WorldTime::FromSeconds(JSONTimetable["spawn_time"]),
-		WorldTime::FromSeconds(JSONTimetable["arrival_time"]),
-		WorldTime::FromSeconds(JSONTimetable["departure_time"]),
-		WorldTime::FromSeconds(JSONTimetable["leave_time"]),
-		JSONTimetable["spawn_location"],
-		JSONTimetable["preferred_track"],
-		JSONTimetable["leave_location"],
-		JSONTimetable["min_stop"]
-	);
-	return Result;
+	auto Data = File->Data();
+	return Deserialize({ reinterpret_cast<const char*>(Data.data()), Data.size() });
 }
 
-std::optional<Train> DeserializeTrain(const json& Train)
+bool WorldSerialization::Cook(std::string_view Path)
 {
-	if (!Train.contains("id") || !Train["id"].is_string() ||
-		!Train.contains("direction") || !Train["direction"].is_number_unsigned() ||
-		!Train.contains("offset") || !Train["offset"].is_number() ||
-		!Train.contains("tile") || !Train["tile"].is_array() || Train["tile"].size() != 2 ||
-		!Train["tile"][0].is_number() || !Train["tile"][1].is_number() ||
-		!Train.contains("length") || !Train["length"].is_number() ||
-		!Train.contains("timetable") || !Train["timetable"].is_object())
+	auto File = AssetArchive::MapAsset(Path);
+	if (!File)
 	{
-		return std::nullopt;
+		BD_LOG_ERROR("Cannot open world file {}", Path);
+		return false;
 	}
 
-	auto Timetable = DeserializeTimetable(Train["timetable"]);
-	if (!Timetable.has_value())
-		return std::nullopt;
-
-	struct Train Result = {
-		.ID = Train["id"],
-		.Tile = { Train["tile"][0], Train["tile"][1] },
-		.OffsetInTile = Train["offset"],
-		.Direction = Train["direction"],
-		.Length = Train["length"],
-		.Timetable = Timetable.value(),
-	};
-	return Result;
+	auto Data = File->Data();
+	auto World = Deserialize({ reinterpret_cast<const char*>(Data.data()), Data.size() });
+	if (World.TrackTiles().empty())
+	{
+		BD_LOG_ERROR("World file {} is invalid or contains no track", Path);
+		return false;
+	}
+
+	auto Binary = SerializeBinary(World);
+
+	CookedAssetWriter Writer(CookedAssetKind::Level);
+	Writer.WriteArray(std::span<const uint8_t>(Binary));
+	return Writer.Finish(Path);
 }
 
-World WorldSerialization::Deserialize(std::string_view Source)
+World WorldSerialization::DeserializeJSON(std::string_view Source)
 {
 	World Result;
 
-	json Root = json::parse(Source);
+	WorldJSONReader Reader;
+	if (!json::sax_parse(Source.begin(), Source.end(), &Reader))
+		return Result;
 
-	if (!Root.contains("meta") || !Root["meta"].contains("time"))
+	if (!Reader.Time.has_value())
 	{
 		BD_LOG_WARNING("Cannot deserialize world with invalid metadata");
 		return Result;
 	}
-	Result.OverrideTime(WorldTime::FromSeconds(Root["meta"]["time"]));
+	Result.OverrideTime(WorldTime::FromSeconds(Reader.Time.value()));
 
-	if (Root.contains("tiles"))
-	{
-		for (const auto& Tile : Root["tiles"])
-		{
-			auto NewTile = DeserializeTile(Tile);
-			if (NewTile.has_value())
-				Result.OverwriteTile(NewTile.value());
-		}
-	}
+	Result.m_TrackTiles = std::move(Reader.Tiles);
+	Result.m_Signals = std::move(Reader.Signals);
+	Result.OnLayoutChanged();
 
-	if (Root.contains("signals"))
-	{
-		for (const auto& Signal : Root["signals"])
-		{
-			auto NewSignal = DeserializeSignal(Signal);
-			if (NewSignal.has_value())
-				Result.OverwriteSignal(NewSignal.value());
-		}
-	}
+	for (auto& TrackArea : Reader.TrackAreas)
+		Result.AddTrackArea(std::move(TrackArea));
 
-	if (Root.contains("track_areas"))
-	{
-		for (const auto& TrackArea : Root["track_areas"])
-		{
-			auto NewTrackArea = DeserializeTrackArea(TrackArea);
-			if (NewTrackArea.has_value())
-				Result.AddTrackArea(NewTrackArea.value());
-		}
-	}
+	for (auto& Exit : Reader.Exits)
+		Result.AddExit(std::move(Exit));
 
-	if (Root.contains("exits"))
-	{
-		for (const auto& Exit : Root["exits"])
-		{
-			auto NewExit = DeserializeExit(Exit);
-			if (NewExit.has_value())
-				Result.AddExit(NewExit.value());
-		}
-	}
-
-	if (Root.contains("trains"))
-	{
-		for (const auto& Train : Root["trains"])
-		{
-			auto NewTrain = DeserializeTrain(Train);
-			if (NewTrain.has_value())
-				Result.AddTrainUnsafe(NewTrain.value()); // FIXME: make it safe :)
-		}
-	}
+	for (const auto& Train : Reader.Trains)
+		Result.AddTrainUnsafe(Train); // FIXME: make it safe :)
 
 	return Result;
 }
@@ -1,13 +1,42 @@
 #pragma once
 
+#include <span>
 #include <string>
+#include <vector>
 
+#include "Core/JSONWriter.h"
+#include "Platform/File.h"
 #include "Simulation/World.h"
 
+/*
+ * JSON is the authoring and interchange format of worlds. The binary format (see WorldBinaryFormat.h) is a compact
+ * alternative for large levels and saves; Deserialize() accepts either and picks the right one by the file magic.
+ */
 class WorldSerialization
 {
 public:
-	static std::string Serialize(const World& World);
+	static std::string Serialize(const World& World, JSONWriter::Style Style = JSONWriter::Style::Indented);
+
+	static bool Serialize(const World& World, File& Output, JSONWriter::Style Style = JSONWriter::Style::Indented);
+
+	static std::vector<uint8_t> SerializeBinary(const World& World);
 
 	static World Deserialize(std::string_view Source);
+
+	/*
+	 * Loads the cooked (binary) version of the level if there is an up to date one, otherwise the file itself.
+	 */
+	static World DeserializeFromFile(std::string_view Path);
+
+	/*
+	 * Converts a level into the binary format and writes it as a cooked asset.
+	 */
+	static bool Cook(std::string_view Path);
+
+private:
+	static bool IsBinary(std::string_view Source);
+
+	static World DeserializeJSON(std::string_view Source);
+
+	static World DeserializeBinary(std::span<const uint8_t> Source);
 };
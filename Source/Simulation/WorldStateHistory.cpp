@@ -0,0 +1,424 @@
+#include "WorldStateHistory.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "Core/Logger.h"
+#include "Simulation/WorldSerialization.h"
+
+namespace
+{
+	static constexpr std::array<char, 4> Magic = { 'B', 'D', 'W', 'H' };
+	static constexpr uint32_t Version = 1;
+
+	struct Header
+	{
+		std::array<char, 4> Magic;
+		uint32_t Version;
+		uint32_t KeyframeInterval;
+		uint32_t SnapshotCount;
+		uint32_t BaseSize;
+		uint32_t TileCount;
+		uint32_t SignalCount;
+		uint32_t TrainCount;
+	};
+
+	struct SnapshotHeader
+	{
+		float Time;
+		uint32_t TileChangeCount;
+		uint32_t SignalChangeCount;
+		uint32_t TrainChangeCount;
+	};
+
+	class HistoryWriter
+	{
+	public:
+		template<typename ValueType>
+		void Write(const ValueType& Value)
+		{
+			Write(std::span<const ValueType>(&Value, 1));
+		}
+
+		template<typename ValueType>
+		void Write(std::span<const ValueType> Values)
+		{
+			auto Offset = m_Buffer.size();
+			m_Buffer.resize(Offset + Values.size_bytes());
+			if (!Values.empty())
+				std::memcpy(m_Buffer.data() + Offset, Values.data(), Values.size_bytes());
+		}
+
+		std::vector<uint8_t> Finish() { return std::move(m_Buffer); }
+
+	private:
+		std::vector<uint8_t> m_Buffer;
+	};
+
+	class HistoryReader
+	{
+	public:
+		explicit HistoryReader(std::span<const uint8_t> Data)
+			: m_Data(Data)
+		{
+		}
+
+		template<typename ValueType>
+		bool Read(ValueType& Value)
+		{
+			return Read(std::span<ValueType>(&Value, 1));
+		}
+
+		template<typename ValueType>
+		bool Read(std::span<ValueType> Values)
+		{
+			if (Values.size_bytes() > m_Data.size())
+				return false;
+			if (!Values.empty())
+				std::memcpy(Values.data(), m_Data.data(), Values.size_bytes());
+			m_Data = m_Data.subspan(Values.size_bytes());
+			return true;
+		}
+
+		template<typename ValueType>
+		bool Read(std::vector<ValueType>& Values, uint32_t Count)
+		{
+			if (static_cast<uint64_t>(Count) * sizeof(ValueType) > m_Data.size())
+				return false;
+			Values.resize(Count);
+			return Read(std::span(Values));
+		}
+
+		std::optional<std::span<const uint8_t>> Skip(size_t Size)
+		{
+			if (Size > m_Data.size())
+				return std::nullopt;
+			auto Result = m_Data.first(Size);
+			m_Data = m_Data.subspan(Size);
+			return Result;
+		}
+
+		bool IsAtEnd() const { return m_Data.empty(); }
+
+	private:
+		std::span<const uint8_t> m_Data;
+	};
+}
+
+WorldStateHistory::WorldStateHistory(const World& Base)
+	: m_Base(Base)
+	, m_Latest(CaptureState(Base))
+{
+}
+
+bool WorldStateHistory::Record(const World& World)
+{
+	if (!HasSameTopology(World))
+		return false;
+
+	bool IsKeyframe = (m_Snapshots.size() % KeyframeInterval == 0);
+	auto& Snapshot = m_Snapshots.emplace_back();
+	Snapshot.Time = World.CurrentTime().SecondsSinceStart();
+	m_Latest.Time = Snapshot.Time;
+
+	for (uint32_t Index = 0; Index < World.m_TrackTiles.size(); Index++)
+	{
+		auto Tile = CaptureTile(World.m_TrackTiles[Index]);
+		if (Tile == m_Latest.Tiles[Index])
+			continue;
+
+		m_Latest.Tiles[Index] = Tile;
+		if (!IsKeyframe)
+			Snapshot.Tiles.push_back({ .Index = Index, .State = Tile });
+	}
+
+	for (uint32_t Index = 0; Index < World.m_Signals.size(); Index++)
+	{
+		auto State = static_cast<uint8_t>(World.m_Signals[Index].State);
+		if (State == m_Latest.Signals[Index])
+			continue;
+
+		m_Latest.Signals[Index] = State;
+		if (!IsKeyframe)
+			Snapshot.Signals.push_back({ .Index = Index, .State = State });
+	}
+
+	for (uint32_t Index = 0; Index < World.m_Trains.size(); Index++)
+	{
+		auto Train = CaptureTrain(World.m_Trains[Index], World.m_TrackAreas);
+		if (Train == m_Latest.Trains[Index])
+			continue;
+
+		m_Latest.Trains[Index] = Train;
+		if (!IsKeyframe)
+			Snapshot.Trains.push_back({ .Index = Index, .State = Train });
+	}
+
+	if (IsKeyframe)
+		m_Keyframes.push_back(m_Latest);
+
+	return true;
+}
+
+World WorldStateHistory::Reconstruct(size_t SnapshotIndex) const
+{
+	BD_ASSERT(SnapshotIndex < m_Snapshots.size());
+
+	auto State = ReconstructState(SnapshotIndex);
+	World Result = m_Base;
+
+	Result.OverrideTime(WorldTime::FromSeconds(State.Time));
+
+	for (size_t Index = 0; Index < State.Tiles.size(); Index++)
+	{
+		auto& Tile = Result.m_TrackTiles[Index];
+		Tile.SelectedPath = State.Tiles[Index].SelectedPath;
+		for (uint32_t Direction = 0; Direction < 8; Direction++)
+			Tile.SetState(static_cast<TrackDirection>(1 << Direction), static_cast<TrackState>((State.Tiles[Index].States >> (2 * Direction)) & 0x3));
+	}
+
+	for (size_t Index = 0; Index < State.Signals.size(); Index++)
+		Result.m_Signals[Index].State = static_cast<SignalState>(State.Signals[Index]);
+
+	for (size_t Index = 0; Index < State.Trains.size(); Index++)
+	{
+		const auto& TrainState = State.Trains[Index];
+		auto& Train = Result.m_Trains[Index];
+		Train.Tile = { TrainState.TileX, TrainState.TileY };
+		Train.OffsetInTile = TrainState.OffsetInTile;
+		Train.Direction = static_cast<TrackDirection>(TrainState.Direction);
+		Train.Score = TrainState.Score;
+		Train.IsMoving = TrainState.IsMoving;
+		Train.Timetable.m_State = static_cast<TimetableState>(TrainState.TimetableState);
+		Train.Timetable.m_StoppingTime = TrainState.StoppingTime;
+		Train.Timetable.m_AccumulatedScore = TrainState.AccumulatedScore;
+		Train.CurrentArea = TrainState.CurrentArea >= 0 ? &Result.m_TrackAreas[TrainState.CurrentArea] : nullptr;
+	}
+
+	return Result;
+}
+
+std::vector<uint8_t> WorldStateHistory::Serialize() const
+{
+	// NOTE: the base is only needed for the topology, its mutable state is overridden by the first keyframe
+	auto Base = WorldSerialization::SerializeBinary(m_Base);
+
+	HistoryWriter Writer;
+	Writer.Write(Header{
+		.Magic = Magic,
+		.Version = Version,
+		.KeyframeInterval = static_cast<uint32_t>(KeyframeInterval),
+		.SnapshotCount = static_cast<uint32_t>(m_Snapshots.size()),
+		.BaseSize = static_cast<uint32_t>(Base.size()),
+		.TileCount = static_cast<uint32_t>(m_Latest.Tiles.size()),
+		.SignalCount = static_cast<uint32_t>(m_Latest.Signals.size()),
+		.TrainCount = static_cast<uint32_t>(m_Latest.Trains.size()),
+	});
+	Writer.Write(std::span<const uint8_t>(Base));
+
+	for (size_t Index = 0; Index < m_Snapshots.size(); Index++)
+	{
+		const auto& Snapshot = m_Snapshots[Index];
+		Writer.Write(SnapshotHeader{
+			.Time = Snapshot.Time,
+			.TileChangeCount = static_cast<uint32_t>(Snapshot.Tiles.size()),
+			.SignalChangeCount = static_cast<uint32_t>(Snapshot.Signals.size()),
+			.TrainChangeCount = static_cast<uint32_t>(Snapshot.Trains.size()),
+		});
+
+		if (Index % KeyframeInterval == 0)
+		{
+			const auto& Keyframe = m_Keyframes[Index / KeyframeInterval];
+			Writer.Write(std::span<const TileState>(Keyframe.Tiles));
+			Writer.Write(std::span<const uint8_t>(Keyframe.Signals));
+			Writer.Write(std::span<const TrainState>(Keyframe.Trains));
+		}
+		else
+		{
+			Writer.Write(std::span<const TileChange>(Snapshot.Tiles));
+			Writer.Write(std::span<const SignalChange>(Snapshot.Signals));
+			Writer.Write(std::span<const TrainChange>(Snapshot.Trains));
+		}
+	}
+
+	return Writer.Finish();
+}
+
+std::optional<WorldStateHistory> WorldStateHistory::Deserialize(std::span<const uint8_t> Data)
+{
+	HistoryReader Reader(Data);
+
+	Header Header;
+	if (!Reader.Read(Header) || Header.Magic != Magic || Header.Version != Version)
+	{
+		BD_LOG_WARNING("Cannot deserialize world history: unknown format or version");
+		return std::nullopt;
+	}
+	if (Header.KeyframeInterval != KeyframeInterval)
+	{
+		BD_LOG_WARNING("Cannot deserialize world history with keyframe interval {}, expected {}", Header.KeyframeInterval, KeyframeInterval);
+		return std::nullopt;
+	}
+
+	auto Base = Reader.Skip(Header.BaseSize);
+	if (!Base)
+	{
+		BD_LOG_WARNING("Cannot deserialize world history: base world is out of bounds");
+		return std::nullopt;
+	}
+
+	WorldStateHistory Result(WorldSerialization::Deserialize({ reinterpret_cast<const char*>(Base->data()), Base->size() }));
+	if (Result.m_Latest.Tiles.size() != Header.TileCount || Result.m_Latest.Signals.size() != Header.SignalCount || Result.m_Latest.Trains.size() != Header.TrainCount)
+	{
+		BD_LOG_WARNING("Cannot deserialize world history: base world does not match the snapshots");
+		return std::nullopt;
+	}
+
+	auto IsValidTrain = [&](const TrainState& Train)
+	{
+		return Train.CurrentArea >= -1 && Train.CurrentArea < static_cast<int32_t>(Result.m_Base.m_TrackAreas.size()) &&
+			Train.TimetableState <= static_cast<uint8_t>(TimetableState::Left);
+	};
+
+	Result.m_Snapshots.reserve(Header.SnapshotCount);
+	for (uint32_t Index = 0; Index < Header.SnapshotCount; Index++)
+	{
+		SnapshotHeader SnapshotHeader;
+		if (!Reader.Read(SnapshotHeader))
+		{
+			BD_LOG_WARNING("Cannot deserialize world history: snapshot {} is out of bounds", Index);
+			return std::nullopt;
+		}
+
+		auto& Snapshot = Result.m_Snapshots.emplace_back();
+		Snapshot.Time = SnapshotHeader.Time;
+
+		bool IsValid = true;
+		if (Index % KeyframeInterval == 0)
+		{
+			auto& Keyframe = Result.m_Keyframes.emplace_back();
+			Keyframe.Time = SnapshotHeader.Time;
+			IsValid = Reader.Read(Keyframe.Tiles, Header.TileCount) && Reader.Read(Keyframe.Signals, Header.SignalCount) &&
+				Reader.Read(Keyframe.Trains, Header.TrainCount) && std::ranges::all_of(Keyframe.Trains, IsValidTrain);
+		}
+		else
+		{
+			IsValid = Reader.Read(Snapshot.Tiles, SnapshotHeader.TileChangeCount) && Reader.Read(Snapshot.Signals, SnapshotHeader.SignalChangeCount) &&
+				Reader.Read(Snapshot.Trains, SnapshotHeader.TrainChangeCount) &&
+				std::ranges::all_of(Snapshot.Tiles, [&](const auto& Change) { return Change.Index < Header.TileCount; }) &&
+				std::ranges::all_of(Snapshot.Signals, [&](const auto& Change) { return Change.Index < Header.SignalCount; }) &&
+				std::ranges::all_of(Snapshot.Trains, [&](const auto& Change) { return Change.Index < Header.TrainCount && IsValidTrain(Change.State); });
+		}
+
+		if (!IsValid)
+		{
+			BD_LOG_WARNING("Cannot deserialize world history: snapshot {} is invalid", Index);
+			return std::nullopt;
+		}
+	}
+
+	if (!Reader.IsAtEnd())
+		BD_LOG_WARNING("World history has trailing data after the last snapshot");
+
+	if (!Result.m_Snapshots.empty())
+		Result.m_Latest = Result.ReconstructState(Result.m_Snapshots.size() - 1);
+
+	return Result;
+}
+
+bool WorldStateHistory::HasSameTopology(const World& World) const
+{
+	if (World.m_TrackTiles.size() != m_Base.m_TrackTiles.size() || World.m_Signals.size() != m_Base.m_Signals.size() ||
+		World.m_Trains.size() != m_Base.m_Trains.size() || World.m_TrackAreas.size() != m_Base.m_TrackAreas.size())
+	{
+		return false;
+	}
+
+	for (size_t Index = 0; Index < World.m_TrackTiles.size(); Index++)
+	{
+		const auto& Tile = World.m_TrackTiles[Index];
+		const auto& BaseTile = m_Base.m_TrackTiles[Index];
+		if (Tile.Tile != BaseTile.Tile || Tile.ConnectedDirections != BaseTile.ConnectedDirections)
+			return false;
+	}
+
+	for (size_t Index = 0; Index < World.m_Signals.size(); Index++)
+	{
+		if (!(World.m_Signals[Index].Location == m_Base.m_Signals[Index].Location))
+			return false;
+	}
+
+	return true;
+}
+
+WorldStateHistory::State WorldStateHistory::ReconstructState(size_t SnapshotIndex) const
+{
+	auto FirstSnapshotIndex = SnapshotIndex / KeyframeInterval * KeyframeInterval;
+	auto Result = m_Keyframes[SnapshotIndex / KeyframeInterval];
+
+	for (auto Index = FirstSnapshotIndex + 1; Index <= SnapshotIndex; Index++)
+	{
+		const auto& Snapshot = m_Snapshots[Index];
+		Result.Time = Snapshot.Time;
+		for (const auto& Change : Snapshot.Tiles)
+			Result.Tiles[Change.Index] = Change.State;
+		for (const auto& Change : Snapshot.Signals)
+			Result.Signals[Change.Index] = Change.State;
+		for (const auto& Change : Snapshot.Trains)
+			Result.Trains[Change.Index] = Change.State;
+	}
+
+	return Result;
+}
+
+WorldStateHistory::TileState WorldStateHistory::CaptureTile(const TrackTile& Tile)
+{
+	TileState Result = { .SelectedPath = Tile.SelectedPath, .States = 0, .Padding = 0 };
+	for (uint32_t Direction = 0; Direction < 8; Direction++)
+		Result.States |= static_cast<uint16_t>(static_cast<uint32_t>(Tile.State(static_cast<TrackDirection>(1 << Direction))) << (2 * Direction));
+	return Result;
+}
+
+WorldStateHistory::TrainState WorldStateHistory::CaptureTrain(const Train& Train, std::span<const TrackArea> Areas)
+{
+	// NOTE: a copy of a world still points into the track areas of the original one, so the area cannot be recovered
+	//       from such a pointer. Worlds are meant to be recorded directly, not through a copy.
+	int32_t CurrentArea = -1;
+	if (Train.CurrentArea >= Areas.data() && Train.CurrentArea < Areas.data() + Areas.size())
+		CurrentArea = static_cast<int32_t>(Train.CurrentArea - Areas.data());
+
+	return {
+		.TileX = Train.Tile.x,
+		.TileY = Train.Tile.y,
+		.OffsetInTile = Train.OffsetInTile,
+		.Score = Train.Score,
+		.StoppingTime = Train.Timetable.m_StoppingTime,
+		.AccumulatedScore = Train.Timetable.m_AccumulatedScore,
+		.CurrentArea = CurrentArea,
+		.Direction = std::to_underlying(Train.Direction),
+		.IsMoving = static_cast<uint8_t>(Train.IsMoving),
+		.TimetableState = static_cast<uint8_t>(Train.Timetable.m_State),
+		.Padding = 0,
+	};
+}
+
+WorldStateHistory::State WorldStateHistory::CaptureState(const World& World)
+{
+	State Result;
+	Result.Time = World.CurrentTime().SecondsSinceStart();
+
+	Result.Tiles.reserve(World.m_TrackTiles.size());
+	for (const auto& Tile : World.m_TrackTiles)
+		Result.Tiles.push_back(CaptureTile(Tile));
+
+	Result.Signals.reserve(World.m_Signals.size());
+	for (const auto& Signal : World.m_Signals)
+		Result.Signals.push_back(static_cast<uint8_t>(Signal.State));
+
+	Result.Trains.reserve(World.m_Trains.size());
+	for (const auto& Train : World.m_Trains)
+		Result.Trains.push_back(CaptureTrain(Train, World.m_TrackAreas));
+
+	return Result;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Simulation/World.h"
+
+/*
+ * Sequence of snapshots of a world that share the same topology. Tiles, track areas, exits, signal locations and the
+ * timetables of trains are stored once, in the base world. Each snapshot records only the mutable state - tile states
+ * and selected paths, signal states, train positions and progress, and the time - that differs from the previous
+ * snapshot. Every KeyframeInterval-th snapshot stores the full mutable state instead, so reconstructing any snapshot
+ * applies at most KeyframeInterval - 1 deltas.
+ */
+class WorldStateHistory
+{
+public:
+	static constexpr size_t KeyframeInterval = 64;
+
+	explicit WorldStateHistory(const World& Base);
+
+	/*
+	 * Records the current state of the world as a new snapshot. Returns false without recording anything if the
+	 * topology of the world no longer matches the base (e.g. track was built since), in which case a new history has to
+	 * be started.
+	 */
+	bool Record(const World& World);
+
+	size_t SnapshotCount() const { return m_Snapshots.size(); }
+
+	World Reconstruct(size_t SnapshotIndex) const;
+
+	std::vector<uint8_t> Serialize() const;
+
+	static std::optional<WorldStateHistory> Deserialize(std::span<const uint8_t> Data);
+
+private:
+	struct TileState
+	{
+		uint32_t SelectedPath;
+		uint16_t States; // NOTE: two bits per direction, in the order of the TrackDirection bits
+		uint16_t Padding;
+
+		bool operator==(const TileState&) const = default;
+	};
+
+	struct TrainState
+	{
+		int32_t TileX;
+		int32_t TileY;
+		float OffsetInTile;
+		float Score;
+		float StoppingTime;
+		uint32_t AccumulatedScore;
+		int32_t CurrentArea; // NOTE: index into the track areas of the world, -1 if the train is not in any area
+		uint8_t Direction;
+		uint8_t IsMoving;
+		uint8_t TimetableState;
+		uint8_t Padding;
+
+		bool operator==(const TrainState&) const = default;
+	};
+
+	struct TileChange
+	{
+		uint32_t Index;
+		TileState State;
+	};
+
+	struct SignalChange
+	{
+		uint32_t Index;
+		uint8_t State;
+		uint8_t Padding[3];
+	};
+
+	struct TrainChange
+	{
+		uint32_t Index;
+		TrainState State;
+	};
+
+	struct State
+	{
+		float Time = 0.0f;
+		std::vector<TileState> Tiles;
+		std::vector<uint8_t> Signals;
+		std::vector<TrainState> Trains;
+	};
+
+	struct Snapshot
+	{
+		float Time = 0.0f;
+
+		// NOTE: all of these are empty in keyframes
+		std::vector<TileChange> Tiles;
+		std::vector<SignalChange> Signals;
+		std::vector<TrainChange> Trains;
+	};
+
+	World m_Base;
+
+	std::vector<State> m_Keyframes;
+	std::vector<Snapshot> m_Snapshots;
+
+	// NOTE: the state of the most recent snapshot, which the next one is diffed against
+	State m_Latest;
+
+	bool HasSameTopology(const World& World) const;
+
+	State ReconstructState(size_t SnapshotIndex) const;
+
+	static TileState CaptureTile(const TrackTile& Tile);
+	static TrainState CaptureTrain(const Train& Train, std::span<const TrackArea> Areas);
+	static State CaptureState(const World& World);
+};
@@ -1,21 +1,61 @@
 #include "Font.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <nlohmann/json.hpp>
 
+#include "Core/AssetArchive.h"
+#include "Core/CookedAsset.h"
 #include "Core/Logger.h"
 #include "Platform/File.h"
 
 std::shared_ptr<Font> Font::Load(const std::string& Path)
+{
+	auto Font = Decode(Path);
+	if (!Font)
+		return nullptr;
+
+	return Create(std::move(*Font));
+}
+
+std::optional<Font::DecodedFont> Font::Decode(const std::string& Path)
+{
+	auto Description = LoadCookedDescription(Path);
+	if (!Description)
+		Description = ParseDescription(Path);
+	if (!Description)
+		return std::nullopt;
+
+	auto AtlasFilePath = std::filesystem::path(Path).replace_extension(".png").string();
+	auto Atlas = Texture::LoadImage(AtlasFilePath);
+	if (!Atlas)
+	{
+		BD_LOG_ERROR("Could not load atlas texture from file {} for font {}", AtlasFilePath, Path);
+		return std::nullopt;
+	}
+
+	return DecodedFont{ .Description = std::move(*Description), .Atlas = std::move(*Atlas) };
+}
+
+std::shared_ptr<Font> Font::Create(DecodedFont Font)
+{
+	auto Atlas = Texture::Create(Font.Atlas.Dimensions, Font.Atlas.ChannelCount, Font.Atlas.Pixels);
+	if (!Atlas)
+		return nullptr;
+
+	return std::shared_ptr<class Font>(new class Font(std::move(Atlas), std::move(Font.Description)));
+}
+
+std::optional<Font::Description> Font::ParseDescription(const std::string& Path)
 {
 	using namespace nlohmann;
 
-#define RETURN_WITH_ERROR(Message, ...)  { BD_LOG_ERROR(Message, __VA_ARGS__); return nullptr; }
+#define RETURN_WITH_ERROR(Message, ...)  { BD_LOG_ERROR(Message, __VA_ARGS__); return std::nullopt; }
 
-	auto MaybeFontDesc = FileSystem::ReadFileAsString(Path);
-	if (!MaybeFontDesc)
+	auto File = AssetArchive::MapAsset(Path);
+	if (!File)
 		RETURN_WITH_ERROR("Font {} could not be loaded", Path);
-	auto FontDesc = json::parse(*MaybeFontDesc);
+	auto FontDesc = json::parse(File->Data().begin(), File->Data().end());
 
 
 	// ================ 'ATLAS' PROPERTY ================
@@ -123,12 +163,85 @@ std::shared_ptr<Font> Font::Load(const std::string& Path)
 		Glyphs.emplace(Unicode, Glyph{ Offset, Dimensions, Advance, TextureCoordinates });
 	}
 
-	auto AtlasFilePath = std::filesystem::path(Path).replace_extension(".png").string();
-	auto Atlas = Texture::Load(AtlasFilePath);
-	if (!Atlas)
-		RETURN_WITH_ERROR("Could not load atlas texture from file {} for font {}", AtlasFilePath, Path);
+	return Description{
+		.PixelsPerEm = PixelsPerEm,
+		.Ascender = Ascender,
+		.Descender = Descender,
+		.WhitespaceAdvance = WhitespaceAdvance,
+		.Glyphs = std::move(Glyphs),
+	};
+
+#undef RETURN_WITH_ERROR
+}
+
+bool Font::Cook(const std::string& Path)
+{
+	auto Description = ParseDescription(Path);
+	if (!Description)
+		return false;
+
+	std::vector<CookedGlyph> Glyphs;
+	Glyphs.reserve(Description->Glyphs.size());
+	for (const auto& [Character, Glyph] : Description->Glyphs)
+	{
+		Glyphs.push_back({
+			.Character = Character,
+			.Offset = Glyph.Offset,
+			.Dimensions = Glyph.Dimensions,
+			.Advance = Glyph.Advance,
+			.TextureCoordinatesMin = Glyph.TextureCoordinates.Min,
+			.TextureCoordinatesMax = Glyph.TextureCoordinates.Max,
+		});
+	}
+
+	// NOTE: sorted so that cooking the same font twice gives the same file
+	std::ranges::sort(Glyphs, {}, &CookedGlyph::Character);
+
+	CookedAssetWriter Writer(CookedAssetKind::Font);
+	Writer.Write(CookedHeader{
+		.PixelsPerEm = Description->PixelsPerEm,
+		.Ascender = Description->Ascender,
+		.Descender = Description->Descender,
+		.WhitespaceAdvance = Description->WhitespaceAdvance,
+		.GlyphCount = static_cast<uint32_t>(Glyphs.size()),
+		.Padding = 0,
+	});
+	Writer.WriteArray(std::span<const CookedGlyph>(Glyphs));
+	return Writer.Finish(Path);
+}
+
+std::optional<Font::Description> Font::LoadCookedDescription(const std::string& Path)
+{
+	auto Cooked = CookedAsset::Open(Path, CookedAssetKind::Font);
+	if (!Cooked)
+		return std::nullopt;
+
+	auto Header = Cooked->Read<CookedHeader>();
+	auto Glyphs = Header ? Cooked->ReadArray<CookedGlyph>(Header->GlyphCount) : std::nullopt;
+	if (!Glyphs)
+	{
+		BD_LOG_WARNING("Cooked font {} is corrupted, loading the source description instead", Path);
+		return std::nullopt;
+	}
+
+	Description Result = {
+		.PixelsPerEm = Header->PixelsPerEm,
+		.Ascender = Header->Ascender,
+		.Descender = Header->Descender,
+		.WhitespaceAdvance = Header->WhitespaceAdvance,
+	};
+	Result.Glyphs.reserve(Glyphs->size());
+	for (const auto& Glyph : *Glyphs)
+	{
+		Result.Glyphs.emplace(static_cast<IndexType>(Glyph.Character), ::Glyph{
+			.Offset = Glyph.Offset,
+			.Dimensions = Glyph.Dimensions,
+			.Advance = Glyph.Advance,
+			.TextureCoordinates = { .Min = Glyph.TextureCoordinatesMin, .Max = Glyph.TextureCoordinatesMax },
+		});
+	}
 
-	return std::shared_ptr<Font>(new Font(std::move(Atlas), std::move(Glyphs), PixelsPerEm, Ascender, Descender, WhitespaceAdvance));
+	return Result;
 }
 
 std::optional<Glyph> Font::GetGlyph(IndexType Character, uint32_t FontSize) const
@@ -19,9 +19,59 @@ struct Glyph
 class Font
 {
 public:
+	using IndexType = unsigned char;
+
+	struct Description
+	{
+		float PixelsPerEm = 0.0f;
+		float Ascender = 0.0f;
+		float Descender = 0.0f;
+		float WhitespaceAdvance = 0.0f;
+
+		std::unordered_map<IndexType, Glyph> Glyphs;
+	};
+
+	/*
+	 * Loads the cooked glyph table of the font if there is an up to date one, otherwise parses the source description.
+	 */
 	static std::shared_ptr<Font> Load(const std::string& Path);
 
-	using IndexType = unsigned char;
+	struct DecodedFont
+	{
+		Description Description;
+		TextureImage Atlas;
+	};
+
+	/*
+	 * Reads everything Load() needs without creating any GPU resources, so it can be called from any thread.
+	 */
+	static std::optional<DecodedFont> Decode(const std::string& Path);
+
+	static std::shared_ptr<Font> Create(DecodedFont Font);
+
+	static std::optional<Description> ParseDescription(const std::string& Path);
+
+	static bool Cook(const std::string& Path);
+
+	struct CookedHeader
+	{
+		float PixelsPerEm;
+		float Ascender;
+		float Descender;
+		float WhitespaceAdvance;
+		uint32_t GlyphCount;
+		uint32_t Padding;
+	};
+
+	struct CookedGlyph
+	{
+		uint32_t Character;
+		glm::vec2 Offset;
+		glm::vec2 Dimensions;
+		float Advance;
+		glm::vec2 TextureCoordinatesMin;
+		glm::vec2 TextureCoordinatesMax;
+	};
 
 	std::optional<Glyph> GetGlyph(IndexType Character, uint32_t FontSize) const;
 
@@ -45,12 +95,14 @@ private:
 
 	float m_WhitespaceAdvance = 0.0f;
 
-	Font(std::unique_ptr<Texture> AtlasTexture, std::unordered_map<IndexType, Glyph> Glyphs, float PixelsPerEm, float Ascender, float Descender, float WhitespaceAdvance)
+	Font(std::unique_ptr<Texture> AtlasTexture, Description Description)
 		: m_AtlasTexture(std::move(AtlasTexture))
-		, m_Glyphs(std::move(Glyphs))
-		, m_PixelsPerEm(PixelsPerEm)
-		, m_Ascender(Ascender)
-		, m_Descender(Descender)
-		, m_WhitespaceAdvance(WhitespaceAdvance)
+		, m_Glyphs(std::move(Description.Glyphs))
+		, m_PixelsPerEm(Description.PixelsPerEm)
+		, m_Ascender(Description.Ascender)
+		, m_Descender(Description.Descender)
+		, m_WhitespaceAdvance(Description.WhitespaceAdvance)
 	{}
+
+	static std::optional<Description> LoadCookedDescription(const std::string& Path);
 };
@@ -1,87 +1,94 @@
 #include "RenderBuffer.h"
 
-#include "UI/TextLayout.h"
+#include <algorithm>
+#include <array>
 
-struct UIVertex
-{
-	glm::vec2 Position;
-	glm::vec2 TextureCoordinates;
-};
+#include "Core/FrameStats.h"
+#include "Core/Logger.h"
+#include "Core/Profiler.h"
+#include "UI/TextLayout.h"
 
 VERTEX_DESCRIPTION_BEGIN(UIVertex)
 	VERTEX_DESCRIPTION_ELEMENT(Position)
 	VERTEX_DESCRIPTION_ELEMENT(TextureCoordinates)
+	VERTEX_DESCRIPTION_ELEMENT(Color)
+	VERTEX_DESCRIPTION_ELEMENT(BorderColor)
+	VERTEX_DESCRIPTION_ELEMENT(Shape)
+	VERTEX_DESCRIPTION_ELEMENT(Parameters)
 VERTEX_DESCRIPTION_END()
 
+// NOTE: has to match the constants in UIShape.frag
+enum class UIShapeType
+{
+	SolidColor = 0,
+	Rect = 1,
+};
+
 RenderBuffer::RenderBuffer(Renderer& Renderer)
 	: m_Renderer(Renderer)
 {
-	m_SolidColorShader = Shader::Create("Resources/Shaders/SolidColor.vert", "Resources/Shaders/SolidColor.frag");
-	m_RectShader = Shader::Create("Resources/Shaders/UIRect.vert", "Resources/Shaders/UIRect.frag");
-	m_TextureRectShader = Shader::Create("Resources/Shaders/UITextureRect.vert", "Resources/Shaders/UITextureRect.frag");
-	m_TextShader = Shader::Create("Resources/Shaders/TextMSDF.vert", "Resources/Shaders/TextMSDF.frag");
-	BD_ASSERT(m_TextShader);
+	auto& Assets = m_Renderer.Assets();
+	m_Shaders[static_cast<size_t>(ShaderType::Shape)] = Assets.GetShader("Resources/Shaders/UI.vert", "Resources/Shaders/UIShape.frag");
+	m_Shaders[static_cast<size_t>(ShaderType::Image)] = Assets.GetShader("Resources/Shaders/UI.vert", "Resources/Shaders/UIImage.frag");
+	m_Shaders[static_cast<size_t>(ShaderType::Text)] = Assets.GetShader("Resources/Shaders/UI.vert", "Resources/Shaders/UIText.frag");
+	BD_ASSERT(std::ranges::all_of(m_Shaders, [](const auto& Shader) { return Shader != nullptr; }));
 }
 
 void RenderBuffer::Line(glm::vec2 From, glm::vec2 To, float Thickness, glm::vec4 Color)
 {
-	auto Direction = glm::normalize(To - From);
-	auto Normal = glm::vec2(Direction.y, -Direction.x);
-	auto HalfThickness = Thickness / 2.0f;
-
-	std::vector<UIVertex> Vertices = {
-		{ (From - Normal * HalfThickness) / m_Renderer.FramebufferSize(), {} },
-		{ (From + Normal * HalfThickness) / m_Renderer.FramebufferSize(), {} },
-		{ (To - Normal * HalfThickness) / m_Renderer.FramebufferSize(), {} },
-
-		{ (From + Normal * HalfThickness) / m_Renderer.FramebufferSize(), {} },
-		{ (To - Normal * HalfThickness) / m_Renderer.FramebufferSize(), {} },
-		{ (To + Normal * HalfThickness) / m_Renderer.FramebufferSize(), {} },
-	};
-	auto Geometry = GeometryBuffer<UIVertex>::Create(Vertices.size(), false, Vertices);
-
-	m_SolidColorShader->SetUniform("u_Color", Color);
-
-	m_Renderer.DrawWithShader(*Geometry, *m_SolidColorShader);
+	auto Points = std::array{ From, To };
+	Polyline(Points, Thickness, Color);
 }
 
-std::unique_ptr<GeometryBuffer<UIVertex>> CreateQuad(Rect2D Rect, glm::vec2 FramebufferSize)
+void RenderBuffer::Polyline(std::span<const glm::vec2> Points, float Thickness, glm::vec4 Color)
 {
-	std::vector<UIVertex> Vertices =
+	if (Points.size() < 2)
+		return;
+
+	auto HalfThickness = Thickness / 2.0f;
+	UIVertex Template = { .Color = Color, .Parameters = { static_cast<float>(UIShapeType::SolidColor), 0.0f } };
+
+	auto FirstVertex = static_cast<uint32_t>(m_Vertices.size());
+	for (size_t Index = 0; Index + 1 < Points.size(); Index++)
 	{
-		{.Position = glm::vec2(Rect.Left() , Rect.Top()) / FramebufferSize, .TextureCoordinates = { 0.0f, 0.0f } },
-		{.Position = glm::vec2(Rect.Right(), Rect.Top()) / FramebufferSize, .TextureCoordinates = { 1.0f, 0.0f } },
-		{.Position = glm::vec2(Rect.Left() , Rect.Bottom()) / FramebufferSize, .TextureCoordinates = { 0.0f, 1.0f } },
+		auto From = Points[Index];
+		auto To = Points[Index + 1];
+		if (From == To)
+			continue;
 
-		{.Position = glm::vec2(Rect.Left() , Rect.Bottom()) / FramebufferSize, .TextureCoordinates = { 0.0f, 1.0f } },
-		{.Position = glm::vec2(Rect.Right(), Rect.Top()) / FramebufferSize, .TextureCoordinates = { 1.0f, 0.0f } },
-		{.Position = glm::vec2(Rect.Right(), Rect.Bottom()) / FramebufferSize, .TextureCoordinates = { 1.0f, 1.0f } },
-	};
+		auto Direction = glm::normalize(To - From);
+		auto Normal = glm::vec2(Direction.y, -Direction.x);
+
+		AppendVertex(Template, From - Normal * HalfThickness, {});
+		AppendVertex(Template, From + Normal * HalfThickness, {});
+		AppendVertex(Template, To - Normal * HalfThickness, {});
 
-	return GeometryBuffer<UIVertex>::Create(Vertices.size(), false, Vertices);;
+		AppendVertex(Template, From + Normal * HalfThickness, {});
+		AppendVertex(Template, To - Normal * HalfThickness, {});
+		AppendVertex(Template, To + Normal * HalfThickness, {});
+	}
+	EndPrimitive(FirstVertex, ShaderType::Shape, nullptr);
 }
 
 void RenderBuffer::Rect(Rect2D Rect, glm::vec4 Color, float CornerRadius, glm::vec4 BorderColor, float BorderThickness)
 {
-	auto Geometry = CreateQuad(Rect, m_Renderer.FramebufferSize());
-
-	m_RectShader->SetUniform("u_Color", Color);
-	m_RectShader->SetUniform("u_BorderColor", BorderColor);
-	m_RectShader->SetUniform("u_FramebufferDimensions", m_Renderer.FramebufferSize());
-	m_RectShader->SetUniform("u_RectDimensions", Rect.Dimensions());
-	m_RectShader->SetUniform("u_CornerRadius", CornerRadius);
-	m_RectShader->SetUniform("u_BorderThickness", BorderThickness);
+	UIVertex Template = {
+		.Color = Color,
+		.BorderColor = BorderColor,
+		.Shape = { Rect.Dimensions(), CornerRadius, BorderThickness },
+		.Parameters = { static_cast<float>(UIShapeType::Rect), 0.0f },
+	};
 
-	m_Renderer.DrawWithShader(*Geometry, *m_RectShader);
+	auto FirstVertex = static_cast<uint32_t>(m_Vertices.size());
+	AppendQuad(Rect, Template);
+	EndPrimitive(FirstVertex, ShaderType::Shape, nullptr);
 }
 
 void RenderBuffer::TextureRect(Rect2D Rect, const Texture& Texture)
 {
-	auto Geometry = CreateQuad(Rect, m_Renderer.FramebufferSize());
-
-	m_TextureRectShader->SetUniform("u_Texture", Texture);
-
-	m_Renderer.DrawWithShader(*Geometry, *m_TextureRectShader);
+	auto FirstVertex = static_cast<uint32_t>(m_Vertices.size());
+	AppendQuad(Rect, {});
+	EndPrimitive(FirstVertex, ShaderType::Image, &Texture);
 }
 
 void RenderBuffer::Debug_RectOutline(Rect2D Rect, glm::vec3 Color)
@@ -97,55 +104,154 @@ void RenderBuffer::Debug_RectOutline(Rect2D Rect, glm::vec3 Color)
 	m_Renderer.DrawLine(BottomLeft, TopLeft, Color);
 }
 
-struct TextVertex
-{
-	glm::vec2 Position;
-	glm::vec2 TextureCoordinates;
-};
-
-VERTEX_DESCRIPTION_BEGIN(TextVertex)
-	VERTEX_DESCRIPTION_ELEMENT(Position)
-	VERTEX_DESCRIPTION_ELEMENT(TextureCoordinates)
-VERTEX_DESCRIPTION_END()
-
 void RenderBuffer::Text(std::string_view Text, uint32_t FontSize, const Font& Font, Rect2D Rect)
 {
-	std::vector<TextVertex> Vertices;
+	UIVertex Template = { .Color = glm::vec4(1.0f), .Parameters = { 0.0f, Font.ScreenPxRange(FontSize) } };
 
+	auto FirstVertex = static_cast<uint32_t>(m_Vertices.size());
 	BD_ASSERT(TextLayout::Layout(Text, FontSize, Font, [&](Rect2D ScreenRect, Rect2D TextureRect)
 	{
-		TextVertex TopLeft = {
-			2.0f * (Rect.Min + ScreenRect.Min + glm::vec2(0.0f, ScreenRect.Height())) / m_Renderer.FramebufferSize() - 1.0f,
-			TextureRect.Min + glm::vec2(0.0f, TextureRect.Height())
-		};
-		TextVertex TopRight = {
-			2.0f * (Rect.Min + ScreenRect.Max) / m_Renderer.FramebufferSize() - 1.0f,
-			TextureRect.Max
-		};
-		TextVertex BottomLeft = {
-			2.0f * (Rect.Min + ScreenRect.Min) / m_Renderer.FramebufferSize() - 1.0f,
-			TextureRect.Min
-		};
-		TextVertex BottomRight = {
-			2.0f * (Rect.Min + ScreenRect.Min + glm::vec2(ScreenRect.Width(), 0.0f)) / m_Renderer.FramebufferSize() - 1.0f,
-			TextureRect.Min + glm::vec2(TextureRect.Width(), 0.0f)
-		};
-
-		Vertices.push_back(TopLeft);
-		Vertices.push_back(TopRight);
-		Vertices.push_back(BottomRight);
-
-		Vertices.push_back(TopLeft);
-		Vertices.push_back(BottomRight);
-		Vertices.push_back(BottomLeft);
+		auto TopLeft = Rect.Min + ScreenRect.Min + glm::vec2(0.0f, ScreenRect.Height());
+		auto TopRight = Rect.Min + ScreenRect.Max;
+		auto BottomLeft = Rect.Min + ScreenRect.Min;
+		auto BottomRight = Rect.Min + ScreenRect.Min + glm::vec2(ScreenRect.Width(), 0.0f);
+
+		auto TopLeftTextureCoordinates = TextureRect.Min + glm::vec2(0.0f, TextureRect.Height());
+		auto BottomRightTextureCoordinates = TextureRect.Min + glm::vec2(TextureRect.Width(), 0.0f);
+
+		AppendVertex(Template, TopLeft, TopLeftTextureCoordinates);
+		AppendVertex(Template, TopRight, TextureRect.Max);
+		AppendVertex(Template, BottomRight, BottomRightTextureCoordinates);
+
+		AppendVertex(Template, TopLeft, TopLeftTextureCoordinates);
+		AppendVertex(Template, BottomRight, BottomRightTextureCoordinates);
+		AppendVertex(Template, BottomLeft, TextureRect.Min);
 	}));
+	EndPrimitive(FirstVertex, ShaderType::Text, &Font.AtlasTexture());
+}
+
+void RenderBuffer::Flush()
+{
+	BD_PROFILE_FUNCTION();
+
+	auto& Stats = GFrameStats.Current();
+	Stats.UIVertices += static_cast<uint32_t>(m_Vertices.size());
+	Stats.UIDrawCalls += static_cast<uint32_t>(m_Batches.size());
+
+	if (!m_Batches.empty() && ReserveGeometryBuffer(m_Vertices.size()))
+	{
+		uint32_t FirstVertex = 0;
+		for (auto& Batch : m_Batches)
+		{
+			Batch.NextVertex = FirstVertex;
+			FirstVertex += Batch.VertexCount;
+		}
+
+		m_BatchedVertices.resize(m_Vertices.size());
+		for (const auto& Primitive : m_Primitives)
+		{
+			auto& Batch = m_Batches[Primitive.Batch];
+			std::copy_n(m_Vertices.begin() + Primitive.FirstVertex, Primitive.VertexCount, m_BatchedVertices.begin() + Batch.NextVertex);
+			Batch.NextVertex += Primitive.VertexCount;
+		}
+
+		m_GeometryBuffer->NextRegion();
+		m_GeometryBuffer->Reset();
+		m_GeometryBuffer->AppendVertices(m_BatchedVertices);
+		m_GeometryBuffer->Flush();
 
-	auto Geometry = GeometryBuffer<TextVertex>::Create(Vertices.size(), false, Vertices);
+		for (const auto& Batch : m_Batches)
+		{
+			auto& Shader = *m_Shaders[static_cast<size_t>(Batch.Shader)];
+			if (Batch.Texture)
+				Shader.SetUniform("u_Texture", *Batch.Texture);
+			m_Renderer.DrawWithShader(*m_GeometryBuffer, Shader, m_GeometryBuffer->FirstVertex() + Batch.NextVertex - Batch.VertexCount, Batch.VertexCount);
+		}
+	}
 
-	m_TextShader->Bind();
-	m_TextShader->SetUniform("u_Atlas", Font.AtlasTexture());
-	m_TextShader->SetUniform("u_Color", glm::vec3(1.0f, 1.0f, 1.0f));
-	m_TextShader->SetUniform("u_ScreenPxRange", Font.ScreenPxRange(FontSize));
+	// NOTE: clear() keeps the capacity, so recording the next frame does not allocate either
+	m_Vertices.clear();
+	m_BatchedVertices.clear();
+	m_Primitives.clear();
+	m_Batches.clear();
+}
+
+void RenderBuffer::AppendVertex(const UIVertex& Template, glm::vec2 Position, glm::vec2 TextureCoordinates)
+{
+	auto& Vertex = m_Vertices.emplace_back(Template);
+	Vertex.Position = Position / m_Renderer.FramebufferSize();
+	Vertex.TextureCoordinates = TextureCoordinates;
+}
+
+void RenderBuffer::AppendQuad(Rect2D Rect, const UIVertex& Template)
+{
+	AppendVertex(Template, { Rect.Left(), Rect.Top() }, { 0.0f, 0.0f });
+	AppendVertex(Template, { Rect.Right(), Rect.Top() }, { 1.0f, 0.0f });
+	AppendVertex(Template, { Rect.Left(), Rect.Bottom() }, { 0.0f, 1.0f });
+
+	AppendVertex(Template, { Rect.Left(), Rect.Bottom() }, { 0.0f, 1.0f });
+	AppendVertex(Template, { Rect.Right(), Rect.Top() }, { 1.0f, 0.0f });
+	AppendVertex(Template, { Rect.Right(), Rect.Bottom() }, { 1.0f, 1.0f });
+}
 
-	m_Renderer.DrawWithShader(*Geometry, *m_TextShader);
+void RenderBuffer::EndPrimitive(uint32_t FirstVertex, ShaderType Shader, const Texture* Texture)
+{
+	auto VertexCount = static_cast<uint32_t>(m_Vertices.size()) - FirstVertex;
+	if (VertexCount == 0)
+		return;
+
+	Rect2D Bounds = { .Min = m_Vertices[FirstVertex].Position, .Max = m_Vertices[FirstVertex].Position };
+	for (uint32_t Index = FirstVertex + 1; Index < m_Vertices.size(); Index++)
+	{
+		Bounds.Min = glm::min(Bounds.Min, m_Vertices[Index].Position);
+		Bounds.Max = glm::max(Bounds.Max, m_Vertices[Index].Position);
+	}
+
+	// NOTE: the primitive is drawn as part of the batch it joins, i.e. before every batch that comes after it. That is only
+	//       allowed if it does not overlap any of them, since UI elements are blended in the order they were recorded.
+	auto BatchIndex = static_cast<uint32_t>(m_Batches.size());
+	for (size_t Index = m_Batches.size(); Index > 0 && m_Batches.size() - Index < s_MaxBatchLookback; Index--)
+	{
+		const auto& Candidate = m_Batches[Index - 1];
+		if (Candidate.Shader == Shader && Candidate.Texture == Texture)
+		{
+			BatchIndex = static_cast<uint32_t>(Index - 1);
+			break;
+		}
+		if (Candidate.Bounds.Intersects(Bounds))
+			break;
+	}
+
+	if (BatchIndex == m_Batches.size())
+	{
+		m_Batches.push_back({ .Shader = Shader, .Texture = Texture, .Bounds = Bounds });
+	}
+	else
+	{
+		auto& Batch = m_Batches[BatchIndex];
+		Batch.Bounds.Min = glm::min(Batch.Bounds.Min, Bounds.Min);
+		Batch.Bounds.Max = glm::max(Batch.Bounds.Max, Bounds.Max);
+	}
+
+	m_Batches[BatchIndex].VertexCount += VertexCount;
+	m_Primitives.push_back({ .FirstVertex = FirstVertex, .VertexCount = VertexCount, .Batch = BatchIndex });
+}
+
+bool RenderBuffer::ReserveGeometryBuffer(size_t VertexCount)
+{
+	if (m_GeometryBuffer && m_GeometryBuffer->Capacity() >= VertexCount)
+		return true;
+
+	// NOTE: grows geometrically, so a UI that keeps getting bigger only recreates the buffer a handful of times
+	auto Capacity = std::max(s_InitialVertexCapacity, m_GeometryBuffer ? m_GeometryBuffer->Capacity() * 2 : 0);
+	while (Capacity < VertexCount)
+		Capacity *= 2;
+
+	m_GeometryBuffer = GeometryBuffer<UIVertex>::Create(Capacity, GeometryBufferUsage::Streaming);
+	if (!m_GeometryBuffer)
+	{
+		BD_LOG_ERROR("Could not create a UI vertex buffer for {} vertices", Capacity);
+		return false;
+	}
+	return true;
 }
@@ -1,9 +1,36 @@
 #pragma once
 
+#include <array>
+#include <span>
+#include <vector>
+
 #include "Core/Rect2D.h"
 #include "Renderer/Renderer.h"
 #include "UI/Font.h"
 
+/*
+ * Everything that differs between two UI primitives drawn by the same shader is stored per vertex, so that any number of
+ * them can share a draw call.
+ */
+struct UIVertex
+{
+	glm::vec2 Position;
+	glm::vec2 TextureCoordinates;
+	glm::vec4 Color;
+	glm::vec4 BorderColor;
+	glm::vec4 Shape; // NOTE: rect width and height, corner radius, border thickness
+	glm::vec2 Parameters; // NOTE: shape type, screen pixel range of the font
+};
+
+/*
+ * Records the UI of a layer and draws it in Flush(). A render buffer is meant to live as long as its layer: the vertices
+ * of a whole frame go into a single vertex buffer that is reused from frame to frame and only grows when a frame does not
+ * fit into it, so drawing the UI does not create any GL objects once the buffer is large enough.
+ *
+ * Primitives are merged into batches by shader and texture, and every batch is a single draw call. A primitive may join
+ * an earlier batch as long as it does not overlap anything recorded in between, so the result looks exactly as if every
+ * primitive was drawn in the order it was recorded.
+ */
 class RenderBuffer
 {
 public:
@@ -11,6 +38,8 @@ public:
 
 	void Line(glm::vec2 From, glm::vec2 To, float Thickness, glm::vec4 Color);
 
+	void Polyline(std::span<const glm::vec2> Points, float Thickness, glm::vec4 Color);
+
 	void Rect(Rect2D Rect, glm::vec4 Color, float CornerRadius, glm::vec4 BorderColor, float BorderThickness);
 
 	void TextureRect(Rect2D Rect, const Texture& Texture);
@@ -19,11 +48,59 @@ public:
 
 	void Text(std::string_view Text, uint32_t FontSize, const Font& Font, Rect2D Rect);
 
+	/*
+	 * Uploads the recorded vertices, draws all batches and clears the buffer for the next frame.
+	 */
+	void Flush();
+
 private:
+	enum class ShaderType
+	{
+		Shape,
+		Image,
+		Text,
+		Count_
+	};
+
+	struct Primitive
+	{
+		uint32_t FirstVertex = 0;
+		uint32_t VertexCount = 0;
+		uint32_t Batch = 0;
+	};
+
+	struct Batch
+	{
+		ShaderType Shader;
+		const Texture* Texture = nullptr;
+		Rect2D Bounds;
+		uint32_t VertexCount = 0;
+		uint32_t NextVertex = 0; // NOTE: only used while Flush() sorts the vertices by batch
+	};
+
+	static constexpr size_t s_InitialVertexCapacity = 4096;
+
+	// NOTE: how many batches back a primitive looks for one it can join, bounds the cost of recording a primitive
+	static constexpr size_t s_MaxBatchLookback = 16;
+
 	Renderer& m_Renderer;
+	std::array<std::shared_ptr<Shader>, static_cast<size_t>(ShaderType::Count_)> m_Shaders;
+
+	// NOTE: vertices are recorded in primitive order and sorted by batch in Flush()
+	std::vector<UIVertex> m_Vertices;
+	std::vector<UIVertex> m_BatchedVertices;
+	std::vector<Primitive> m_Primitives;
+	std::vector<Batch> m_Batches;
+	std::unique_ptr<GeometryBuffer<UIVertex>> m_GeometryBuffer;
+
+	void AppendVertex(const UIVertex& Template, glm::vec2 Position, glm::vec2 TextureCoordinates);
+
+	void AppendQuad(Rect2D Rect, const UIVertex& Template);
+
+	/*
+	 * Turns every vertex appended since FirstVertex into a primitive and adds it to a batch.
+	 */
+	void EndPrimitive(uint32_t FirstVertex, ShaderType Shader, const Texture* Texture);
 
-	std::unique_ptr<Shader> m_SolidColorShader;
-	std::unique_ptr<Shader> m_RectShader;
-	std::unique_ptr<Shader> m_TextureRectShader;
-	std::unique_ptr<Shader> m_TextShader;
+	bool ReserveGeometryBuffer(size_t VertexCount);
 };
@@ -0,0 +1,58 @@
+#include "Graph.h"
+
+#include <algorithm>
+
+std::unique_ptr<Graph> Graph::Create(size_t SampleCount, glm::vec2 PreferredSize, glm::vec4 LineColor)
+{
+	BD_ASSERT(SampleCount >= 2);
+	return std::unique_ptr<Graph>(new Graph(SampleCount, PreferredSize, LineColor));
+}
+
+void Graph::Render(RenderBuffer& Buffer) const
+{
+	Widget::Render(Buffer);
+
+	auto ContentRect = ContentBoundingBox();
+	auto ValueToY = [&](float Value)
+	{
+		return ContentRect.Bottom() + std::clamp(Value / m_MaxValue, 0.0f, 1.0f) * ContentRect.Height();
+	};
+
+	if (m_MarkerValue.has_value())
+	{
+		auto MarkerY = ValueToY(m_MarkerValue.value());
+		Buffer.Line({ ContentRect.Left(), MarkerY }, { ContentRect.Right(), MarkerY }, 1.0f, m_MarkerColor);
+	}
+
+	std::vector<glm::vec2> Points(m_Samples.size());
+	auto Step = ContentRect.Width() / static_cast<float>(m_Samples.size() - 1);
+	for (size_t Index = 0; Index < m_Samples.size(); Index++)
+	{
+		auto Sample = m_Samples[(m_NextSample + Index) % m_Samples.size()];
+		Points[Index] = { ContentRect.Left() + Step * static_cast<float>(Index), ValueToY(Sample) };
+	}
+	Buffer.Polyline(Points, 1.5f, m_LineColor);
+}
+
+void Graph::AddSample(float Value)
+{
+	m_Samples[m_NextSample] = Value;
+	m_NextSample = (m_NextSample + 1) % m_Samples.size();
+}
+
+float Graph::LargestSample() const
+{
+	return *std::ranges::max_element(m_Samples);
+}
+
+Graph::Graph(size_t SampleCount, glm::vec2 PreferredSize, glm::vec4 LineColor)
+	: m_Samples(SampleCount, 0.0f)
+	, m_PreferredSize(PreferredSize)
+	, m_LineColor(LineColor)
+{
+}
+
+glm::vec2 Graph::ComputeContentPreferredSize() const
+{
+	return m_PreferredSize;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "UI/Widget.h"
+
+/*
+ * Line graph of the most recent samples, with the oldest sample on the left. Values are plotted from 0 at the
+ * bottom of the content box to MaxValue() at the top and clamped to this range.
+ */
+class Graph : public Widget
+{
+public:
+	static std::unique_ptr<Graph> Create(size_t SampleCount, glm::vec2 PreferredSize, glm::vec4 LineColor);
+
+	virtual void Render(RenderBuffer& Buffer) const override;
+
+	void AddSample(float Value);
+
+	float LargestSample() const;
+
+	float& MaxValue() { return m_MaxValue; }
+	float MaxValue() const { return m_MaxValue; }
+
+	std::optional<float>& MarkerValue() { return m_MarkerValue; }
+	const std::optional<float>& MarkerValue() const { return m_MarkerValue; }
+
+	glm::vec4& MarkerColor() { return m_MarkerColor; }
+	const glm::vec4& MarkerColor() const { return m_MarkerColor; }
+
+private:
+	std::vector<float> m_Samples;
+	size_t m_NextSample = 0;
+
+	glm::vec2 m_PreferredSize;
+	glm::vec4 m_LineColor;
+
+	float m_MaxValue = 1.0f;
+
+	std::optional<float> m_MarkerValue;
+	glm::vec4 m_MarkerColor = glm::vec4(1.0f, 1.0f, 1.0f, 0.5f);
+
+	Graph(size_t SampleCount, glm::vec2 PreferredSize, glm::vec4 LineColor);
+
+	virtual glm::vec2 ComputeContentPreferredSize() const override;
+};
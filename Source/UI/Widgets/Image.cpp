@@ -1,10 +1,16 @@
 #include "Image.h"
 
+std::unique_ptr<Image> Image::Create(std::shared_ptr<Texture> Texture)
+{
+	BD_ASSERT(Texture);
+	return std::unique_ptr<Image>(new Image(std::move(Texture)));
+}
+
 std::unique_ptr<Image> Image::LoadFromFile(std::string_view Path)
 {
 	auto Texture = Texture::Load(Path);
 	BD_ASSERT(Texture); // FIXME: handle this case more nicely
-	return std::unique_ptr<Image>(new Image(std::move(Texture)));
+	return Create(std::move(Texture));
 }
 
 glm::vec2 Image::ComputeContentPreferredSize() const
@@ -40,7 +46,7 @@ void Image::Render(RenderBuffer& Buffer) const
 	Buffer.TextureRect(Rect, *m_Texture);
 }
 
-Image::Image(std::unique_ptr<Texture> Texture)
+Image::Image(std::shared_ptr<Texture> Texture)
 	: m_Texture(std::move(Texture))
 {
 }
@@ -6,14 +6,16 @@
 class Image : public Widget
 {
 public:
+	static std::unique_ptr<Image> Create(std::shared_ptr<Texture> Texture);
+
 	static std::unique_ptr<Image> LoadFromFile(std::string_view Path);
 
 	virtual void Render(RenderBuffer& Buffer) const override;
 
 private:
-	std::unique_ptr<Texture> m_Texture;
+	std::shared_ptr<Texture> m_Texture;
 
-	explicit Image(std::unique_ptr<Texture> Texture);
+	explicit Image(std::shared_ptr<Texture> Texture);
 
 	virtual glm::vec2 ComputeContentPreferredSize() const override;
 };
\ No newline at end of file
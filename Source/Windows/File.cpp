@@ -24,6 +24,11 @@ bool WindowsFile::Write(const uint8_t* Buffer, size_t Size)
 	return Size == BytesWritten;
 }
 
+bool WindowsFile::Flush()
+{
+	return FlushFileBuffers(m_File);
+}
+
 size_t WindowsFile::Size() const
 {
 	LARGE_INTEGER Result;
@@ -94,6 +99,68 @@ std::unique_ptr<File> FileSystem::Open(std::string_view Path, OpenMode OpenMode,
 	return nullptr;
 }
 
+WindowsMappedFile::WindowsMappedFile(HANDLE File, HANDLE Mapping, const uint8_t* Data, size_t Size)
+	: m_File(File)
+	, m_Mapping(Mapping)
+	, m_Data(Data)
+	, m_Size(Size)
+{
+}
+
+WindowsMappedFile::~WindowsMappedFile()
+{
+	if (m_Data)
+		UnmapViewOfFile(m_Data);
+	if (m_Mapping)
+		CloseHandle(m_Mapping);
+	CloseHandle(m_File);
+}
+
+std::span<const uint8_t> WindowsMappedFile::Data() const
+{
+	return { m_Data, m_Size };
+}
+
+std::unique_ptr<MappedFile> FileSystem::MapFile(std::string_view Path)
+{
+	auto Handle = CreateFileA(Path.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (Handle == INVALID_HANDLE_VALUE)
+		return nullptr;
+
+	LARGE_INTEGER Size;
+	if (!GetFileSizeEx(Handle, &Size))
+	{
+		CloseHandle(Handle);
+		return nullptr;
+	}
+
+	// NOTE: empty files cannot be mapped, but they are still valid files
+	if (Size.QuadPart == 0)
+		return std::make_unique<WindowsMappedFile>(Handle, nullptr, nullptr, 0);
+
+	auto Mapping = CreateFileMappingA(Handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!Mapping)
+	{
+		CloseHandle(Handle);
+		return nullptr;
+	}
+
+	auto* Data = static_cast<const uint8_t*>(MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!Data)
+	{
+		CloseHandle(Mapping);
+		CloseHandle(Handle);
+		return nullptr;
+	}
+
+	return std::make_unique<WindowsMappedFile>(Handle, Mapping, Data, static_cast<size_t>(Size.QuadPart));
+}
+
+bool FileSystem::Rename(std::string_view From, std::string_view To)
+{
+	return MoveFileExA(From.data(), To.data(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+}
+
 std::optional<std::vector<uint8_t>> FileSystem::ReadFileAsBytes(std::string_view Path)
 {
 	auto File = Open(Path, OpenMode::OpenExisting, AccessMode::Read);
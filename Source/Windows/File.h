@@ -15,6 +15,8 @@ public:
 
 	virtual bool Write(const uint8_t* Buffer, size_t Size) override;
 
+	virtual bool Flush() override;
+
 	virtual size_t Size() const override;
 
 	virtual void Seek(ptrdiff_t Offset) override;
@@ -25,4 +27,20 @@ public:
 
 private:
 	HANDLE m_File;
+};
+
+class WindowsMappedFile : public MappedFile
+{
+public:
+	WindowsMappedFile(HANDLE File, HANDLE Mapping, const uint8_t* Data, size_t Size);
+
+	virtual ~WindowsMappedFile() override;
+
+	virtual std::span<const uint8_t> Data() const override;
+
+private:
+	HANDLE m_File;
+	HANDLE m_Mapping;
+	const uint8_t* m_Data;
+	size_t m_Size;
 };
\ No newline at end of file
@@ -27,6 +27,14 @@ namespace Time
 		return Result.QuadPart;
 	}
 
+	uint64_t Frequency()
+	{
+		if (!WindowsTime::GInitialized)
+			WindowsTime::Init();
+
+		return WindowsTime::GFrequency.QuadPart;
+	}
+
 	float Duration(Point Start, Point End)
 	{
 		BD_ASSERT(WindowsTime::GInitialized);